@@ -0,0 +1,76 @@
+#include "BatchedSolver.h"
+#include "MatrixSolver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace numericals;
+
+namespace {
+
+template <typename F>
+double seconds(F&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+void run(const char* name, const size_t count, const size_t threads)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    std::printf("%s, %zu systems\n%6s %18s %18s %18s\n", name, count, "n", "per call sys/s", "batched sys/s", "batched MT sys/s");
+    for(const size_t n : {3, 4, 8, 16})
+    {
+        std::vector<matrix<T>> as;
+        std::vector<vector<T>> bs;
+        batched_matrix<T> a(n, count);
+        batched_vector<T> b(n, count);
+        for(size_t s = 0; s < count; s++)
+        {
+            matrix<T> m{n, n};
+            vector<T> v(n);
+            for(size_t y = 0; y < n; y++)
+            {
+                for(size_t x = 0; x < n; x++)
+                    m.GetElement(x, y) = dist(gen) + (x == y ? T(n) : T(0));
+                v[y] = dist(gen);
+            }
+            a.Set(s, m.View());
+            b.Set(s, v.View());
+            as.push_back(std::move(m));
+            bs.push_back(std::move(v));
+        }
+
+        const double perCall = seconds([&]
+        {
+            for(size_t s = 0; s < count; s++)
+            {
+                volatile T x = solve_matrix_eq_gauss(as[s], bs[s], PartialPivotingStragegy<T>())[0];
+                (void)x;
+            }
+        });
+
+        batched_matrix<T> a1 = a;
+        batched_vector<T> b1 = b;
+        const double batched = seconds([&]{ solve_matrix_eq_gauss_batched(a1, b1, 1); });
+        const double batchedThreads = seconds([&]{ solve_matrix_eq_gauss_batched(a, b, threads); });
+
+        std::printf("%6zu %18.3e %18.3e %18.3e\n", n, count / perCall, count / batched, count / batchedThreads);
+    }
+}
+
+}
+
+// usage: batched_bench [systems, default 200000] [threads, default all]
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : get_num_threads();
+    run<float>("float", count, threads);
+    run<double>("double", count, threads);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Compares two numericals_bench --json runs and flags regressions.
+
+usage: compare_bench.py baseline.json candidate.json [--threshold 0.10] [--residual-factor 10]
+
+A case (name, type, structure, n) regresses when its time per call grows by more than the
+threshold, when it starts allocating more per call, or when its residual grows by more than
+the residual factor. Exits with 1 if any case regressed.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        results = json.load(f)["results"]
+    return {(r["name"], r["type"], r["structure"], r["n"]): r for r in results}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--threshold", type=float, default=0.10, help="allowed relative time increase")
+    parser.add_argument("--residual-factor", type=float, default=10.0, help="allowed residual growth")
+    parser.add_argument("--all", action="store_true", help="print every case, not only regressions")
+    args = parser.parse_args()
+
+    baseline, candidate = load(args.baseline), load(args.candidate)
+    regressions = 0
+    for key in sorted(baseline.keys() & candidate.keys()):
+        old, new = baseline[key], candidate[key]
+        ratio = new["seconds"] / old["seconds"] if old["seconds"] > 0 else 1.0
+        problems = []
+        if ratio > 1.0 + args.threshold:
+            problems.append("time")
+        if new["allocations"] > old["allocations"]:
+            problems.append("allocations %d -> %d" % (old["allocations"], new["allocations"]))
+        # a negative residual marks a non-finite one
+        if new["residual"] < 0 <= old["residual"] or \
+                new["residual"] > max(old["residual"], 1e-300) * args.residual_factor and new["residual"] > 1e-12:
+            problems.append("residual %.2e -> %.2e" % (old["residual"], new["residual"]))
+        if problems or args.all:
+            name, type_, structure, n = key
+            print("%-46s %-6s %-15s %7d %11.3e -> %11.3e s %+7.1f%%  %s" % (
+                name, type_, structure, n, old["seconds"], new["seconds"], (ratio - 1.0) * 100.0,
+                "REGRESSION: " + ", ".join(problems) if problems else ""))
+        regressions += bool(problems)
+
+    for key in sorted(baseline.keys() - candidate.keys()):
+        print("missing from candidate: %s %s %s %d" % key)
+
+    print("%d of %d cases regressed" % (regressions, len(baseline.keys() & candidate.keys())))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,81 @@
+#include "matrix.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+// The triple loop matrix<T>::operator* used before the packed kernel, kept as the baseline.
+template <typename T>
+matrix<T> naive_product(const matrix<T>& a, const matrix<T>& b)
+{
+    matrix<T> result{b.GetSizeX(), a.GetSizeY()};
+    for(size_t y = 0; y < a.GetSizeY(); y++)
+        for(size_t x = 0; x < b.GetSizeX(); x++)
+        {
+            result.GetElement(x, y) = 0.0;
+            for(size_t i = 0; i < a.GetSizeX(); i++)
+                result.GetElement(x, y) += a.GetElement(i, y) * b.GetElement(x, i);
+        }
+    return result;
+}
+
+template <typename T>
+matrix<T> random_matrix(const size_t size, std::mt19937& gen)
+{
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    matrix<T> result{size, size};
+    for(auto& element : result)
+        element = dist(gen);
+    return result;
+}
+
+template <typename F>
+double seconds_per_call(F&& func)
+{
+    using clock = std::chrono::steady_clock;
+    size_t repetitions = 0;
+    const auto start = clock::now();
+    double elapsed = 0.0;
+    do
+    {
+        func();
+        repetitions++;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while(elapsed < 0.2);
+    return elapsed / repetitions;
+}
+
+template <typename T>
+void run(const char* name, const size_t naiveLimit)
+{
+    std::mt19937 gen(42);
+    std::printf("%s\n%8s %14s %14s\n", name, "n", "naive GFLOP/s", "gemm GFLOP/s");
+    for(size_t n = 64; n <= 4096; n *= 2)
+    {
+        const matrix<T> a = random_matrix<T>(n, gen);
+        const matrix<T> b = random_matrix<T>(n, gen);
+        const double flops = 2.0 * n * n * n;
+
+        const double blocked = flops / seconds_per_call([&]{ volatile auto c = (a * b).GetElement(0); (void)c; }) * 1e-9;
+        if(n <= naiveLimit)
+        {
+            const double naive = flops / seconds_per_call([&]{ volatile auto c = naive_product(a, b).GetElement(0); (void)c; }) * 1e-9;
+            std::printf("%8zu %14.2f %14.2f\n", n, naive, blocked);
+        }
+        else
+            std::printf("%8zu %14s %14.2f\n", n, "-", blocked);
+    }
+}
+
+}
+
+// usage: gemm_bench [largest size measured with the naive loop, default 1024]
+int main(int argc, char** argv)
+{
+    const size_t naiveLimit = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    run<float>("float", naiveLimit);
+    run<double>("double", naiveLimit);
+    return 0;
+}
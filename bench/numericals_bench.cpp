@@ -0,0 +1,1056 @@
+#include "BandedSolver.h"
+#include "BatchedSolver.h"
+#include "FixedSizeSolver.h"
+#include "IterativeSolver.h"
+#include "MatrixDecomposer.h"
+#include "MatrixSolver.h"
+#include "PackedSolver.h"
+#include "PolynomialSolver.h"
+#include "SparseSolver.h"
+#include "memory_arena.h"
+#include "storage.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace numericals;
+
+namespace {
+
+struct options
+{
+    std::vector<size_t> sizes{32, 128, 512};
+    double min_time = 0.1;
+    std::string filter;
+    std::string output;
+};
+
+struct record
+{
+    std::string name;
+    std::string type;
+    std::string structure;
+    size_t n;
+    double seconds;
+    double gflops;
+    // bytes of matrix/vector temporaries per call, alignment gaps included (measured through an
+    // arena_scope), per input element
+    double bytes_per_element;
+    // heap allocations of matrix/vector storage per call
+    size_t allocations;
+    double residual;
+};
+
+// one specialisation per benchmarked type, so that a new one cannot go out mislabelled
+template <typename T>
+const char* type_name() = delete;
+template <>
+const char* type_name<float>() { return "float"; }
+template <>
+const char* type_name<double>() { return "double"; }
+
+enum class conditioning { well, graded };
+
+const char* to_string(const conditioning c) { return c == conditioning::well ? "well" : "graded"; }
+
+// Runs every case that matches the filter: its residual once, then one call inside an arena
+// scope for the temporaries, one counting heap allocations, and timed calls until min_time.
+class suite
+{
+public:
+    explicit suite(const options& opts) : opts(opts) {}
+
+    // call performs one complete operation on fresh copies of its inputs and keeps nothing;
+    // flops and elements (the size of the input) describe one call
+    template <typename T, typename R, typename F>
+    void Add(const std::string& name, const std::string& structure, const size_t n, const double flops, const double elements,
+             R&& residual, F&& call)
+    {
+        if(!opts.filter.empty() && name.find(opts.filter) == std::string::npos) return;
+
+        record r{name, type_name<T>(), structure, n, 0.0, 0.0, 0.0, 0, residual()};
+
+        memory_arena arena;
+        {
+            arena_scope scope(arena);
+            call();
+        }
+        r.bytes_per_element = double(arena.GetStatistics().peak_bytes) / std::max(elements, 1.0);
+
+        const size_t allocations = heap_allocation_count;
+        call();
+        r.allocations = heap_allocation_count - allocations;
+
+        using clock = std::chrono::steady_clock;
+        size_t repetitions = 0;
+        const auto start = clock::now();
+        double elapsed = 0.0;
+        do
+        {
+            call();
+            repetitions++;
+            elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        } while(elapsed < opts.min_time || repetitions < 3);
+        r.seconds = elapsed / double(repetitions);
+        r.gflops = flops / r.seconds * 1e-9;
+
+        std::printf("%-46s %-6s %-15s %7zu %11.3e s %9.3f GFLOP/s %9.2f B/el %5zu allocs %10.2e\n", r.name.c_str(), r.type.c_str(),
+                    r.structure.c_str(), r.n, r.seconds, r.gflops, r.bytes_per_element, r.allocations, r.residual);
+        std::fflush(stdout);
+        records.push_back(std::move(r));
+    }
+
+    void WriteJson(std::FILE* file) const
+    {
+        std::fprintf(file, "{\n  \"benchmark\": \"numericals_bench\",\n  \"min_time\": %g,\n  \"results\": [\n", opts.min_time);
+        for(size_t i = 0; i < records.size(); i++)
+        {
+            const record& r = records[i];
+            std::fprintf(file, "    {\"name\": \"%s\", \"type\": \"%s\", \"structure\": \"%s\", \"n\": %zu, \"seconds\": %.6e, "
+                               "\"gflops\": %.6e, \"bytes_per_element\": %.6e, \"allocations\": %zu, \"residual\": %.6e}%s\n",
+                         r.name.c_str(), r.type.c_str(), r.structure.c_str(), r.n, r.seconds, r.gflops, r.bytes_per_element,
+                         r.allocations, std::isfinite(r.residual) ? r.residual : -1.0, i + 1 < records.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+    }
+
+private:
+    const options& opts;
+    std::vector<record> records;
+};
+
+// Keeps results alive past the optimizer
+template <typename T>
+void consume(const T& value)
+{
+    volatile T sink = value;
+    (void)sink;
+}
+
+template <typename T>
+matrix<T> random_matrix(const size_t cols, const size_t rows, std::mt19937& gen)
+{
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    matrix<T> result{cols, rows};
+    for(auto& element : result)
+        element = dist(gen);
+    return result;
+}
+
+template <typename T>
+vector<T> random_vector(const size_t size, std::mt19937& gen)
+{
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    vector<T> result(size);
+    for(size_t i = 0; i < size; i++)
+        result[i] = dist(gen);
+    return result;
+}
+
+// 10^(-4 i / (n - 1)): graded scales spanning four orders of magnitude
+template <typename T>
+T grade(const size_t i, const size_t n) { return T(std::pow(10.0, -4.0 * double(i) / double(std::max<size_t>(n, 2) - 1))); }
+
+// Diagonally dominant; graded scales its rows, which needs pivoting-aware solvers to keep accuracy
+template <typename T>
+matrix<T> general_matrix(const size_t n, const conditioning c, std::mt19937& gen)
+{
+    matrix<T> a = random_matrix<T>(n, n, gen);
+    for(size_t y = 0; y < n; y++)
+    {
+        a.GetElement(y, y) += T(n);
+        if(c == conditioning::graded)
+            a.Row(y) *= grade<T>(y, n);
+    }
+    return a;
+}
+
+// B B^T / n + I, graded as D (B B^T / n + I) D
+template <typename T>
+matrix<T> spd_matrix(const size_t n, const conditioning c, std::mt19937& gen)
+{
+    const matrix<T> b = random_matrix<T>(n, n, gen);
+    matrix<T> a = b * b.Transposed();
+    for(size_t y = 0; y < n; y++)
+        for(size_t x = 0; x < n; x++)
+        {
+            a.GetElement(x, y) = a.GetElement(x, y) / T(n) + (x == y ? T(1) : T(0));
+            if(c == conditioning::graded)
+                a.GetElement(x, y) *= grade<T>(x, n) * grade<T>(y, n);
+        }
+    return a;
+}
+
+template <typename T>
+matrix<T> upper_triangle(const matrix<T>& a)
+{
+    matrix<T> u{a.GetSizeX(), a.GetSizeY()};
+    for(size_t y = 0; y < a.GetSizeY(); y++)
+        for(size_t x = y; x < a.GetSizeX(); x++)
+            u.GetElement(x, y) = a.GetElement(x, y);
+    return u;
+}
+
+template <typename T>
+matrix<T> lower_triangle(const matrix<T>& a, const bool unitDiagonal)
+{
+    matrix<T> l{a.GetSizeX(), a.GetSizeY()};
+    for(size_t y = 0; y < a.GetSizeY(); y++)
+        for(size_t x = 0; x <= std::min(y, a.GetSizeX() - 1); x++)
+            l.GetElement(x, y) = x == y && unitDiagonal ? T(1) : a.GetElement(x, y);
+    return l;
+}
+
+template <typename T>
+double max_norm(const matrix<T>& a)
+{
+    double norm = 0.0;
+    for(const T element : a)
+        norm = std::max(norm, double(std::abs(element)));
+    return norm;
+}
+
+template <typename T>
+double max_norm(const vector<T>& v)
+{
+    double norm = 0.0;
+    for(size_t i = 0; i < v.GetSize(); i++)
+        norm = std::max(norm, double(std::abs(v[i])));
+    return norm;
+}
+
+template <typename T>
+double row_sum_norm(const matrix<T>& a)
+{
+    double norm = 0.0;
+    for(size_t y = 0; y < a.GetSizeY(); y++)
+    {
+        double sum = 0.0;
+        for(size_t x = 0; x < a.GetSizeX(); x++)
+            sum += std::abs(double(a.GetElement(x, y)));
+        norm = std::max(norm, sum);
+    }
+    return norm;
+}
+
+// ||a - b|| / ||a||, elementwise maximum
+template <typename T>
+double relative_difference(const matrix<T>& a, const matrix<T>& b)
+{
+    double difference = 0.0;
+    for(size_t y = 0; y < a.GetSizeY(); y++)
+        for(size_t x = 0; x < a.GetSizeX(); x++)
+            difference = std::max(difference, std::abs(double(a.GetElement(x, y)) - double(b.GetElement(x, y))));
+    return difference / max_norm(a);
+}
+
+// Normwise backward error ||A x - b|| / (||A|| ||x|| + ||b||), in double
+template <typename T>
+double backward_error(const matrix<T>& a, const vector<T>& x, const vector<T>& b)
+{
+    double residual = 0.0;
+    for(size_t y = 0; y < a.GetSizeY(); y++)
+    {
+        double sum = -double(b[y]);
+        for(size_t c = 0; c < a.GetSizeX(); c++)
+            sum += double(a.GetElement(c, y)) * double(x[c]);
+        residual = std::max(residual, std::abs(sum));
+    }
+    return residual / (row_sum_norm(a) * max_norm(x) + max_norm(b));
+}
+
+template <typename T>
+double backward_error(const matrix<T>& a, const matrix<T>& x, const matrix<T>& b)
+{
+    double error = 0.0;
+    for(size_t c = 0; c < b.GetSizeX(); c++)
+        error = std::max(error, backward_error(a, vector<T>(x.GetColumn(c)), vector<T>(b.GetColumn(c))));
+    return error;
+}
+
+// ||A^T (A x - b)|| / (||A||^2 ||x|| + ||A|| ||b||): zero at the least-squares solution
+template <typename T>
+double least_squares_error(const matrix<T>& a, const vector<T>& x, const vector<T>& b)
+{
+    const auto [ata, atb] = get_normal_equations(a, b);
+    const double norm = row_sum_norm(a);
+    return backward_error(ata, x, atb) * (row_sum_norm(ata) * max_norm(x) + max_norm(atb)) / (norm * norm * max_norm(x) + norm * max_norm(b));
+}
+
+template <typename T>
+void run_dense(suite& s, const size_t n, const conditioning c)
+{
+    std::mt19937 gen(42);
+    const matrix<T> a = general_matrix<T>(n, c, gen);
+    const vector<T> b = a * random_vector<T>(n, gen);
+    const matrix<T> rhs = a * random_matrix<T>(8, n, gen);
+    const matrix<T> other = random_matrix<T>(n, n, gen);
+    const std::string structure = std::string("dense-") + to_string(c);
+    const double nd = double(n), elements = nd * nd;
+    const double gauss = 2.0 / 3.0 * nd * nd * nd + 2.0 * nd * nd;
+    const double jordan = nd * nd * nd + 2.0 * nd * nd;
+
+    const auto solver = [&](const std::string& name, const double flops, auto&& solve)
+    {
+        s.Add<T>(name, structure, n, flops, elements, [&] { return backward_error(a, solve(), b); }, [&] { consume(solve()[0]); });
+    };
+    solver("solve_matrix_eq_gauss/none", gauss, [&] { return solve_matrix_eq_gauss(a, b); });
+    solver("solve_matrix_eq_gauss/partial", gauss, [&] { return solve_matrix_eq_gauss(a, b, PartialPivotingStragegy<T>()); });
+    solver("solve_matrix_eq_gauss/full", gauss, [&] { return solve_matrix_eq_gauss(a, b, FullPivotingStragegy<T>()); });
+    solver("solve_matrix_eq_gauss/policy_none", gauss, [&] { return solve_matrix_eq_gauss(a, b, NoPivotingPolicy()); });
+    solver("solve_matrix_eq_gauss/policy_partial", gauss, [&] { return solve_matrix_eq_gauss(a, b, PartialPivotingPolicy()); });
+    solver("solve_matrix_eq_gauss/policy_full", gauss, [&] { return solve_matrix_eq_gauss(a, b, FullPivotingPolicy()); });
+    solver("solve_matrix_eq_jordan/none", jordan, [&] { return solve_matrix_eq_jordan(a, b); });
+    solver("solve_matrix_eq_jordan/partial", jordan, [&] { return solve_matrix_eq_jordan(a, b, PartialPivotingStragegy<T>()); });
+    solver("solve_matrix_eq_jordan/full", jordan, [&] { return solve_matrix_eq_jordan(a, b, FullPivotingStragegy<T>()); });
+    solver("solve_matrix_eq_jordan/policy_partial", jordan, [&] { return solve_matrix_eq_jordan(a, b, PartialPivotingPolicy()); });
+    solver("solve_matrix_eq_jordan/policy_full", jordan, [&] { return solve_matrix_eq_jordan(a, b, FullPivotingPolicy()); });
+    solver("solve_matrix_eq_with_lu_decomposition", gauss, [&] { return solve_matrix_eq_with_lu_decomposition(a, b); });
+    solver("solve_matrix_eq_with_qr_decomposition", 4.0 / 3.0 * nd * nd * nd, [&] { return solve_matrix_eq_with_qr_decomposition(a, b); });
+
+    // the in-place forms reuse one copy of the inputs and one workspace, as a caller would
+    {
+        matrix<T> work{n, n};
+        vector<T> x(n);
+        SolverWorkspace<T> workspace(n);
+        const auto reset = [&]
+        {
+            std::copy(a.begin(), a.end(), work.begin());
+            x.View() = b.View();
+        };
+        const auto in_place = [&](const std::string& name, const double flops, auto&& solve)
+        {
+            s.Add<T>(name, structure, n, flops, elements, [&] { reset(); solve(); return backward_error(a, x, b); },
+                     [&] { reset(); solve(); consume(x[0]); });
+        };
+        in_place("solve_matrix_eq_gauss_in_place/partial", gauss, [&] { solve_matrix_eq_gauss_in_place(work, x, PartialPivotingStragegy<T>()); });
+        in_place("solve_matrix_eq_gauss_in_place/policy_partial", gauss,
+                 [&] { solve_matrix_eq_gauss_in_place(work, x, PartialPivotingPolicy(), workspace); });
+        in_place("solve_matrix_eq_jordan_in_place/partial", jordan, [&] { solve_matrix_eq_jordan_in_place(work, x, PartialPivotingStragegy<T>()); });
+        in_place("solve_matrix_eq_jordan_in_place/policy_full", jordan,
+                 [&] { solve_matrix_eq_jordan_in_place(work, x, FullPivotingPolicy(), workspace); });
+    }
+
+    s.Add<T>("solve_matrix_eq_jordan/matrix", structure, n, nd * nd * nd + 2.0 * nd * nd * 8.0, elements,
+             [&] { return backward_error(a, solve_matrix_eq_jordan(a, rhs), rhs); },
+             [&] { consume(solve_matrix_eq_jordan(a, rhs).GetElement(0)); });
+    s.Add<T>("get_inverse_matrix", structure, n, 2.0 * nd * nd * nd, elements,
+             [&] { return relative_difference(a * get_inverse_matrix(a) * a, a); },
+             [&] { consume(get_inverse_matrix(a).GetElement(0)); });
+
+    const LUFactorization<T> lu(a);
+    s.Add<T>("LUFactorization::Solve", structure, n, 2.0 * nd * nd, elements,
+             [&] { return backward_error(a, lu.Solve(b), b); }, [&] { consume(lu.Solve(b)[0]); });
+    const QRFactorization<T> qrFactorization(a);
+    s.Add<T>("QRFactorization::Solve", structure, n, 3.0 * nd * nd, elements,
+             [&] { return backward_error(a, qrFactorization.Solve(b), b); }, [&] { consume(qrFactorization.Solve(b)[0]); });
+
+    s.Add<T>("lu_decomposition", structure, n, 2.0 / 3.0 * nd * nd * nd, elements,
+             [&]
+             {
+                 const matrix<T> factors = lu_decomposition(a);
+                 return relative_difference(a, lower_triangle(factors, true) * upper_triangle(factors));
+             },
+             [&] { consume(lu_decomposition(a).GetElement(0)); });
+    s.Add<T>("lu_decomposition_with_pivoting", structure, n, 2.0 / 3.0 * nd * nd * nd, elements,
+             [&]
+             {
+                 const auto [factors, permutation] = lu_decomposition_with_pivoting(a);
+                 matrix<T> permuted{n, n};
+                 for(size_t y = 0; y < n; y++)
+                     permuted.Row(y) = a.Row(permutation[y]);
+                 return relative_difference(permuted, lower_triangle(factors, true) * upper_triangle(factors));
+             },
+             [&] { consume(lu_decomposition_with_pivoting(a).first.GetElement(0)); });
+    s.Add<T>("qr_decomposition/economy", structure, n, 8.0 / 3.0 * nd * nd * nd, elements,
+             [&]
+             {
+                 const auto [q, r] = qr_decomposition(a);
+                 return relative_difference(a, q * r);
+             },
+             [&] { consume(qr_decomposition(a).first.GetElement(0)); });
+    s.Add<T>("qr_decomposition/full", structure, n, 8.0 / 3.0 * nd * nd * nd, elements,
+             [&]
+             {
+                 const auto [q, r] = qr_decomposition(a, qr_mode::full);
+                 return relative_difference(a, q * r);
+             },
+             [&] { consume(qr_decomposition(a, qr_mode::full).first.GetElement(0)); });
+    s.Add<T>("qr_decomposition_in_place", structure, n, 4.0 / 3.0 * nd * nd * nd, elements,
+             [&]
+             {
+                 matrix<T> qr = a;
+                 const scratch_vector<T> tau = qr_decomposition_in_place(qr.View());
+                 matrix<T> product = upper_triangle(qr);
+                 apply_householder_q<T>(qr.View(), tau, product.View(), false);
+                 return relative_difference(a, product);
+             },
+             [&]
+             {
+                 matrix<T> qr = a;
+                 consume(qr_decomposition_in_place(qr.View())[0]);
+             });
+    {
+        matrix<T> qr = a;
+        const scratch_vector<T> tau = qr_decomposition_in_place(qr.View());
+        s.Add<T>("apply_householder_q", structure, n, 4.0 * nd * nd * 8.0, elements,
+                 [&]
+                 {
+                     matrix<T> x = rhs;
+                     apply_householder_q<T>(qr.View(), tau, x.View(), true);
+                     apply_householder_q<T>(qr.View(), tau, x.View(), false);
+                     return relative_difference(rhs, x);
+                 },
+                 [&]
+                 {
+                     matrix<T> x = rhs;
+                     apply_householder_q<T>(qr.View(), tau, x.View(), true);
+                     consume(x.GetElement(0));
+                 });
+    }
+
+    const matrix<T> upper = upper_triangle(a), lower = lower_triangle(a, false);
+    s.Add<T>("solve_high_trian_matrix_eq", structure, n, nd * nd, elements,
+             [&] { return backward_error(upper, solve_high_trian_matrix_eq(upper, b), b); },
+             [&] { consume(solve_high_trian_matrix_eq(upper, b)[0]); });
+    s.Add<T>("solve_low_trian_matrix_eq", structure, n, nd * nd, elements,
+             [&] { return backward_error(lower, solve_low_trian_matrix_eq(lower, b), b); },
+             [&] { consume(solve_low_trian_matrix_eq(lower, b)[0]); });
+    s.Add<T>("solve_high_trian_matrix_eq/matrix", structure, n, nd * nd * 8.0, elements,
+             [&] { return backward_error(upper, solve_high_trian_matrix_eq(upper, rhs), rhs); },
+             [&] { consume(solve_high_trian_matrix_eq(upper, rhs).GetElement(0)); });
+    s.Add<T>("solve_low_trian_matrix_eq/matrix_transposed", structure, n, nd * nd * 8.0, elements,
+             [&] { return backward_error(lower.Transposed(), solve_low_trian_matrix_eq(lower, rhs, false, true), rhs); },
+             [&] { consume(solve_low_trian_matrix_eq(lower, rhs, false, true).GetElement(0)); });
+
+    s.Add<T>("matrix*matrix", structure, n, 2.0 * nd * nd * nd, 2.0 * elements,
+             [&] { return 0.0; }, [&] { consume((a * other).GetElement(0)); });
+    s.Add<T>("matrix*vector", structure, n, 2.0 * nd * nd, elements,
+             [&] { return 0.0; }, [&] { consume((a * b)[0]); });
+}
+
+template <typename T>
+void run_symmetric(suite& s, const size_t n, const conditioning c)
+{
+    std::mt19937 gen(7);
+    const matrix<T> a = spd_matrix<T>(n, c, gen);
+    const vector<T> b = a * random_vector<T>(n, gen);
+    const std::string structure = std::string("spd-") + to_string(c);
+    const double nd = double(n), elements = nd * nd;
+    const double cholesky = nd * nd * nd / 3.0;
+
+    s.Add<T>("llt_decomposition", structure, n, cholesky, elements,
+             [&]
+             {
+                 const matrix<T> l = lower_triangle(llt_decomposition(a), false);
+                 return relative_difference(a, l * l.Transposed());
+             },
+             [&] { consume(llt_decomposition(a).GetElement(0)); });
+    s.Add<T>("llt_decomposition_in_place", structure, n, cholesky, elements,
+             [&]
+             {
+                 matrix<T> factors = a;
+                 llt_decomposition_in_place(factors.View());
+                 const matrix<T> l = lower_triangle(factors, false);
+                 return relative_difference(a, l * l.Transposed());
+             },
+             [&]
+             {
+                 matrix<T> factors = a;
+                 llt_decomposition_in_place(factors.View());
+                 consume(factors.GetElement(0));
+             });
+    s.Add<T>("ldlt_decomposition", structure, n, cholesky, elements,
+             [&]
+             {
+                 const matrix<T> factors = ldlt_decomposition(a);
+                 matrix<T> ld = lower_triangle(factors, true);
+                 for(size_t x = 0; x < n; x++)
+                     ld.Column(x) *= factors.GetElement(x, x);
+                 return relative_difference(a, ld * lower_triangle(factors, true).Transposed());
+             },
+             [&] { consume(ldlt_decomposition(a).GetElement(0)); });
+
+    const auto solver = [&](const std::string& name, const double flops, auto&& solve)
+    {
+        s.Add<T>(name, structure, n, flops, elements, [&] { return backward_error(a, solve(), b); }, [&] { consume(solve()[0]); });
+    };
+    solver("solve_matrix_eq_with_llt_decomposition", cholesky + 2.0 * nd * nd, [&] { return solve_matrix_eq_with_llt_decomposition(a, b); });
+    solver("solve_matrix_eq_with_ldlt_decomposition", cholesky + 2.0 * nd * nd, [&] { return solve_matrix_eq_with_ldlt_decomposition(a, b); });
+
+    solver("solve_matrix_eq_with_llt_packed/packed", cholesky + 2.0 * nd * nd, [&]
+    {
+        packed_matrix<T> packed(a.View());
+        llt_decomposition_in_place(packed);
+        return solve_matrix_eq_with_llt_packed(packed, b);
+    });
+    solver("solve_matrix_eq_with_ldlt_packed/packed", cholesky + 2.0 * nd * nd, [&]
+    {
+        packed_matrix<T> packed(a.View());
+        ldlt_decomposition_in_place(packed);
+        return solve_matrix_eq_with_ldlt_packed(packed, b);
+    });
+    solver("solve_matrix_eq_with_llt_packed/rfp", cholesky + 2.0 * nd * nd, [&]
+    {
+        rfp_matrix<T> rfp(a.View());
+        llt_decomposition_in_place(rfp);
+        return solve_matrix_eq_with_llt_packed(rfp, b);
+    });
+}
+
+template <typename T>
+void run_least_squares(suite& s, const size_t n)
+{
+    std::mt19937 gen(11);
+    const size_t rows = 2 * n;
+    const matrix<T> a = random_matrix<T>(n, rows, gen);
+    const vector<T> b = random_vector<T>(rows, gen);
+    const double nd = double(n), md = double(rows), elements = nd * md;
+
+    s.Add<T>("get_normal_equations", "tall", n, md * nd * nd + 2.0 * md * nd, elements,
+             [&] { return 0.0; }, [&] { consume(get_normal_equations(a, b).second[0]); });
+    s.Add<T>("solve_overdetermined_matrix/qr", "tall", n, 2.0 * md * nd * nd, elements,
+             [&] { return least_squares_error(a, solve_overdetermined_matrix(a, b), b); },
+             [&] { consume(solve_overdetermined_matrix(a, b)[0]); });
+    s.Add<T>("solve_overdetermined_matrix/normal_jordan", "tall", n, md * nd * nd + nd * nd * nd, elements,
+             [&] { return least_squares_error(a, solve_overdetermined_matrix<T>(a, b, solve_matrix_eq_jordan<T>, PartialPivotingStragegy<T>()), b); },
+             [&] { consume(solve_overdetermined_matrix<T>(a, b, solve_matrix_eq_jordan<T>, PartialPivotingStragegy<T>())[0]); });
+}
+
+// five-point stencil on a side x side grid, convection making it unsymmetric
+template <typename T>
+csr_matrix<T> grid_matrix(const size_t side, const T convection)
+{
+    std::vector<triplet<T>> entries;
+    for(size_t y = 0; y < side; y++)
+        for(size_t x = 0; x < side; x++)
+        {
+            const size_t i = y * side + x;
+            entries.push_back({i, i, T(4)});
+            if(x > 0) entries.push_back({i - 1, i, T(-1) - convection});
+            if(x + 1 < side) entries.push_back({i + 1, i, T(-1) + convection});
+            if(y > 0) entries.push_back({i - side, i, T(-1)});
+            if(y + 1 < side) entries.push_back({i + side, i, T(-1)});
+        }
+    return csr_matrix<T>(side * side, side * side, std::span<const triplet<T>>(entries));
+}
+
+template <typename T>
+double sparse_backward_error(const csr_matrix<T>& a, const vector<T>& x, const vector<T>& b)
+{
+    vector<T> ax(b.GetSize());
+    multiply(a, x.View(), ax.View());
+    double residual = 0.0, norm = 0.0;
+    for(size_t i = 0; i < b.GetSize(); i++)
+        residual = std::max(residual, std::abs(double(ax[i]) - double(b[i])));
+    for(size_t r = 0; r < a.GetSizeY(); r++)
+    {
+        double sum = 0.0;
+        for(size_t p = a.GetOffsets()[r]; p < a.GetOffsets()[r + 1]; p++)
+            sum += std::abs(double(a.GetValues()[p]));
+        norm = std::max(norm, sum);
+    }
+    return residual / (norm * max_norm(x) + max_norm(b));
+}
+
+// Normwise backward error of a band system, from the band alone so that large sizes stay cheap
+template <typename T>
+double band_backward_error(const band_matrix<T>& a, const vector<T>& x, const vector<T>& b)
+{
+    double residual = 0.0, norm = 0.0;
+    for(size_t y = 0; y < a.GetSize(); y++)
+    {
+        double sum = -double(b[y]), rowSum = 0.0;
+        for(size_t c = a.GetFirstColumn(y); c < a.GetLastColumn(y); c++)
+        {
+            sum += double(a.GetElement(c, y)) * double(x[c]);
+            rowSum += std::abs(double(a.GetElement(c, y)));
+        }
+        residual = std::max(residual, std::abs(sum));
+        norm = std::max(norm, rowSum);
+    }
+    return residual / (norm * max_norm(x) + max_norm(b));
+}
+
+// The band solvers on size 64 n, from tridiagonal-like to wide bands. The diagonal grows with
+// the bandwidth, enough to keep the systems well conditioned but short of diagonal dominance.
+template <typename T>
+void run_banded(suite& s, const size_t n)
+{
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+
+    const size_t size = 64 * n;
+    const double sd = double(size);
+    for(const auto& [kl, ku] : {std::pair<size_t, size_t>{1, 1}, {2, 2}, {8, 8}, {32, 32}, {2, 16}})
+    {
+        band_matrix<T> band(size, kl, ku);
+        for(size_t y = 0; y < size; y++)
+            for(size_t x = band.GetFirstColumn(y); x < band.GetLastColumn(y); x++)
+                band.GetElement(x, y) = x == y ? T(double(kl + ku) / 4.0 + 1.0) + dist(gen) : dist(gen);
+        const vector<T> b = random_vector<T>(size, gen);
+        const std::string structure = "band" + std::to_string(kl) + "+" + std::to_string(ku);
+        const double elements = sd * double(kl + ku + 1);
+
+        for(const band_pivoting pivoting : {band_pivoting::none, band_pivoting::partial})
+        {
+            const bool pivots = pivoting == band_pivoting::partial;
+            const std::string suffix = pivots ? "/partial" : "/none";
+            // elimination touches kl rows of kl + ku (kl + 2 ku with row exchanges) columns per
+            // step, the two substitutions every stored factor once
+            const double factorFlops = sd * 2.0 * double(kl) * double(kl + ku + (pivots ? ku : 0));
+            const double solveFlops = sd * (2.0 * double(kl + ku + (pivots ? ku : 0)) + 1.0);
+            s.Add<T>("solve_banded_matrix_eq" + suffix, structure, size, factorFlops + solveFlops, elements,
+                     [&] { return band_backward_error(band, solve_banded_matrix_eq(band, b, pivoting), b); },
+                     [&] { consume(solve_banded_matrix_eq(band, b, pivoting)[0]); });
+            s.Add<T>("BandedLUFactorization" + suffix, structure, size, factorFlops, elements,
+                     [&] { return band_backward_error(band, BandedLUFactorization<T>(band, pivoting).Solve(b), b); },
+                     [&] { consume(BandedLUFactorization<T>(band, pivoting).GetFactors().GetElement(0, 0)); });
+            const BandedLUFactorization<T> lu(band, pivoting);
+            s.Add<T>("BandedLUFactorization::Solve" + suffix, structure, size, solveFlops, elements,
+                     [&] { return band_backward_error(band, lu.Solve(b), b); }, [&] { consume(lu.Solve(b)[0]); });
+        }
+    }
+}
+
+// The O(n) and sparse solvers, on problems scaled up from the dense size n
+template <typename T>
+void run_structured(suite& s, const size_t n)
+{
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+
+    const size_t size = 256 * n;
+    const double sd = double(size);
+    vector<T> lower(size - 1), diagonal(size), upper(size - 1);
+    for(size_t i = 0; i < size; i++)
+    {
+        diagonal[i] = T(4) + dist(gen);
+        if(i + 1 < size)
+        {
+            lower[i] = dist(gen);
+            upper[i] = dist(gen);
+        }
+    }
+    const vector<T> b = random_vector<T>(size, gen);
+    const auto tridiagonal_error = [&](const vector<T>& x)
+    {
+        double residual = 0.0;
+        for(size_t i = 0; i < size; i++)
+        {
+            double sum = double(diagonal[i]) * double(x[i]) - double(b[i]);
+            if(i > 0) sum += double(lower[i - 1]) * double(x[i - 1]);
+            if(i + 1 < size) sum += double(upper[i]) * double(x[i + 1]);
+            residual = std::max(residual, std::abs(sum));
+        }
+        return residual / (7.0 * max_norm(x) + max_norm(b));
+    };
+    s.Add<T>("solve_tridiagonal_matrix_eq", "tridiagonal", size, 8.0 * sd, 3.0 * sd,
+             [&] { return tridiagonal_error(solve_tridiagonal_matrix_eq<T>({lower, diagonal, upper}, b)); },
+             [&] { consume(solve_tridiagonal_matrix_eq<T>({lower, diagonal, upper}, b)[0]); });
+    {
+        vector<T> l(size - 1), d(size), x(size);
+        const auto solve = [&]
+        {
+            l.View() = lower.View();
+            d.View() = diagonal.View();
+            x.View() = b.View();
+            solve_tridiagonal_matrix_eq_in_place<T>(l.View(), d.View(), upper.View(), x.View());
+        };
+        s.Add<T>("solve_tridiagonal_matrix_eq_in_place", "tridiagonal", size, 8.0 * sd, 3.0 * sd,
+                 [&] { solve(); return tridiagonal_error(x); }, [&] { solve(); consume(x[0]); });
+        const auto parallel = [&]
+        {
+            x.View() = b.View();
+            solve_tridiagonal_matrix_eq_parallel<T>(lower.View(), diagonal.View(), upper.View(), x.View());
+        };
+        s.Add<T>("solve_tridiagonal_matrix_eq_parallel", "tridiagonal", size, 17.0 * sd, 3.0 * sd,
+                 [&] { parallel(); return tridiagonal_error(x); }, [&] { parallel(); consume(x[0]); });
+    }
+
+    const size_t side = n / 2 + 8;
+    const csr_matrix<T> laplacian = grid_matrix<T>(side, T(0));
+    const csr_matrix<T> convection = grid_matrix<T>(side, T(0.4));
+    const csc_matrix<T> laplacianColumns(laplacian), convectionColumns(convection);
+    const size_t unknowns = side * side;
+    const double nnz = double(laplacian.GetNonZeroCount());
+    const vector<T> gridB = random_vector<T>(unknowns, gen);
+
+    s.Add<T>("multiply/csr", "grid", unknowns, 2.0 * nnz, nnz,
+             [&] { return 0.0; },
+             [&]
+             {
+                 vector<T> y(unknowns);
+                 multiply(laplacian, gridB.View(), y.View());
+                 consume(y[0]);
+             });
+    s.Add<T>("multiply/csc", "grid", unknowns, 2.0 * nnz, nnz,
+             [&] { return 0.0; }, [&] { consume((laplacianColumns * gridB)[0]); });
+    s.Add<T>("approximate_minimum_degree_ordering", "grid", unknowns, 0.0, nnz,
+             [&] { return 0.0; }, [&] { consume(approximate_minimum_degree_ordering(laplacianColumns)[0]); });
+    {
+        const SparseLLTFactorization<T> llt(laplacianColumns);
+        const SparseLUFactorization<T> lu(convectionColumns);
+        const double lltFlops = double(llt.GetNonZeroCount()) * 4.0, luFlops = double(lu.GetNonZeroCount()) * 4.0;
+        s.Add<T>("solve_matrix_eq_with_llt_decomposition/sparse", "grid", unknowns, lltFlops, nnz,
+                 [&] { return sparse_backward_error(laplacian, solve_matrix_eq_with_llt_decomposition(laplacian, gridB), gridB); },
+                 [&] { consume(solve_matrix_eq_with_llt_decomposition(laplacian, gridB)[0]); });
+        s.Add<T>("solve_matrix_eq_with_lu_decomposition/sparse", "grid-convection", unknowns, luFlops, nnz,
+                 [&] { return sparse_backward_error(convection, solve_matrix_eq_with_lu_decomposition(convection, gridB), gridB); },
+                 [&] { consume(solve_matrix_eq_with_lu_decomposition(convection, gridB)[0]); });
+        s.Add<T>("SparseLLTFactorization::Solve", "grid", unknowns, lltFlops, nnz,
+                 [&] { return sparse_backward_error(laplacian, llt.Solve(gridB), gridB); }, [&] { consume(llt.Solve(gridB)[0]); });
+        s.Add<T>("SparseLUFactorization::Solve", "grid-convection", unknowns, luFlops, nnz,
+                 [&] { return sparse_backward_error(convection, lu.Solve(gridB), gridB); }, [&] { consume(lu.Solve(gridB)[0]); });
+    }
+
+    iterative_controls<T> controls;
+    controls.tolerance = sizeof(T) == sizeof(float) ? T(1e-5) : T(1e-10);
+    controls.max_iterations = 2000;
+    const auto krylov = [&](const std::string& name, const csr_matrix<T>& a, auto&& solve, const Preconditioner<T>& preconditioner)
+    {
+        // flops are counted per iteration of the last run: a matrix product and about ten vector operations
+        iterative_report<T> report;
+        const auto run = [&]
+        {
+            vector<T> x(unknowns);
+            report = solve(as_operator(a), gridB, x, preconditioner, controls);
+            return x;
+        };
+        const vector<T> x = run();
+        const double flops = double(report.iterations) * (2.0 * double(a.GetNonZeroCount()) + 20.0 * double(unknowns));
+        s.Add<T>(name, &a == &laplacian ? "grid" : "grid-convection", unknowns, flops, nnz,
+                 [&] { return sparse_backward_error(a, x, gridB); }, [&] { consume(run()[0]); });
+    };
+    const auto cg = [](auto&&... args) { return solve_matrix_eq_cg<T>(args...); };
+    const auto bicgstab = [](auto&&... args) { return solve_matrix_eq_bicgstab<T>(args...); };
+    const auto gmres = [](auto&&... args) { return solve_matrix_eq_gmres<T>(args...); };
+    krylov("solve_matrix_eq_cg/identity", laplacian, cg, IdentityPreconditioner<T>());
+    krylov("solve_matrix_eq_cg/jacobi", laplacian, cg, JacobiPreconditioner<T>(laplacian));
+    krylov("solve_matrix_eq_cg/incomplete_cholesky", laplacian, cg, IncompleteCholeskyPreconditioner<T>(laplacian));
+    krylov("solve_matrix_eq_bicgstab/ilu0", convection, bicgstab, ILU0Preconditioner<T>(convection));
+    krylov("solve_matrix_eq_gmres/identity", convection, gmres, IdentityPreconditioner<T>());
+    krylov("solve_matrix_eq_gmres/ilu0", convection, gmres, ILU0Preconditioner<T>(convection));
+}
+
+template <typename T>
+void run_batched(suite& s, const size_t n)
+{
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    const size_t count = 4096;
+    batched_matrix<T> general(n, count), spd(n, count);
+    batched_vector<T> b(n, count);
+    for(size_t system = 0; system < count; system++)
+    {
+        matrix<T> m{n, n};
+        for(size_t y = 0; y < n; y++)
+            for(size_t x = 0; x < n; x++)
+                m.GetElement(x, y) = dist(gen) + (x == y ? T(n) : T(0));
+        general.Set(system, m.View());
+        const matrix<T> symmetric = m * m.Transposed();
+        spd.Set(system, symmetric.View());
+        b.Set(system, random_vector<T>(n, gen).View());
+    }
+    const double nd = double(n), counted = double(count), elements = nd * nd * counted;
+    const auto batch_error = [&](const batched_matrix<T>& a, const batched_vector<T>& x)
+    {
+        double error = 0.0;
+        for(size_t system = 0; system < count; system += 97)
+            error = std::max(error, backward_error(a.Get(system), x.Get(system), b.Get(system)));
+        return error;
+    };
+
+    const auto gauss = [&]
+    {
+        batched_matrix<T> a = general;
+        batched_vector<T> x = b;
+        solve_matrix_eq_gauss_batched(a, x);
+        return x;
+    };
+    s.Add<T>("solve_matrix_eq_gauss_batched", "batched", n, counted * (2.0 / 3.0 * nd * nd * nd + 2.0 * nd * nd), elements,
+             [&] { return batch_error(general, gauss()); }, [&] { consume(gauss().GetElement(0, 0)); });
+    const auto lu = [&]
+    {
+        batched_matrix<T> a = general;
+        batched_vector<T> x = b;
+        lu_decomposition_batched(a);
+        solve_matrix_eq_with_lu_batched(a, x);
+        return x;
+    };
+    s.Add<T>("lu_decomposition_batched+solve", "batched", n, counted * (2.0 / 3.0 * nd * nd * nd + 2.0 * nd * nd), elements,
+             [&] { return batch_error(general, lu()); }, [&] { consume(lu().GetElement(0, 0)); });
+    const auto llt = [&]
+    {
+        batched_matrix<T> a = spd;
+        batched_vector<T> x = b;
+        llt_decomposition_batched(a);
+        solve_matrix_eq_with_llt_batched(a, x);
+        return x;
+    };
+    s.Add<T>("llt_decomposition_batched+solve", "batched", n, counted * (nd * nd * nd / 3.0 + 2.0 * nd * nd), elements,
+             [&] { return batch_error(spd, llt()); }, [&] { consume(llt().GetElement(0, 0)); });
+
+    const size_t length = 16 * n;
+    batched_vector<T> lower(length - 1, count), diagonal(length, count), upper(length - 1, count), rhs(length, count);
+    for(size_t system = 0; system < count; system++)
+        for(size_t i = 0; i < length; i++)
+        {
+            diagonal.GetElement(system, i) = T(4) + dist(gen);
+            rhs.GetElement(system, i) = dist(gen);
+            if(i + 1 < length)
+            {
+                lower.GetElement(system, i) = dist(gen);
+                upper.GetElement(system, i) = dist(gen);
+            }
+        }
+    const auto tridiagonal = [&]
+    {
+        batched_vector<T> l = lower, d = diagonal, x = rhs;
+        solve_tridiagonal_matrix_eq_batched(l, d, upper, x);
+        return x;
+    };
+    s.Add<T>("solve_tridiagonal_matrix_eq_batched", "batched", length, counted * 8.0 * double(length), 3.0 * double(length) * counted,
+             [&]
+             {
+                 const batched_vector<T> x = tridiagonal();
+                 double error = 0.0;
+                 for(size_t system = 0; system < count; system += 97)
+                 {
+                     const vector<T> solution = solve_tridiagonal_matrix_eq<T>({lower.Get(system), diagonal.Get(system), upper.Get(system)},
+                                                                               rhs.Get(system));
+                     for(size_t i = 0; i < length; i++)
+                         error = std::max(error, std::abs(double(x.GetElement(system, i)) - double(solution[i])) / max_norm(solution));
+                 }
+                 return error;
+             },
+             [&] { consume(tridiagonal().GetElement(0, 0)); });
+}
+
+template <typename T, size_t N>
+void run_fixed(suite& s)
+{
+    std::mt19937 gen(13);
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    const size_t count = 1024;
+    std::vector<fixed_matrix<T, N, N>> general(count), spd(count);
+    std::vector<fixed_vector<T, N>> b(count);
+    for(size_t system = 0; system < count; system++)
+    {
+        for(size_t y = 0; y < N; y++)
+        {
+            for(size_t x = 0; x < N; x++)
+                general[system].GetElement(x, y) = dist(gen) + (x == y ? T(N) : T(0));
+            b[system][y] = dist(gen);
+        }
+        for(size_t y = 0; y < N; y++)
+            for(size_t x = 0; x < N; x++)
+            {
+                T sum = T(0);
+                for(size_t k = 0; k < N; k++)
+                    sum += general[system].GetElement(k, y) * general[system].GetElement(k, x);
+                spd[system].GetElement(x, y) = sum;
+            }
+    }
+    const auto fixed_error = [&](const std::vector<fixed_matrix<T, N, N>>& a, auto&& solve)
+    {
+        double error = 0.0;
+        for(size_t system = 0; system < count; system += 31)
+        {
+            matrix<T> dense{N, N};
+            vector<T> rhs(N), x(N);
+            const fixed_vector<T, N> solution = solve(a[system], b[system]);
+            for(size_t y = 0; y < N; y++)
+            {
+                for(size_t c = 0; c < N; c++)
+                    dense.GetElement(c, y) = a[system].GetElement(c, y);
+                rhs[y] = b[system][y];
+                x[y] = solution[y];
+            }
+            error = std::max(error, backward_error(dense, x, rhs));
+        }
+        return error;
+    };
+    const double nd = double(N), elements = nd * nd * double(count);
+    const auto lu = [](const auto& a, const auto& rhs) { return solve_matrix_eq_with_lu_decomposition(a, rhs); };
+    const auto llt = [](const auto& a, const auto& rhs) { return solve_matrix_eq_with_llt_decomposition(a, rhs); };
+    s.Add<T>("solve_matrix_eq_with_lu_decomposition/fixed", "fixed", N, double(count) * (2.0 / 3.0 * nd * nd * nd + 2.0 * nd * nd), elements,
+             [&] { return fixed_error(general, lu); },
+             [&]
+             {
+                 for(size_t system = 0; system < count; system++)
+                     consume(lu(general[system], b[system])[0]);
+             });
+    s.Add<T>("solve_matrix_eq_with_llt_decomposition/fixed", "fixed", N, double(count) * (nd * nd * nd / 3.0 + 2.0 * nd * nd), elements,
+             [&] { return fixed_error(spd, llt); },
+             [&]
+             {
+                 for(size_t system = 0; system < count; system++)
+                     consume(llt(spd[system], b[system])[0]);
+             });
+}
+
+template <typename T>
+void run_polynomial(suite& s, const size_t n)
+{
+    std::mt19937 gen(17);
+    std::uniform_real_distribution<T> dist(-1.0, 1.0);
+    std::vector<T> coefficients(n), x, y;
+    for(auto& c : coefficients)
+        c = dist(gen) / T(n);
+    const T point = T(0.7);
+    const double nd = double(n);
+
+    s.Add<T>("solve_polynomial", "polynomial", n, 3.0 * nd, nd,
+             [&] { return std::abs(double(solve_polynomial<T>(coefficients, point) - solve_polynomial_horner<T>(coefficients, point))); },
+             [&] { consume(solve_polynomial<T>(coefficients, point)); });
+    s.Add<T>("solve_polynomial_horner", "polynomial", n, 2.0 * nd, nd,
+             [&] { return 0.0; }, [&] { consume(solve_polynomial_horner<T>(coefficients, point)); });
+    s.Add<T>("get_chebyshev_polynomial_zeros", "polynomial", n, 6.0 * nd, nd,
+             [&] { return 0.0; }, [&] { consume(get_chebyshev_polynomial_zeros<T>(n, T(-1), T(1))[0]); });
+
+    // interpolate a smooth function at the Chebyshev points, where Lagrange and Newton stay stable
+    x = get_chebyshev_polynomial_zeros<T>(n, T(-1), T(1));
+    for(const T xi : x)
+        y.push_back(std::exp(xi) * std::cos(T(3) * xi));
+    const auto target = [](const T t) { return double(std::exp(t) * std::cos(T(3) * t)); };
+    const auto interpolation_error = [&](const MFuncOf<T>& f)
+    {
+        double error = 0.0;
+        for(size_t i = 0; i < x.size(); i++)
+            error = std::max(error, std::abs(double(f(x[i])) - target(x[i])));
+        return error;
+    };
+    s.Add<T>("get_lagrange_interpolation", "interpolation", n, 3.0 * nd * nd * nd, nd,
+             [&] { return interpolation_error(get_lagrange_interpolation<T>(x, y)); },
+             [&]
+             {
+                 const auto f = get_lagrange_interpolation<T>(x, y);
+                 for(size_t i = 0; i < n; i++)
+                     consume(f(x[i] * T(0.99)));
+             });
+    s.Add<T>("get_newton_interpolation", "interpolation", n, 1.5 * nd * nd + 2.0 * nd * nd, nd,
+             [&] { return interpolation_error(get_newton_interpolation<T>(x, y)); },
+             [&]
+             {
+                 const auto f = get_newton_interpolation<T>(x, y);
+                 for(size_t i = 0; i < n; i++)
+                     consume(f(x[i] * T(0.99)));
+             });
+    const size_t degree = std::min<size_t>(n / 2, 12);
+    s.Add<T>("get_polynomial_approximation", "interpolation", n, nd * double(degree * degree) + double(degree * degree * degree), nd,
+             [&]
+             {
+                 const vector<T> p = get_polynomial_approximation<T>(x, y, degree);
+                 std::vector<T> c(p.GetSize());
+                 for(size_t i = 0; i < c.size(); i++)
+                     c[i] = p[i];
+                 double error = 0.0;
+                 for(size_t i = 0; i < x.size(); i++)
+                     error = std::max(error, std::abs(double(solve_polynomial_horner<T>(c, x[i])) - target(x[i])));
+                 return error;
+             },
+             [&] { consume(get_polynomial_approximation<T>(x, y, degree)[0]); });
+}
+
+template <typename T>
+void run_scalar(suite& s)
+{
+    const MFuncOf<T> cubic = [](const T t) { return t * t * t - T(2) * t - T(5); };
+    const double root = 2.0945514815423265;
+    // newton_raphson differentiates with a wide step, exact only for linear functions
+    const MFuncOf<T> linear = [](const T t) { return T(3) * t - T(1); };
+    const auto root_error = [&](const T found) { return std::abs(double(found) - root); };
+
+    s.Add<T>("find_derivative", "scalar", 1, 4.0, 1.0,
+             [&] { return std::abs(double(find_derivative<T>(cubic, T(2), T(1e-2))) - 10.0) / 10.0; },
+             [&] { consume(find_derivative<T>(cubic, T(2), T(1e-2))); });
+    s.Add<T>("find_function_zero_with_bisection", "scalar", 1, 0.0, 1.0,
+             [&] { return root_error(find_function_zero_with_bisection<T>(cubic, T(2), T(3))); },
+             [&] { consume(find_function_zero_with_bisection<T>(cubic, T(2), T(3))); });
+    s.Add<T>("find_function_zero_with_falsi", "scalar", 1, 0.0, 1.0,
+             [&] { return root_error(find_function_zero_with_falsi<T>(cubic, T(2), T(3))); },
+             [&] { consume(find_function_zero_with_falsi<T>(cubic, T(2), T(3))); });
+    s.Add<T>("find_function_zero_with_secant", "scalar", 1, 0.0, 1.0,
+             [&] { return root_error(find_function_zero_with_secant<T>(cubic, T(2), T(3))); },
+             [&] { consume(find_function_zero_with_secant<T>(cubic, T(2), T(3))); });
+    s.Add<T>("find_function_zero_with_newton_raphson", "scalar", 1, 0.0, 1.0,
+             [&] { return std::abs(double(find_function_zero_with_newton_raphson<T>(linear, T(0), T(1))) - 1.0 / 3.0); },
+             [&] { consume(find_function_zero_with_newton_raphson<T>(linear, T(0), T(1))); });
+}
+
+template <typename T>
+void run(suite& s, const options& opts)
+{
+    for(const size_t n : opts.sizes)
+    {
+        for(const conditioning c : {conditioning::well, conditioning::graded})
+        {
+            run_dense<T>(s, n, c);
+            run_symmetric<T>(s, n, c);
+        }
+        run_least_squares<T>(s, n);
+        run_structured<T>(s, n);
+        run_banded<T>(s, n);
+        run_polynomial<T>(s, std::min<size_t>(n, 128));
+    }
+    for(const size_t n : {4, 8, 16})
+        run_batched<T>(s, n);
+    run_fixed<T, 4>(s);
+    run_fixed<T, 8>(s);
+    run_scalar<T>(s);
+}
+
+std::vector<size_t> parse_sizes(const char* text)
+{
+    std::vector<size_t> sizes;
+    for(char* end = nullptr; *text; text = *end ? end + 1 : end)
+        sizes.push_back(std::strtoul(text, &end, 10));
+    return sizes;
+}
+
+}
+
+// usage: numericals_bench [--sizes 32,128,512] [--min-time seconds] [--filter substring] [--json file]
+// Every case prints one line; --json also writes them for bench/compare_bench.py.
+int main(int argc, char** argv)
+{
+    options opts;
+    for(int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if(!std::strcmp(argv[i], "--sizes") && hasValue) opts.sizes = parse_sizes(argv[++i]);
+        else if(!std::strcmp(argv[i], "--min-time") && hasValue) opts.min_time = std::strtod(argv[++i], nullptr);
+        else if(!std::strcmp(argv[i], "--filter") && hasValue) opts.filter = argv[++i];
+        else if(!std::strcmp(argv[i], "--json") && hasValue) opts.output = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--sizes 32,128,512] [--min-time seconds] [--filter substring] [--json file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    suite s(opts);
+    run<float>(s, opts);
+    run<double>(s, opts);
+
+    if(!opts.output.empty())
+    {
+        std::FILE* file = std::fopen(opts.output.c_str(), "w");
+        if(!file)
+        {
+            std::fprintf(stderr, "cannot write %s\n", opts.output.c_str());
+            return 1;
+        }
+        s.WriteJson(file);
+        std::fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "numerical_types.h"
+#include "Factorization.h"
+#include "matrix.h"
+#include "matrix_view.h"
+#include "storage.h"
+#include "vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace numericals {
+
+// Square size x size matrix with lower sub-diagonals and upper super-diagonals, stored by rows:
+// row y keeps columns y - lower to y + upper contiguously, lower + upper + 1 elements per row
+// (the slots falling outside the matrix stay zero).
+template <typename T = real>
+class band_matrix
+{
+public:
+    band_matrix(const size_t size, const size_t lower, const size_t upper)
+        : size(size), lower(lower), upper(upper), width(lower + upper + 1), data(size * width, T(0)) {}
+    // the band of the square a; entries outside it are dropped
+    band_matrix(matrix_view<const T> a, size_t lower, size_t upper);
+
+    size_t GetSize() const { return size; }
+    size_t GetLowerBandwidth() const { return lower; }
+    size_t GetUpperBandwidth() const { return upper; }
+    size_t GetStorageSize() const { return data.size(); }
+
+    bool InBand(const size_t x, const size_t y) const { return x + lower >= y && x <= y + upper; }
+    // (x, y) must be in the band
+    T& GetElement(const size_t x, const size_t y) { return data[y * width + x + lower - y]; }
+    // zero outside the band
+    T GetElement(const size_t x, const size_t y) const { return InBand(x, y) ? data[y * width + x + lower - y] : T(0); }
+
+    // the stored columns of row y within the matrix, [GetFirstColumn(y), GetLastColumn(y))
+    size_t GetFirstColumn(const size_t y) const { return y > lower ? y - lower : 0; }
+    size_t GetLastColumn(const size_t y) const { return std::min(size, y + upper + 1); }
+    vector_view<T> Row(const size_t y) { return {&GetElement(GetFirstColumn(y), y), GetLastColumn(y) - GetFirstColumn(y), 1}; }
+    vector_view<const T> Row(const size_t y) const
+    {
+        return {data.data() + y * width + GetFirstColumn(y) + lower - y, GetLastColumn(y) - GetFirstColumn(y), 1};
+    }
+
+    matrix<T> ToDense() const;
+
+private:
+    size_t size;
+    size_t lower;
+    size_t upper;
+    size_t width;
+    std::vector<T, aligned_allocator<T>> data;
+};
+
+// y = A x
+template <typename T>
+void multiply(const band_matrix<T>& a, vector_view<const T> x, vector_view<T> y);
+template <typename T>
+vector<T> operator*(const band_matrix<T>& a, const vector<T>& x);
+
+enum class band_pivoting { none, partial };
+
+// P A = L U for a band matrix in O(size lower (lower + upper)). Row exchanges widen U to
+// lower + upper super-diagonals, for which the factors reserve room up front; L keeps the
+// lower bandwidth and its multipliers stay where they were computed (the exchanges are
+// replayed on b instead). Without pivoting the factors keep the band of a exactly.
+template <typename T = real>
+class BandedLUFactorization : public Factorization<T>
+{
+public:
+    explicit BandedLUFactorization(const band_matrix<T>& a, band_pivoting pivoting = band_pivoting::partial);
+
+    using Factorization<T>::SolveInPlace;
+    void SolveInPlace(matrix_view<T> b) const override;
+    size_t GetSizeY() const override { return lu.GetSize(); }
+    size_t GetSizeX() const override { return lu.GetSize(); }
+
+    // unit L below the diagonal, U on and above it
+    const band_matrix<T>& GetFactors() const { return lu; }
+    // row k was exchanged with row swaps[k] before elimination step k; empty without pivoting
+    const std::vector<size_t>& GetSwaps() const { return swaps; }
+
+private:
+    band_matrix<T> lu;
+    std::vector<size_t> swaps;
+};
+
+// The general counterpart of solve_tridiagonal_matrix_eq (MatrixSolver.h)
+template <typename T>
+vector<T> solve_banded_matrix_eq(const band_matrix<T>& a, const vector<T>& b, band_pivoting pivoting = band_pivoting::partial);
+
+}
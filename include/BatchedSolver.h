@@ -0,0 +1,126 @@
+#pragma once
+#include "numerical_types.h"
+#include "matrix.h"
+#include "matrix_view.h"
+#include "parallel.h"
+#include "storage.h"
+#include "vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace numericals {
+
+// Systems interleaved per batch group: one cache line of elements, so every step of the
+// batched kernels is a SIMD operation across the lanes of a group.
+template <typename T>
+constexpr size_t batch_lanes = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+
+// count independent size x size matrices in array-of-structures-of-arrays layout: groups of
+// batch_lanes<T> systems, and within a group element (x, y) of every system is contiguous.
+// Lanes past count are padding and hold the identity.
+template <typename T = real>
+class batched_matrix
+{
+public:
+    static constexpr size_t lanes = batch_lanes<T>;
+
+    batched_matrix(const size_t size, const size_t count);
+
+    size_t GetSize() const { return size; }
+    size_t GetCount() const { return count; }
+    size_t GetGroupCount() const { return (count + lanes - 1) / lanes; }
+
+    T& GetElement(const size_t system, const size_t x, const size_t y) { return data[Index(system, x, y)]; }
+    T GetElement(const size_t system, const size_t x, const size_t y) const { return data[Index(system, x, y)]; }
+
+    void Set(const size_t system, matrix_view<const T> a);
+    matrix<T> Get(const size_t system) const;
+
+    // size * size * lanes elements of one group
+    T* GetGroup(const size_t group) { return data.data() + group * size * size * lanes; }
+    const T* GetGroup(const size_t group) const { return data.data() + group * size * size * lanes; }
+
+private:
+    size_t Index(const size_t system, const size_t x, const size_t y) const
+    {
+        return ((system / lanes * size + y) * size + x) * lanes + system % lanes;
+    }
+
+    size_t size;
+    size_t count;
+    std::vector<T, aligned_allocator<T>> data;
+};
+
+// count vectors of length size, interleaved like batched_matrix
+template <typename T = real>
+class batched_vector
+{
+public:
+    static constexpr size_t lanes = batch_lanes<T>;
+
+    batched_vector(const size_t size, const size_t count)
+        : size(size), count(count), data((count + lanes - 1) / lanes * lanes * size, T(0)) {}
+
+    size_t GetSize() const { return size; }
+    size_t GetCount() const { return count; }
+    size_t GetGroupCount() const { return (count + lanes - 1) / lanes; }
+
+    T& GetElement(const size_t system, const size_t i) { return data[Index(system, i)]; }
+    T GetElement(const size_t system, const size_t i) const { return data[Index(system, i)]; }
+
+    void Set(const size_t system, vector_view<const T> b);
+    vector<T> Get(const size_t system) const;
+
+    T* GetGroup(const size_t group) { return data.data() + group * size * lanes; }
+    const T* GetGroup(const size_t group) const { return data.data() + group * size * lanes; }
+
+private:
+    size_t Index(const size_t system, const size_t i) const
+    {
+        return (system / lanes * size + i) * lanes + system % lanes;
+    }
+
+    size_t size;
+    size_t count;
+    std::vector<T, aligned_allocator<T>> data;
+};
+
+// Outcome per system of a batched elimination or factorization. Lanes run in lockstep, so a
+// system that breaks down does not stop the others: its results are meaningless and it is
+// flagged here instead of throwing.
+struct batch_status
+{
+    // nonzero for every system that met a zero pivot (Gauss, LU) or a non-positive one (LL^T)
+    std::vector<unsigned char> failed;
+
+    size_t GetFailedCount() const { return failed.size() - size_t(std::count(failed.begin(), failed.end(), 0)); }
+    bool Succeeded() const { return GetFailedCount() == 0; }
+};
+
+// The batched solvers work in place: each system of b is overwritten with its solution.
+// Groups of systems are split between threads.
+
+// Gauss elimination with partial pivoting chosen per system; a is destroyed. Singular systems
+// are flagged in the result.
+template <typename T>
+batch_status solve_matrix_eq_gauss_batched(batched_matrix<T>& a, batched_vector<T>& b, size_t threads = get_num_threads());
+// Unpivoted LU, packed like lu_decomposition; systems with a zero pivot are flagged
+template <typename T>
+batch_status lu_decomposition_batched(batched_matrix<T>& a, size_t threads = get_num_threads());
+// L L^T of symmetric positive definite systems, packed like llt_decomposition; systems that
+// are not positive definite are flagged
+template <typename T>
+batch_status llt_decomposition_batched(batched_matrix<T>& a, size_t threads = get_num_threads());
+template <typename T>
+void solve_matrix_eq_with_lu_batched(const batched_matrix<T>& lu, batched_vector<T>& b, size_t threads = get_num_threads());
+template <typename T>
+void solve_matrix_eq_with_llt_batched(const batched_matrix<T>& llt, batched_vector<T>& b, size_t threads = get_num_threads());
+// count tridiagonal systems, each stored as vectors of its diagonals: lower and upper with
+// size - 1 elements, diagonal and b with size. Thomas runs on all lanes of a group at once;
+// like solve_tridiagonal_matrix_eq_in_place it overwrites lower and diagonal with the factors.
+template <typename T>
+void solve_tridiagonal_matrix_eq_batched(batched_vector<T>& lower, batched_vector<T>& diagonal, const batched_vector<T>& upper,
+                                         batched_vector<T>& b, size_t threads = get_num_threads());
+
+}
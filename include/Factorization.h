@@ -0,0 +1,123 @@
+#pragma once
+#include "numerical_types.h"
+#include "matrix.h"
+#include "matrix_view.h"
+#include "vector.h"
+
+namespace numericals {
+
+// A matrix factored once and then used for any number of right-hand sides, each solve
+// costing O(n^2) instead of a fresh O(n^3) factorization.
+template <typename T = real>
+class Factorization
+{
+public:
+    virtual ~Factorization() = default;
+
+    // Overwrites every column of b (GetSizeY() rows) with the solution; for least-squares
+    // factorizations the solution is left in the first GetSizeX() rows.
+    virtual void SolveInPlace(matrix_view<T> b) const = 0;
+
+    // Rows and columns of the factored matrix
+    virtual size_t GetSizeY() const = 0;
+    virtual size_t GetSizeX() const = 0;
+
+    void SolveInPlace(vector<T>& b) const;
+    vector<T> Solve(const vector<T>& b) const;
+    matrix<T> Solve(const matrix<T>& b) const;
+};
+
+// P A = L U with partial pivoting
+template <typename T = real>
+class LUFactorization : public Factorization<T>
+{
+public:
+    explicit LUFactorization(const matrix<T>& a);
+
+    using Factorization<T>::SolveInPlace;
+    void SolveInPlace(matrix_view<T> b) const override;
+    size_t GetSizeY() const override { return lu.GetSizeY(); }
+    size_t GetSizeX() const override { return lu.GetSizeX(); }
+
+    // L (unit diagonal, below) and U packed into one matrix
+    const matrix<T>& GetFactors() const { return lu; }
+    // permutation[i] is the row of a that ended up in row i
+    const scratch_vector<size_t>& GetPermutation() const { return permutation; }
+
+private:
+    matrix<T> lu;
+    scratch_vector<size_t> permutation;
+    // the permutation as a sequence of row swaps, applied to b without a scratch buffer
+    scratch_vector<size_t> swaps;
+};
+
+// A = L D L^T for symmetric a
+template <typename T = real>
+class LDLTFactorization : public Factorization<T>
+{
+public:
+    explicit LDLTFactorization(const matrix<T>& a);
+
+    using Factorization<T>::SolveInPlace;
+    void SolveInPlace(matrix_view<T> b) const override;
+    size_t GetSizeY() const override { return ldlt.GetSizeY(); }
+    size_t GetSizeX() const override { return ldlt.GetSizeX(); }
+
+    // D on the diagonal, L below it and L^T above it
+    const matrix<T>& GetFactors() const { return ldlt; }
+
+private:
+    matrix<T> ldlt;
+};
+
+// A = L L^T for symmetric positive definite a
+template <typename T = real>
+class LLTFactorization : public Factorization<T>
+{
+public:
+    explicit LLTFactorization(const matrix<T>& a);
+
+    using Factorization<T>::SolveInPlace;
+    void SolveInPlace(matrix_view<T> b) const override;
+    size_t GetSizeY() const override { return llt.GetSizeY(); }
+    size_t GetSizeX() const override { return llt.GetSizeX(); }
+
+    // L in the lower triangle; the upper triangle still holds a's entries
+    const matrix<T>& GetFactors() const { return llt; }
+
+private:
+    matrix<T> llt;
+};
+
+// A = Q R by Householder reflections, for square or tall a; Solve gives the least-squares
+// solution of over-determined systems.
+template <typename T = real>
+class QRFactorization : public Factorization<T>
+{
+public:
+    explicit QRFactorization(const matrix<T>& a);
+
+    using Factorization<T>::SolveInPlace;
+    void SolveInPlace(matrix_view<T> b) const override;
+    size_t GetSizeY() const override { return qr.GetSizeY(); }
+    size_t GetSizeX() const override { return qr.GetSizeX(); }
+
+    // Q is never formed; both apply the stored reflectors blockwise
+    // b = Q^T b
+    void ApplyQTransposed(matrix_view<T> b) const;
+    // b = Q b
+    void ApplyQ(matrix_view<T> b) const;
+
+    // the square upper triangular R of the economy-size factorization
+    matrix<T> GetR() const;
+
+    // R on and above the diagonal, the Householder vectors (without their unit head) below it
+    const matrix<T>& GetFactors() const { return qr; }
+    const scratch_vector<T>& GetHouseholderScales() const { return tau; }
+
+private:
+    matrix<T> qr;
+    scratch_vector<T> tau;
+};
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include "fixed_matrix.h"
+#include "numerical_errors.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+// Overloads of the solver and decomposition functions for fixed_matrix/fixed_vector. Every
+// loop runs over compile-time indices and is expanded in full, nothing touches the heap and
+// there is no PivotingStrategy dispatch. lu_decomposition does not pivot, like the dynamic one;
+// the LU solver pivots rows, which costs little at these sizes and keeps e.g. rotations solvable.
+
+namespace numericals {
+
+namespace detail {
+
+// Calls f(std::integral_constant<size_t, i>) for i in [Begin, End), expanded at compile time.
+template <size_t Begin, size_t End, typename F>
+constexpr void static_for(F&& f)
+{
+    if constexpr (Begin < End)
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (f(std::integral_constant<size_t, Begin + I>{}), ...);
+        }(std::make_index_sequence<End - Begin>{});
+}
+
+}
+
+template <typename T, size_t N>
+constexpr fixed_vector<T, N> solve_high_trian_matrix_eq(const fixed_matrix<T, N, N>& a, const fixed_vector<T, N>& b, bool assumeDiagonalOnes = false)
+{
+    fixed_vector<T, N> x;
+    detail::static_for<0, N>([&](auto i) {
+        constexpr size_t index = N - 1 - decltype(i)::value;
+        x[index] = b[index];
+        detail::static_for<index + 1, N>([&](auto j) {
+            x[index] -= a.GetElement(j, index) * x[j];
+        });
+        if(!assumeDiagonalOnes)
+            x[index] /= a.GetElement(index, index);
+    });
+    return x;
+}
+
+template <typename T, size_t N>
+constexpr fixed_vector<T, N> solve_low_trian_matrix_eq(const fixed_matrix<T, N, N>& a, const fixed_vector<T, N>& b, bool assumeDiagonalOnes = false)
+{
+    fixed_vector<T, N> x;
+    detail::static_for<0, N>([&](auto i) {
+        constexpr size_t index = decltype(i)::value;
+        x[index] = b[index];
+        detail::static_for<0, index>([&](auto j) {
+            x[index] -= a.GetElement(j, index) * x[j];
+        });
+        if(!assumeDiagonalOnes)
+            x[index] /= a.GetElement(index, index);
+    });
+    return x;
+}
+
+// L (unit diagonal, below) and U (on and above the diagonal) packed into one matrix; a zero
+// pivot that would be divided by throws
+template <typename T, size_t N>
+constexpr fixed_matrix<T, N, N> lu_decomposition(fixed_matrix<T, N, N> a)
+{
+    detail::static_for<0, N>([&](auto j) {
+        constexpr size_t col = decltype(j)::value;
+        if constexpr (col + 1 < N)
+        {
+            if(a.GetElement(col, col) == T(0)) [[unlikely]] throw std::runtime_error("Zero pivot in lu decomposition");
+            const T inverse = T(1) / a.GetElement(col, col);
+            detail::static_for<col + 1, N>([&](auto i) {
+                const T multiplier = a.GetElement(col, i) * inverse;
+                detail::static_for<col + 1, N>([&](auto k) {
+                    a.GetElement(k, i) -= multiplier * a.GetElement(k, col);
+                });
+                a.GetElement(col, i) = multiplier;
+            });
+        }
+    });
+    return a;
+}
+
+// P A = L U with partial pivoting, packed as by lu_decomposition; permutation[i] is the row of a
+// that ended up in row i. A column with no nonzero candidate left throws.
+template <typename T, size_t N>
+constexpr std::pair<fixed_matrix<T, N, N>, std::array<size_t, N>> lu_decomposition_with_pivoting(fixed_matrix<T, N, N> a)
+{
+    constexpr auto magnitude = [](const T value) { return value < T(0) ? -value : value; };
+    std::array<size_t, N> permutation;
+    detail::static_for<0, N>([&](auto i) { permutation[decltype(i)::value] = decltype(i)::value; });
+
+    detail::static_for<0, N>([&](auto j) {
+        constexpr size_t col = decltype(j)::value;
+        size_t pivot = col;
+        T max = magnitude(a.GetElement(col, col));
+        detail::static_for<col + 1, N>([&](auto i) {
+            if(magnitude(a.GetElement(col, decltype(i)::value)) > max)
+            {
+                max = magnitude(a.GetElement(col, decltype(i)::value));
+                pivot = decltype(i)::value;
+            }
+        });
+        if(max == T(0)) [[unlikely]] throw std::runtime_error("Singular matrix in lu decomposition");
+        if(pivot != col)
+        {
+            detail::static_for<0, N>([&](auto k) {
+                std::swap(a.GetElement(decltype(k)::value, col), a.GetElement(decltype(k)::value, pivot));
+            });
+            std::swap(permutation[col], permutation[pivot]);
+        }
+
+        const T inverse = T(1) / a.GetElement(col, col);
+        detail::static_for<col + 1, N>([&](auto i) {
+            const T multiplier = a.GetElement(col, i) * inverse;
+            detail::static_for<col + 1, N>([&](auto k) {
+                a.GetElement(k, i) -= multiplier * a.GetElement(k, col);
+            });
+            a.GetElement(col, i) = multiplier;
+        });
+    });
+    return {a, permutation};
+}
+
+// L below the diagonal and L^T above it, as llt_decomposition(matrix) returns; a failing pivot
+// throws not_positive_definite with its row
+template <typename T, size_t N>
+fixed_matrix<T, N, N> llt_decomposition(const fixed_matrix<T, N, N>& a)
+{
+    fixed_matrix<T, N, N> result;
+    detail::static_for<0, N>([&](auto i) {
+        constexpr size_t row = decltype(i)::value;
+        detail::static_for<0, row>([&](auto j) {
+            constexpr size_t col = decltype(j)::value;
+            T l = a.GetElement(col, row);
+            detail::static_for<0, col>([&](auto k) {
+                l -= result.GetElement(k, col) * result.GetElement(k, row);
+            });
+            l /= result.GetElement(col, col);
+            result.GetElement(col, row) = l;
+            result.GetElement(row, col) = l;
+        });
+        T d = a.GetElement(row, row);
+        detail::static_for<0, row>([&](auto k) {
+            d -= result.GetElement(k, row) * result.GetElement(k, row);
+        });
+        if(!(d > T(0))) [[unlikely]] throw not_positive_definite(row);
+        result.GetElement(row, row) = std::sqrt(d);
+    });
+    return result;
+}
+
+// pivots rows, see lu_decomposition_with_pivoting
+template <typename T, size_t N>
+constexpr fixed_vector<T, N> solve_matrix_eq_with_lu_decomposition(const fixed_matrix<T, N, N>& a, const fixed_vector<T, N>& b)
+{
+    constexpr bool assume_diagonal_ones = true;
+    const auto [lu, permutation] = lu_decomposition_with_pivoting(a);
+    fixed_vector<T, N> pb;
+    detail::static_for<0, N>([&](auto i) { pb[decltype(i)::value] = b[permutation[decltype(i)::value]]; });
+    return solve_high_trian_matrix_eq(lu, solve_low_trian_matrix_eq(lu, pb, assume_diagonal_ones));
+}
+
+template <typename T, size_t N>
+fixed_vector<T, N> solve_matrix_eq_with_llt_decomposition(const fixed_matrix<T, N, N>& a, const fixed_vector<T, N>& b)
+{
+    const fixed_matrix<T, N, N> llt = llt_decomposition(a);
+    return solve_high_trian_matrix_eq(llt, solve_low_trian_matrix_eq(llt, b));
+}
+
+}
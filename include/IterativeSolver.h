@@ -0,0 +1,127 @@
+#pragma once
+#include "numerical_types.h"
+#include "numerical_errors.h"
+#include "matrix.h"
+#include "matrix_view.h"
+#include "parallel.h"
+#include "sparse_matrix.h"
+#include "vector.h"
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace numericals {
+
+// y = A x; all the Krylov solvers need of A. The operators made by as_operator keep a
+// reference to their matrix.
+template <typename T>
+using linear_operator = std::function<void(vector_view<const T> x, vector_view<T> y)>;
+
+template <typename T>
+linear_operator<T> as_operator(const matrix<T>& a);
+template <typename T>
+linear_operator<T> as_operator(const csr_matrix<T>& a, size_t threads = get_num_threads());
+
+// Stop once ||b - A x|| <= tolerance ||b|| or after max_iterations iterations, each taking one
+// product with A in CG and GMRES and two in BiCGSTAB. restart is the Krylov subspace dimension
+// of GMRES, and monitor, when set, is called after every iteration with the iteration number
+// and the relative residual.
+template <typename T>
+struct iterative_controls
+{
+    T tolerance = T(1e-8);
+    size_t max_iterations = 1000;
+    size_t restart = 30;
+    std::function<void(size_t iteration, T residual)> monitor;
+};
+
+template <typename T>
+struct iterative_report
+{
+    // at most max_iterations
+    size_t iterations = 0;
+    // relative residual ||b - A x|| / ||b|| at the end
+    T residual = T(0);
+    bool converged = false;
+};
+
+// z = M^-1 r for an approximation M of A
+template <typename T = real>
+class Preconditioner
+{
+public:
+    virtual ~Preconditioner() = default;
+    virtual void Apply(vector_view<const T> r, vector_view<T> z) const = 0;
+};
+
+template <typename T = real>
+class IdentityPreconditioner : public Preconditioner<T>
+{
+public:
+    void Apply(vector_view<const T> r, vector_view<T> z) const override { z = r; }
+};
+
+// M = diag(A)
+template <typename T = real>
+class JacobiPreconditioner : public Preconditioner<T>
+{
+public:
+    explicit JacobiPreconditioner(const matrix<T>& a);
+    explicit JacobiPreconditioner(const csr_matrix<T>& a);
+
+    void Apply(vector_view<const T> r, vector_view<T> z) const override;
+
+private:
+    std::vector<T> inverseDiagonal;
+};
+
+// M = L U, both restricted to the pattern of A (unit L below the diagonal, U on and above it)
+template <typename T = real>
+class ILU0Preconditioner : public Preconditioner<T>
+{
+public:
+    explicit ILU0Preconditioner(const csr_matrix<T>& a);
+
+    void Apply(vector_view<const T> r, vector_view<T> z) const override;
+
+private:
+    csr_matrix<T> lu;
+    std::vector<size_t> diagonal;
+};
+
+// M = L L^T with L restricted to the lower pattern of the symmetric positive definite A; throws
+// not_positive_definite (numerical_errors.h) when the incomplete factorization breaks down
+template <typename T = real>
+class IncompleteCholeskyPreconditioner : public Preconditioner<T>
+{
+public:
+    explicit IncompleteCholeskyPreconditioner(const csr_matrix<T>& a);
+
+    void Apply(vector_view<const T> r, vector_view<T> z) const override;
+
+private:
+    // rows of L, the diagonal last in each
+    csr_matrix<T> l;
+};
+
+// x holds the initial guess on entry and the solution on return.
+// Conjugate gradients, for symmetric positive definite A and M; stops without converging once a
+// search direction p has p^T A p <= 0, which shows A is not positive definite
+template <typename T>
+iterative_report<T> solve_matrix_eq_cg(const linear_operator<T>& a, const vector<T>& b, vector<T>& x,
+                                       const Preconditioner<T>& preconditioner = IdentityPreconditioner<T>(),
+                                       const iterative_controls<T>& controls = {});
+// BiCGSTAB, for general A; each iteration takes two products with A
+template <typename T>
+iterative_report<T> solve_matrix_eq_bicgstab(const linear_operator<T>& a, const vector<T>& b, vector<T>& x,
+                                             const Preconditioner<T>& preconditioner = IdentityPreconditioner<T>(),
+                                             const iterative_controls<T>& controls = {});
+// GMRES(restart), right preconditioned so the reported residual is the true one; stops without
+// converging when a new direction adds nothing to the Krylov space while the residual is left,
+// keeping the least-squares solution over the directions so far
+template <typename T>
+iterative_report<T> solve_matrix_eq_gmres(const linear_operator<T>& a, const vector<T>& b, vector<T>& x,
+                                          const Preconditioner<T>& preconditioner = IdentityPreconditioner<T>(),
+                                          const iterative_controls<T>& controls = {});
+
+}
@@ -1,14 +1,58 @@
 #pragma once
 #include "matrix.h"
 #include "numerical_types.h"
+#include "numerical_errors.h"
 #include "PivotingStrategy.h"
+#include "FixedSizeSolver.h"
+#include "matrix_view.h"
+#include "parallel.h"
+#include "trsm.h"
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace numericals {
 
-matrix<real> lu_decomposition(matrix<real> a, PivotingStrategy&& strategy = NoPivotingStragegy());
-matrix<real> ldlt_decomposition(const matrix<real>& a);
-matrix<real> llt_decomposition(const matrix<real>& a);
-std::pair<matrix<real>, matrix<real>> qr_decomposition(const matrix<real>& a);
+// L (unit diagonal, below) and U packed into one matrix, without pivoting; a zero pivot that
+// would be divided by throws
+template <typename T>
+matrix<T> lu_decomposition(matrix<T> a);
+// P A = L U packed the same way, rows exchanged (partial pivoting) when strategy.ExchangesRows()
+// and left in place otherwise; permutation[i] receives the row of a that ended up in row i
+template <typename T>
+matrix<T> lu_decomposition(matrix<T> a, PivotingStrategy<T>&& strategy, scratch_vector<size_t>& permutation);
+// The factors alone have no room for row exchanges, so every strategy gets the unpivoted
+// factors of lu_decomposition(a), as before pivoting was supported
+template <typename T>
+[[deprecated("pass a permutation to lu_decomposition for row exchanges, or drop the strategy")]]
+matrix<T> lu_decomposition(matrix<T> a, PivotingStrategy<T>&& strategy);
+// P A = L U with partial pivoting; permutation[i] is the row of a that ended up in row i
+template <typename T>
+std::pair<matrix<T>, scratch_vector<size_t>> lu_decomposition_with_pivoting(matrix<T> a);
+// D on the diagonal, unit L below it and L^T above it, from the lower triangle of a; a zero
+// D(i) throws
+template <typename T>
+matrix<T> ldlt_decomposition(const matrix<T>& a);
+// L in the lower triangle and L^T mirrored into the upper one
+template <typename T>
+matrix<T> llt_decomposition(const matrix<T>& a);
+// Overwrites the lower triangle of the square view a with L, A = L L^T, or with part upper the
+// upper triangle with L^T; the other triangle is neither read nor written. The trailing updates
+// are split between up to threads threads.
+template <typename T>
+void llt_decomposition_in_place(matrix_view<T> a, triangle part = triangle::lower, size_t threads = get_num_threads());
+// Economy Q is rows x min(rows, cols) with R min(rows, cols) x cols, full Q is square
+enum class qr_mode { economy, full };
+// A = Q R with blocked Householder reflections and R's diagonal made non-negative
+template <typename T>
+std::pair<matrix<T>, matrix<T>> qr_decomposition(const matrix<T>& a, qr_mode mode = qr_mode::economy);
+// Implicit-Q form: overwrites a with R on and above the diagonal and the Householder vectors
+// (without their unit head) below it, and returns their scales. Panels of columns are reduced
+// unblocked and the rest of a is updated with their compact WY form I - V T V^T through gemm.
+template <typename T>
+scratch_vector<T> qr_decomposition_in_place(matrix_view<T> a);
+// b = Q b, or Q^T b when transposed, from the implicit form, without forming Q
+template <typename T>
+void apply_householder_q(std::type_identity_t<matrix_view<const T>> qr, const scratch_vector<T>& tau, matrix_view<T> b, bool transposed);
 
 }
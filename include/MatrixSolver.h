@@ -3,20 +3,113 @@
 #include "matrix.h"
 #include "vector.h"
 #include "PivotingStrategy.h"
+#include "FixedSizeSolver.h"
+#include "SparseSolver.h"
+#include "BandedSolver.h"
+#include "SolverWorkspace.h"
+#include "IterativeSolver.h"
+#include "instrumentation.h"
+#include "parallel.h"
+#include <chrono>
 #include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace numericals {
+
+// Solvers are templates over the scalar type, explicitly instantiated for float, double and long double.
+
+template <typename T>
+using matrix_eq_algorithm = std::function<vector<T>(matrix<T>, vector<T>, PivotingStrategy<T>&&)>;
+// lets a solver template such as solve_matrix_eq_jordan be passed by name
+template <typename T>
+using matrix_eq_algorithm_ptr = vector<T> (*)(matrix<T>, vector<T>, PivotingStrategy<T>&&);
+
 //w = x^n-1*a_n + x^n-2*a_n-1 + a_0 
-vector<real> solve_high_trian_matrix_eq(const matrix<real>& a, const vector<real>& b, bool assumeDiagonalOnes = false);
-vector<real> solve_low_trian_matrix_eq(const matrix<real>& a, const vector<real>& b, bool assumeDiagonalOnes = false);
-vector<real> solve_overdetermined_matrix(const matrix<real>& a, const vector<real>& b, std::function<vector<real>(matrix<real>, vector<real>, PivotingStrategy&&)> algorithm, PivotingStrategy&& strategy = NoPivotingStragegy());
+template <typename T>
+vector<T> solve_high_trian_matrix_eq(const matrix<T>& a, const vector<T>& b, bool assumeDiagonalOnes = false);
+template <typename T>
+vector<T> solve_low_trian_matrix_eq(const matrix<T>& a, const vector<T>& b, bool assumeDiagonalOnes = false);
+// Every column of b at once (blocked, see trsm.h); transposed solves with the transpose of the triangle
+template <typename T>
+matrix<T> solve_high_trian_matrix_eq(const matrix<T>& a, matrix<T> b, bool assumeDiagonalOnes = false, bool transposed = false);
+template <typename T>
+matrix<T> solve_low_trian_matrix_eq(const matrix<T>& a, matrix<T> b, bool assumeDiagonalOnes = false, bool transposed = false);
+// A^T A and A^T b, computed in one sweep over a without forming A^T
+template <typename T>
+std::pair<matrix<T>, vector<T>> get_normal_equations(const matrix<T>& a, const vector<T>& b);
+// Least squares through Householder QR: Q^T is applied to b directly and R solved, so the
+// conditioning of a is not squared as with the normal equations of the overloads below
+template <typename T>
+vector<T> solve_overdetermined_matrix(const matrix<T>& a, const vector<T>& b);
+template <typename T>
+vector<T> solve_overdetermined_matrix(const matrix<T>& a, const vector<T>& b, std::type_identity_t<matrix_eq_algorithm<T>> algorithm, PivotingStrategy<T>&& strategy = NoPivotingStragegy<T>());
+template <typename T>
+vector<T> solve_overdetermined_matrix(const matrix<T>& a, const vector<T>& b, matrix_eq_algorithm_ptr<T> algorithm, PivotingStrategy<T>&& strategy = NoPivotingStragegy<T>());
 
-vector<real> solve_matrix_eq_gauss( matrix<real> a, vector<real> b, PivotingStrategy&& strategy = NoPivotingStragegy());
-vector<real> solve_matrix_eq_jordan( matrix<real> a, vector<real> b,  PivotingStrategy&& strategy = NoPivotingStragegy());
-vector<real> solve_tridiagonal_matrix_eq( std::array<vector<real>, 3> a, vector<real> b);
-vector<real> solve_matrix_eq_with_qr_decomposition(const matrix<real>& a, const vector<real>& b);
-vector<real> solve_matrix_eq_with_lu_decomposition(const matrix<real>& a, const vector<real>& b, PivotingStrategy&& strategy = NoPivotingStragegy());
-vector<real> solve_matrix_eq_with_ldlt_decomposition(const matrix<real>& a, const vector<real>& b);
-vector<real> solve_matrix_eq_with_llt_decomposition(const matrix<real>& a, const vector<real>& b);
+template <typename T>
+vector<T> solve_matrix_eq_gauss( matrix<T> a, vector<T> b, PivotingStrategy<T>&& strategy = NoPivotingStragegy<T>());
+template <typename T>
+vector<T> solve_matrix_eq_jordan( matrix<T> a, vector<T> b,  PivotingStrategy<T>&& strategy = NoPivotingStragegy<T>());
+// Pivoting resolved at compile time through a policy from PivotingStrategy.h; rows and columns
+// are reordered through permutation vectors, never copied
+template <typename T, pivoting_policy<T> Policy>
+vector<T> solve_matrix_eq_gauss( matrix<T> a, vector<T> b, Policy policy);
+template <typename T, pivoting_policy<T> Policy>
+vector<T> solve_matrix_eq_jordan( matrix<T> a, vector<T> b, Policy policy);
+// In-place forms of the four above: a is destroyed and b overwritten with the solution. The
+// policy forms, given a SolverWorkspace sized for the system, make no heap allocation at all;
+// so do the strategy forms with no or partial pivoting. FullPivotingStragegy keeps its column
+// swaps on a stack backed by scratch_vector, which allocates but is counted by
+// heap_allocation_count. The Jordan forms stay on the calling thread unless given more threads
+// (0 for one per hardware thread); starting the workers allocates.
+template <typename T>
+void solve_matrix_eq_gauss_in_place(matrix<T>& a, vector<T>& b, PivotingStrategy<T>&& strategy = NoPivotingStragegy<T>());
+template <typename T>
+void solve_matrix_eq_jordan_in_place(matrix<T>& a, vector<T>& b, PivotingStrategy<T>&& strategy = NoPivotingStragegy<T>(),
+                                     size_t threads = 1);
+template <typename T, pivoting_policy<T> Policy>
+void solve_matrix_eq_gauss_in_place(matrix<T>& a, vector<T>& b, Policy policy, SolverWorkspace<T>& workspace);
+template <typename T, pivoting_policy<T> Policy>
+void solve_matrix_eq_jordan_in_place(matrix<T>& a, vector<T>& b, Policy policy, SolverWorkspace<T>& workspace,
+                                     size_t threads = 1);
+// A X = B for every column of b, with partial pivoting. The row updates of each pivot step are
+// split between threads; step_times, when given, receives the wall time of every step.
+template <typename T>
+matrix<T> solve_matrix_eq_jordan( matrix<T> a, matrix<T> b, size_t threads = get_num_threads(),
+                                  std::vector<std::chrono::nanoseconds>* step_times = nullptr);
+template <typename T>
+matrix<T> get_inverse_matrix(const matrix<T>& a, size_t threads = get_num_threads());
+// a[0] the sub-diagonal, a[1] the diagonal, a[2] the super-diagonal; wider bands go through
+// solve_banded_matrix_eq (BandedSolver.h)
+template <typename T>
+vector<T> solve_tridiagonal_matrix_eq( std::array<vector<T>, 3> a, vector<T> b);
+// The Thomas algorithm without copies: lower (size - 1 elements) is overwritten with the
+// multipliers of L, diagonal with the diagonal of U, and b with the solution
+template <typename T>
+void solve_tridiagonal_matrix_eq_in_place(vector_view<T> lower, vector_view<T> diagonal,
+                                          std::type_identity_t<vector_view<const T>> upper, vector_view<T> b);
+// Partitioned for large systems: every thread eliminates its block of rows together with the
+// two spikes coupling it to its neighbours, the interface unknowns are solved from the small
+// band system of the spike tips, and the blocks are finished independently. Like Thomas it
+// does not pivot, so a should be diagonally dominant (or otherwise safe without pivoting).
+template <typename T>
+void solve_tridiagonal_matrix_eq_parallel(std::type_identity_t<vector_view<const T>> lower,
+                                          std::type_identity_t<vector_view<const T>> diagonal,
+                                          std::type_identity_t<vector_view<const T>> upper, vector_view<T> b,
+                                          size_t threads = get_num_threads());
+// The decomposition solvers factor a on every call; keep a Factorization (Factorization.h)
+// instead when a stays fixed across many right-hand sides.
+// square or tall a, the latter in the least-squares sense
+template <typename T>
+vector<T> solve_matrix_eq_with_qr_decomposition(const matrix<T>& a, const vector<T>& b);
+// pivots rows when strategy.ExchangesRows() (partial and full pivoting), does not pivot otherwise
+template <typename T>
+vector<T> solve_matrix_eq_with_lu_decomposition(const matrix<T>& a, const vector<T>& b, PivotingStrategy<T>&& strategy = NoPivotingStragegy<T>());
+template <typename T>
+vector<T> solve_matrix_eq_with_ldlt_decomposition(const matrix<T>& a, const vector<T>& b);
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_decomposition(const matrix<T>& a, const vector<T>& b);
 
 }
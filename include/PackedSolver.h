@@ -0,0 +1,141 @@
+#pragma once
+#include "numerical_types.h"
+#include "numerical_errors.h"
+#include "matrix.h"
+#include "matrix_view.h"
+#include "parallel.h"
+#include "storage.h"
+#include "vector.h"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace numericals {
+
+// Lower triangle of a symmetric (or lower triangular) size x size matrix packed by rows: row y
+// keeps its elements x <= y contiguously from y (y + 1) / 2 on, size (size + 1) / 2 in all.
+template <typename T = real>
+class packed_matrix
+{
+public:
+    explicit packed_matrix(const size_t size) : size(size), data(size * (size + 1) / 2, T(0)) {}
+    // the lower triangle of the square a
+    explicit packed_matrix(matrix_view<const T> a);
+
+    size_t GetSize() const { return size; }
+    size_t GetStorageSize() const { return data.size(); }
+
+    // x > y addresses the mirrored element (y, x)
+    T& GetElement(const size_t x, const size_t y) { return data[Index(x, y)]; }
+    T GetElement(const size_t x, const size_t y) const { return data[Index(x, y)]; }
+
+    // the y + 1 stored elements of row y
+    vector_view<T> Row(const size_t y) { return {data.data() + y * (y + 1) / 2, y + 1, 1}; }
+    vector_view<const T> Row(const size_t y) const { return {data.data() + y * (y + 1) / 2, y + 1, 1}; }
+
+    matrix<T> GetSymmetric() const;
+    // zeros above the diagonal
+    matrix<T> GetLower() const;
+
+private:
+    static size_t Index(size_t x, size_t y)
+    {
+        if(x > y) std::swap(x, y);
+        return y * (y + 1) / 2 + x;
+    }
+
+    size_t size;
+    std::vector<T, aligned_allocator<T>> data;
+};
+
+// Lower triangle of a symmetric size x size matrix in rectangular full packed form, as one
+// row-major rectangle n2 elements wide with n1 = size / 2 and n2 = size - n1. The lower
+// triangle of the trailing n2 x n2 block A22 sits in a square of that width, the leading block
+// A11 fills the square's upper part transposed (an extra row on top when size is even makes it
+// fit), and the n1 rows below hold A21^T. That is size (size + 1) / 2 elements again, but every
+// block is an ordinary matrix view, so the blocked kernels run on them unchanged.
+template <typename T = real>
+class rfp_matrix
+{
+public:
+    explicit rfp_matrix(const size_t size)
+        : size(size), n1(size / 2), n2(size - size / 2), data((n2 + Offset() + n1) * n2, T(0)) {}
+    // the lower triangle of the square a
+    explicit rfp_matrix(matrix_view<const T> a);
+
+    size_t GetSize() const { return size; }
+    size_t GetStorageSize() const { return data.size(); }
+    size_t GetLeadingSize() const { return n1; }
+    size_t GetTrailingSize() const { return n2; }
+
+    // x > y addresses the mirrored element (y, x)
+    T& GetElement(const size_t x, const size_t y) { return data[Index(x, y)]; }
+    T GetElement(const size_t x, const size_t y) const { return data[Index(x, y)]; }
+
+    // n1 x n1 view with A11 in its upper triangle; the part below the diagonal belongs to A22
+    matrix_view<T> GetLeadingBlock() { return Rectangle().Block(1 - Offset(), 0, n1, n1); }
+    matrix_view<const T> GetLeadingBlock() const { return Rectangle().Block(1 - Offset(), 0, n1, n1); }
+    // A21^T, n1 rows of n2 elements
+    matrix_view<T> GetOffDiagonalBlock() { return Rectangle().Block(0, n2 + Offset(), n2, n1); }
+    matrix_view<const T> GetOffDiagonalBlock() const { return Rectangle().Block(0, n2 + Offset(), n2, n1); }
+    // n2 x n2 view with A22 in its lower triangle; the part above the diagonal belongs to A11
+    matrix_view<T> GetTrailingBlock() { return Rectangle().Block(0, Offset(), n2, n2); }
+    matrix_view<const T> GetTrailingBlock() const { return Rectangle().Block(0, Offset(), n2, n2); }
+
+    matrix<T> GetSymmetric() const;
+    // zeros above the diagonal
+    matrix<T> GetLower() const;
+
+private:
+    size_t Offset() const { return size % 2 == 0 ? 1 : 0; }
+
+    matrix_view<T> Rectangle() { return {data.data(), n2, n2 + Offset() + n1, ptrdiff_t(n2)}; }
+    matrix_view<const T> Rectangle() const { return {data.data(), n2, n2 + Offset() + n1, ptrdiff_t(n2)}; }
+
+    size_t Index(size_t x, size_t y) const
+    {
+        if(x > y) std::swap(x, y);
+        if(y < n1) return x * n2 + y + 1 - Offset();
+        if(x >= n1) return (y - n1 + Offset()) * n2 + x - n1;
+        return (n2 + Offset() + x) * n2 + y - n1;
+    }
+
+    size_t size;
+    size_t n1;
+    size_t n2;
+    std::vector<T, aligned_allocator<T>> data;
+};
+
+// The decompositions overwrite their argument with the factor's lower triangle and throw
+// not_positive_definite (numerical_errors.h) on a failing Cholesky pivot.
+// Row by row, reading and writing only the packed triangle
+template <typename T>
+void llt_decomposition_in_place(packed_matrix<T>& a);
+// unit L below the diagonal, D on it
+template <typename T>
+void ldlt_decomposition_in_place(packed_matrix<T>& a);
+// A11 first, then L21 through trsm and A22 after a syrk update, with the blocked kernels of
+// MatrixDecomposer.h; the trailing updates are split between up to threads threads
+template <typename T>
+void llt_decomposition_in_place(rfp_matrix<T>& a, size_t threads = get_num_threads());
+
+// L x = b for the lower triangle l, or L^T x = b when transposed
+template <typename T>
+vector<T> solve_low_trian_matrix_eq(const packed_matrix<T>& l, vector<T> b, bool assumeDiagonalOnes = false, bool transposed = false);
+template <typename T>
+vector<T> solve_low_trian_matrix_eq(const rfp_matrix<T>& l, vector<T> b, bool assumeDiagonalOnes = false, bool transposed = false);
+// Every column of b at once
+template <typename T>
+matrix<T> solve_low_trian_matrix_eq(const rfp_matrix<T>& l, matrix<T> b, bool assumeDiagonalOnes = false, bool transposed = false);
+
+// A x = b from the factors left by the decompositions above
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_packed(const packed_matrix<T>& llt, vector<T> b);
+template <typename T>
+vector<T> solve_matrix_eq_with_ldlt_packed(const packed_matrix<T>& ldlt, vector<T> b);
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_packed(const rfp_matrix<T>& llt, vector<T> b);
+template <typename T>
+matrix<T> solve_matrix_eq_with_llt_packed(const rfp_matrix<T>& llt, matrix<T> b);
+
+}
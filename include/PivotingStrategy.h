@@ -1,65 +1,162 @@
 #pragma once
 #include "numerical_types.h"
 #include "matrix.h"
+#include "matrix_view.h"
 #include "vector.h"
+#include "instrumentation.h"
+#include <cmath>
+#include <concepts>
+#include <span>
 #include <utility>
+#include <vector>
 #include "utils.h"
 
+template <typename T = real>
 class PivotingStrategy
 {
 public:
-    virtual void PreIteration(matrix<real>& A, vector<real>& b, const size_t i) = 0;
-    virtual void CleanUp(vector<real>& x) = 0;
+    virtual void PreIteration(matrix<T>& A, vector<T>& b, const size_t i) = 0;
+    virtual void CleanUp(vector<T>& x) = 0;
+    // Whether the factorization-based solvers, which do not go through the hooks above, should
+    // exchange rows for stability; those support no other kind of pivoting
+    virtual bool ExchangesRows() const { return false; }
 };
 
-class NoPivotingStragegy : public PivotingStrategy
+template <typename T = real>
+class NoPivotingStragegy : public PivotingStrategy<T>
 {
 public:
-    void PreIteration([[maybe_unused]]matrix<real>& A, 
-                      [[maybe_unused]]vector<real>& b, 
+    void PreIteration([[maybe_unused]]matrix<T>& A, 
+                      [[maybe_unused]]vector<T>& b, 
                       [[maybe_unused]]const size_t i) override {}
-    void CleanUp([[maybe_unused]]vector<real>& x) override {}
+    void CleanUp([[maybe_unused]]vector<T>& x) override {}
 };
 
-class PartialPivotingStragegy : public PivotingStrategy
+template <typename T = real>
+class PartialPivotingStragegy : public PivotingStrategy<T>
 {
 public:
-    void PreIteration(matrix<real>& A, vector<real>& b, const size_t i) override
+    void PreIteration(matrix<T>& A, vector<T>& b, const size_t i) override
     {
-        size_t maxInd = find_index_of_valarray_max<real>(A.GetColumnSlice(i), i, A.GetSizeY());               
+        size_t maxInd;
+        {
+            NUMERICALS_INSTRUMENT_PHASE(pivot_search);
+            maxInd = find_index_of_valarray_max(A.Column(i), i, A.GetSizeY());
+        }
         if(maxInd == i) return;
         
-        swap_slices(A.GetRowSlice(i), A.GetRowSlice(maxInd));
+        NUMERICALS_INSTRUMENT_PHASE(swaps);
+        NUMERICALS_COUNT_PIVOT_SWAP();
+        swap_slices(A.Row(i), A.Row(maxInd));
         std::swap(b[i], b[maxInd]);
     }
-    void CleanUp([[maybe_unused]] vector<real>& x) override{}
+    void CleanUp([[maybe_unused]] vector<T>& x) override{}
+    bool ExchangesRows() const override { return true; }
 };
 
-class FullPivotingStragegy : public PivotingStrategy
+template <typename T = real>
+class FullPivotingStragegy : public PivotingStrategy<T>
 {
 public:
-    void PreIteration(matrix<real>& A, vector<real>& b, const size_t i) override
+    void PreIteration(matrix<T>& A, vector<T>& b, const size_t i) override
     {
-        auto [maxIndx, maxIndy] = find_index_of_matrix_max(A, i, i);
+        std::pair<size_t, size_t> max;
+        {
+            NUMERICALS_INSTRUMENT_PHASE(pivot_search);
+            max = find_index_of_matrix_max(A, i, i);
+        }
+        const auto [maxIndx, maxIndy] = max;
                     
         if(maxIndy == i && maxIndx == i) return;
                     
-        swap_slices(A.GetRowSlice(i), A.GetRowSlice(maxIndy));
+        NUMERICALS_INSTRUMENT_PHASE(swaps);
+        NUMERICALS_COUNT_PIVOT_SWAP();
+        swap_slices(A.Row(i), A.Row(maxIndy));
         std::swap(b[i], b[maxIndy]);
-        swap_slices(A.GetColumnSlice(i), A.GetColumnSlice(maxIndx));
+        swap_slices(A.Column(i), A.Column(maxIndx));
         stack.push({i, maxIndx});
  
     }
 
-    void CleanUp(vector<real>& x) override
+    void CleanUp(vector<T>& x) override
     {
+        NUMERICALS_INSTRUMENT_PHASE(swaps);
         while(!stack.empty())
         {
             std::swap(x[stack.top().first], x[stack.top().second]);
             stack.pop();
         }
     }
+    bool ExchangesRows() const override { return true; }
 
 private:
     permutation_stack stack;
 };
+
+// Compile-time pivoting policies. Instead of moving data they keep the elimination order in
+// permutation vectors: logical row i lives in storage row rows[i] and logical column j in
+// storage column cols[j], so a pivot step costs two index swaps on top of the search.
+// Select moves the largest (absolute) element of the active submatrix it searches to
+// logical position (d, d).
+
+struct NoPivotingPolicy
+{
+    static constexpr bool permutes_columns = false;
+
+    template <typename T>
+    static void Select([[maybe_unused]] matrix_view<const T> a, [[maybe_unused]] std::span<size_t> rows,
+                       [[maybe_unused]] std::span<size_t> cols, [[maybe_unused]] const size_t d) {}
+};
+
+struct PartialPivotingPolicy
+{
+    static constexpr bool permutes_columns = false;
+
+    template <typename T>
+    static void Select(const matrix_view<const T> a, const std::span<size_t> rows, const std::span<size_t> cols, const size_t d)
+    {
+        NUMERICALS_INSTRUMENT_PHASE(pivot_search);
+        const size_t col = cols[d];
+        size_t best = d;
+        T max = std::abs(a.GetElement(col, rows[d]));
+        for(size_t i = d + 1; i < rows.size(); i++)
+            if(std::abs(a.GetElement(col, rows[i])) > max)
+            {
+                max = std::abs(a.GetElement(col, rows[i]));
+                best = i;
+            }
+        if(best != d) NUMERICALS_COUNT_PIVOT_SWAP();
+        std::swap(rows[d], rows[best]);
+    }
+};
+
+struct FullPivotingPolicy
+{
+    static constexpr bool permutes_columns = true;
+
+    template <typename T>
+    static void Select(const matrix_view<const T> a, const std::span<size_t> rows, const std::span<size_t> cols, const size_t d)
+    {
+        NUMERICALS_INSTRUMENT_PHASE(pivot_search);
+        size_t bestRow = d, bestCol = d;
+        T max = std::abs(a.GetElement(cols[d], rows[d]));
+        for(size_t i = d; i < rows.size(); i++)
+            for(size_t j = d; j < cols.size(); j++)
+                if(std::abs(a.GetElement(cols[j], rows[i])) > max)
+                {
+                    max = std::abs(a.GetElement(cols[j], rows[i]));
+                    bestRow = i;
+                    bestCol = j;
+                }
+        if(bestRow != d || bestCol != d) NUMERICALS_COUNT_PIVOT_SWAP();
+        std::swap(rows[d], rows[bestRow]);
+        std::swap(cols[d], cols[bestCol]);
+    }
+};
+
+template <typename P, typename T>
+concept pivoting_policy = requires(matrix_view<const T> a, std::span<size_t> order, size_t d)
+{
+    { P::permutes_columns } -> std::convertible_to<bool>;
+    P::template Select<T>(a, order, order, d);
+};
@@ -2,23 +2,43 @@
 #include "numerical_types.h"
 #include <functional>
 #include <span>
+#include <type_traits>
 #include <vector>
 #include "vector.h"
 
-using MFunc = std::function<real(real)>;
+template <typename T>
+using MFuncOf = std::function<T(T)>;
+using MFunc = MFuncOf<real>;
 
-real find_derivative(MFunc, real, real);
+// The scalar type is never deduced from the arguments (lambdas, containers, mixed literals):
+// it defaults to real and is picked explicitly otherwise, e.g. find_function_zero_with_secant<double>(f, a, b).
+// Instantiated for float, double and long double.
+template <typename T>
+using scalar_arg = std::type_identity_t<T>;
 
-real solve_polynomial(std::span<real>,const real);
-real solve_polynomial_horner(std::span<real>,const real);
+template <typename T = real>
+T find_derivative(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>);
 
-std::vector<real> get_chebyshev_polynomial_zeros(size_t n, real a, real b);
+template <typename T = real>
+T solve_polynomial(scalar_arg<std::span<T>>, const scalar_arg<T>);
+template <typename T = real>
+T solve_polynomial_horner(scalar_arg<std::span<T>>, const scalar_arg<T>);
 
-real find_function_zero_with_bisection(MFunc, real, real);
-real find_function_zero_with_falsi(MFunc, real, real);
-real find_function_zero_with_secant(MFunc, real, real);
-real find_function_zero_with_newton_raphson(MFunc, real, real);
+template <typename T = real>
+std::vector<T> get_chebyshev_polynomial_zeros(size_t n, scalar_arg<T> a, scalar_arg<T> b);
 
-vector<real> get_polynomial_approximation(std::span<real> x, std::span<real> y, size_t n, std::vector<std::function<real(real)>> base = {});
-MFunc get_lagrange_interpolation(std::span<real> x, std::span<real> y);
-MFunc get_newton_interpolation(std::span<real> x, std::span<real> y);
+template <typename T = real>
+T find_function_zero_with_bisection(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>);
+template <typename T = real>
+T find_function_zero_with_falsi(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>);
+template <typename T = real>
+T find_function_zero_with_secant(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>);
+template <typename T = real>
+T find_function_zero_with_newton_raphson(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>);
+
+template <typename T = real>
+vector<T> get_polynomial_approximation(scalar_arg<std::span<T>> x, scalar_arg<std::span<T>> y, size_t n, std::vector<std::function<T(T)>> base = {});
+template <typename T = real>
+MFuncOf<T> get_lagrange_interpolation(scalar_arg<std::span<T>> x, scalar_arg<std::span<T>> y);
+template <typename T = real>
+MFuncOf<T> get_newton_interpolation(scalar_arg<std::span<T>> x, scalar_arg<std::span<T>> y);
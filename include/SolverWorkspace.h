@@ -0,0 +1,50 @@
+#pragma once
+#include "numerical_types.h"
+#include "storage.h"
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace numericals {
+
+// Scratch buffers of the in-place solvers (MatrixSolver.h): the row and column orders of the
+// pivoting policies and a solution buffer. They grow to the largest system solved so far and
+// are kept, so repeated solves up to that size allocate nothing.
+template <typename T = real>
+class SolverWorkspace
+{
+public:
+    SolverWorkspace() = default;
+    explicit SolverWorkspace(const size_t size) { Reserve(size); }
+
+    void Reserve(const size_t size)
+    {
+        if(size <= rows.size()) return;
+        rows.resize(size);
+        cols.resize(size);
+        solution.resize(size);
+    }
+    size_t GetCapacity() const { return rows.size(); }
+
+    // Readies the buffers for a size x size system, resetting both orders to the identity
+    void Prepare(const size_t size)
+    {
+        Reserve(size);
+        current = size;
+        std::iota(rows.begin(), rows.begin() + ptrdiff_t(size), size_t(0));
+        std::iota(cols.begin(), cols.begin() + ptrdiff_t(size), size_t(0));
+    }
+
+    std::span<size_t> GetRows() { return {rows.data(), current}; }
+    std::span<size_t> GetCols() { return {cols.data(), current}; }
+    std::span<T> GetSolution() { return {solution.data(), current}; }
+
+private:
+    std::vector<size_t, aligned_allocator<size_t>> rows;
+    std::vector<size_t, aligned_allocator<size_t>> cols;
+    std::vector<T, aligned_allocator<T>> solution;
+    size_t current = 0;
+};
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "numerical_types.h"
+#include "numerical_errors.h"
+#include "Factorization.h"
+#include "matrix_view.h"
+#include "sparse_matrix.h"
+#include "vector.h"
+#include <cstddef>
+#include <vector>
+
+namespace numericals {
+
+enum class fill_ordering { natural, approximate_minimum_degree };
+
+// Symmetric fill-reducing permutation of the square a from the pattern of A + A^T:
+// ordering[k] is the row and column eliminated k-th. The elimination graph is kept as a
+// quotient graph, eliminated nodes becoming elements that absorb their neighbouring elements,
+// and the node of least approximate external degree (as in AMD) is eliminated next.
+template <typename T>
+std::vector<size_t> approximate_minimum_degree_ordering(const csc_matrix<T>& a);
+
+// P A Q = L U for square sparse a. Q comes from the fill ordering, P from threshold partial
+// pivoting: the diagonal entry is kept while it is at least lu_pivot_threshold of the largest
+// candidate. Columns are computed left-looking, each through a sparse triangular solve over the
+// reach of its pattern, so the work is proportional to the flops of the factorization.
+template <typename T = real>
+class SparseLUFactorization : public Factorization<T>
+{
+public:
+    static constexpr T lu_pivot_threshold = T(0.1);
+
+    explicit SparseLUFactorization(const csc_matrix<T>& a, fill_ordering ordering = fill_ordering::approximate_minimum_degree);
+
+    using Factorization<T>::SolveInPlace;
+    void SolveInPlace(matrix_view<T> b) const override;
+    size_t GetSizeY() const override { return size; }
+    size_t GetSizeX() const override { return size; }
+
+    // stored entries of L (unit diagonal included) and U
+    size_t GetNonZeroCount() const { return lower.GetNonZeroCount() + upper.GetNonZeroCount(); }
+    const csc_matrix<T>& GetLower() const { return lower; }
+    const csc_matrix<T>& GetUpper() const { return upper; }
+
+private:
+    size_t size;
+    csc_matrix<T> lower;
+    csc_matrix<T> upper;
+    // rowPermutation[i] is the row of L U holding row i of a, columnOrder[k] the column of a in column k
+    std::vector<size_t> rowPermutation;
+    std::vector<size_t> columnOrder;
+};
+
+// P A P^T = L L^T for symmetric positive definite sparse a, of which only the upper triangle
+// (x >= y) is read. The elimination tree gives the pattern of every row of L, which is then
+// computed up-looking; a failing pivot throws not_positive_definite with its row in a.
+template <typename T = real>
+class SparseLLTFactorization : public Factorization<T>
+{
+public:
+    explicit SparseLLTFactorization(const csc_matrix<T>& a, fill_ordering ordering = fill_ordering::approximate_minimum_degree);
+
+    using Factorization<T>::SolveInPlace;
+    void SolveInPlace(matrix_view<T> b) const override;
+    size_t GetSizeY() const override { return size; }
+    size_t GetSizeX() const override { return size; }
+
+    size_t GetNonZeroCount() const { return lower.GetNonZeroCount(); }
+    const csc_matrix<T>& GetLower() const { return lower; }
+
+private:
+    size_t size;
+    csc_matrix<T> lower;
+    // order[k] is the row and column of a in position k
+    std::vector<size_t> order;
+};
+
+// Sparse counterparts of the dense solvers in MatrixSolver.h, with approximate minimum degree ordering
+template <typename T>
+vector<T> solve_matrix_eq_with_lu_decomposition(const csr_matrix<T>& a, const vector<T>& b);
+template <typename T>
+vector<T> solve_matrix_eq_with_lu_decomposition(const csc_matrix<T>& a, const vector<T>& b);
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_decomposition(const csr_matrix<T>& a, const vector<T>& b);
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_decomposition(const csc_matrix<T>& a, const vector<T>& b);
+
+}
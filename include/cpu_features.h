@@ -0,0 +1,31 @@
+#pragma once
+
+// On x86 the AVX2/FMA kernels (gemm.h, transpose.h) are compiled whatever the build's target
+// flags, through function target attributes, and chosen at run time by has_avx2_fma().
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NUMERICALS_X86_KERNELS 1
+#define NUMERICALS_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#include <immintrin.h>
+#endif
+
+namespace numericals {
+
+// Whether the AVX2/FMA kernels may run: settled at compile time when the build targets them
+// (NUMERICALS_NATIVE on a capable host), asked from the CPU once otherwise.
+inline bool has_avx2_fma()
+{
+#if defined(__AVX2__) && defined(__FMA__)
+    return true;
+#elif defined(NUMERICALS_X86_KERNELS)
+    static const bool supported = []
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include "matrix_view.h"
+
+// Stack-allocated Rows x Cols matrix with compile-time dimensions, meant for the 2x2 to 8x8
+// systems where heap allocation would cost more than the arithmetic. Same row-major layout
+// and accessors as matrix<T>.
+template <typename T, size_t Rows, size_t Cols> requires std::is_arithmetic_v<T>
+class fixed_matrix
+{
+public:
+    using value_type = T;
+
+    constexpr fixed_matrix() = default;
+    constexpr fixed_matrix(std::initializer_list<T> list)
+    {
+        if(list.size() != Rows * Cols) [[unlikely]] throw std::runtime_error("Wrong matrix dimentions");
+        std::copy(list.begin(), list.end(), data.begin());
+    }
+
+    constexpr T GetElement(const size_t x, const size_t y) const { return data[x + y * Cols]; }
+    constexpr T& GetElement(const size_t x, const size_t y) { return data[x + y * Cols]; }
+
+    static constexpr size_t GetSizeY() { return Rows; }
+    static constexpr size_t GetSizeX() { return Cols; }
+
+    constexpr T* GetData() { return data.data(); }
+    constexpr const T* GetData() const { return data.data(); }
+
+    matrix_view<T> View() { return {GetData(), Cols, Rows, Cols}; }
+    matrix_view<const T> View() const { return {GetData(), Cols, Rows, Cols}; }
+    vector_view<T> Row(const size_t row, const size_t offset = 0) { return View().Row(row, offset); }
+    vector_view<const T> Row(const size_t row, const size_t offset = 0) const { return View().Row(row, offset); }
+    vector_view<T> Column(const size_t col, const size_t offset = 0) { return View().Column(col, offset); }
+    vector_view<const T> Column(const size_t col, const size_t offset = 0) const { return View().Column(col, offset); }
+
+    template <size_t OtherCols>
+    constexpr fixed_matrix<T, Rows, OtherCols> operator*(const fixed_matrix<T, Cols, OtherCols>& other) const
+    {
+        fixed_matrix<T, Rows, OtherCols> result;
+        for(size_t y = 0; y < Rows; y++)
+            for(size_t k = 0; k < Cols; k++)
+                for(size_t x = 0; x < OtherCols; x++)
+                    result.GetElement(x, y) += GetElement(k, y) * other.GetElement(x, k);
+        return result;
+    }
+
+    constexpr bool operator==(const fixed_matrix&) const = default;
+
+private:
+    std::array<T, Rows * Cols> data{};
+};
+
+template <typename T, size_t Size> requires std::is_arithmetic_v<T>
+class fixed_vector
+{
+public:
+    using value_type = T;
+
+    constexpr fixed_vector() = default;
+    constexpr fixed_vector(std::initializer_list<T> list)
+    {
+        if(list.size() != Size) [[unlikely]] throw std::runtime_error("Wrong vector size");
+        std::copy(list.begin(), list.end(), data.begin());
+    }
+
+    static constexpr size_t GetSize() { return Size; }
+
+    constexpr T& operator[](const size_t index) { return data[index]; }
+    constexpr T operator[](const size_t index) const { return data[index]; }
+
+    constexpr T* GetData() { return data.data(); }
+    constexpr const T* GetData() const { return data.data(); }
+
+    vector_view<T> View() { return {GetData(), Size}; }
+    vector_view<const T> View() const { return {GetData(), Size}; }
+
+    constexpr T operator*(const fixed_vector& other) const
+    {
+        T result = 0;
+        for(size_t i = 0; i < Size; i++)
+            result += data[i] * other[i];
+        return result;
+    }
+
+    constexpr bool operator==(const fixed_vector&) const = default;
+
+private:
+    std::array<T, Size> data{};
+};
+
+template <typename T, size_t Rows, size_t Cols>
+constexpr fixed_vector<T, Rows> operator*(const fixed_matrix<T, Rows, Cols>& a, const fixed_vector<T, Cols>& b)
+{
+    fixed_vector<T, Rows> result;
+    for(size_t y = 0; y < Rows; y++)
+        for(size_t x = 0; x < Cols; x++)
+            result[y] += a.GetElement(x, y) * b[x];
+    return result;
+}
+
+template <typename T, size_t Rows, size_t Cols>
+std::ostream& operator<< (std::ostream& stream, const fixed_matrix<T, Rows, Cols>& toPrint)
+{
+    for(size_t y = 0; y < Rows; y++)
+    {
+        for(size_t x = 0; x < Cols; x++)
+            stream << toPrint.GetElement(x, y) << '\t';
+        stream << '\n';
+    }
+    return stream;
+}
+
+template <typename T, size_t Size>
+std::ostream& operator<< (std::ostream& stream, const fixed_vector<T, Size>& toPrint)
+{
+    for(size_t i = 0; i < Size; i++)
+        stream << toPrint[i] << "\t";
+    stream << std::endl;
+    return stream;
+}
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "cpu_features.h"
+#include "storage.h"
+
+namespace numericals {
+
+// Blocking parameters of the packed GEMM: an mr x nr register tile is accumulated over kc
+// steps, A is packed in mc x kc blocks (sized for L2) and B in kc x nc panels (sized for L3).
+template <typename T>
+struct gemm_blocking
+{
+    static constexpr size_t mr = 4;
+    static constexpr size_t nr = 4;
+    static constexpr size_t mc = 64;
+    static constexpr size_t kc = 256;
+    static constexpr size_t nc = 1024;
+};
+
+#if defined(NUMERICALS_X86_KERNELS)
+// Tiles of the AVX2/FMA micro-kernels; the generic kernel runs the same tiles on CPUs without
+// them, so the packing does not depend on the dispatch.
+template <>
+struct gemm_blocking<double>
+{
+    static constexpr size_t mr = 6;
+    static constexpr size_t nr = 8;
+    static constexpr size_t mc = 72;
+    static constexpr size_t kc = 256;
+    static constexpr size_t nc = 2048;
+};
+
+template <>
+struct gemm_blocking<float>
+{
+    static constexpr size_t mr = 6;
+    static constexpr size_t nr = 16;
+    static constexpr size_t mc = 144;
+    static constexpr size_t kc = 256;
+    static constexpr size_t nc = 2048;
+};
+#endif
+
+namespace detail {
+
+constexpr size_t round_up(const size_t value, const size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Packs an mc x kc block of A into consecutive mr-row micro-panels, column by column,
+// zero-filling the rows past the edge of the matrix.
+template <typename T>
+void pack_a(const size_t mc, const size_t kc, const T* a, const ptrdiff_t rsa, const ptrdiff_t csa, T* buffer)
+{
+    constexpr size_t mr = gemm_blocking<T>::mr;
+    for(size_t ir = 0; ir < mc; ir += mr)
+    {
+        const size_t rows = std::min(mr, mc - ir);
+        for(size_t p = 0; p < kc; p++)
+            for(size_t i = 0; i < mr; i++)
+                *buffer++ = i < rows ? a[ptrdiff_t(ir + i) * rsa + ptrdiff_t(p) * csa] : T(0);
+    }
+}
+
+// Packs a kc x nc panel of B into consecutive nr-column micro-panels, row by row.
+template <typename T>
+void pack_b(const size_t kc, const size_t nc, const T* b, const ptrdiff_t rsb, const ptrdiff_t csb, T* buffer)
+{
+    constexpr size_t nr = gemm_blocking<T>::nr;
+    for(size_t jr = 0; jr < nc; jr += nr)
+    {
+        const size_t cols = std::min(nr, nc - jr);
+        for(size_t p = 0; p < kc; p++)
+            for(size_t j = 0; j < nr; j++)
+                *buffer++ = j < cols ? b[ptrdiff_t(p) * rsb + ptrdiff_t(jr + j) * csb] : T(0);
+    }
+}
+
+// ab (mr x nr, row-major) = packed A micro-panel * packed B micro-panel
+template <typename T>
+void micro_kernel(const size_t kc, const T* a, const T* b, T* ab)
+{
+    constexpr size_t mr = gemm_blocking<T>::mr;
+    constexpr size_t nr = gemm_blocking<T>::nr;
+    T acc[mr * nr] = {};
+    for(size_t p = 0; p < kc; p++, a += mr, b += nr)
+        for(size_t i = 0; i < mr; i++)
+            for(size_t j = 0; j < nr; j++)
+                acc[i * nr + j] += a[i] * b[j];
+    std::copy(acc, acc + mr * nr, ab);
+}
+
+#if defined(NUMERICALS_X86_KERNELS)
+NUMERICALS_TARGET_AVX2_FMA
+inline void micro_kernel_avx2(const size_t kc, const double* a, const double* b, double* ab)
+{
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+    for(size_t p = 0; p < kc; p++, a += 6, b += 8)
+    {
+        const __m256d b0 = _mm256_load_pd(b);
+        const __m256d b1 = _mm256_load_pd(b + 4);
+        __m256d ai = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+        ai = _mm256_broadcast_sd(a + 4);
+        c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+        ai = _mm256_broadcast_sd(a + 5);
+        c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+    }
+
+    _mm256_storeu_pd(ab +  0, c00); _mm256_storeu_pd(ab +  4, c01);
+    _mm256_storeu_pd(ab +  8, c10); _mm256_storeu_pd(ab + 12, c11);
+    _mm256_storeu_pd(ab + 16, c20); _mm256_storeu_pd(ab + 20, c21);
+    _mm256_storeu_pd(ab + 24, c30); _mm256_storeu_pd(ab + 28, c31);
+    _mm256_storeu_pd(ab + 32, c40); _mm256_storeu_pd(ab + 36, c41);
+    _mm256_storeu_pd(ab + 40, c50); _mm256_storeu_pd(ab + 44, c51);
+}
+
+NUMERICALS_TARGET_AVX2_FMA
+inline void micro_kernel_avx2(const size_t kc, const float* a, const float* b, float* ab)
+{
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+    for(size_t p = 0; p < kc; p++, a += 6, b += 16)
+    {
+        const __m256 b0 = _mm256_load_ps(b);
+        const __m256 b1 = _mm256_load_ps(b + 8);
+        __m256 ai = _mm256_broadcast_ss(a);
+        c00 = _mm256_fmadd_ps(ai, b0, c00); c01 = _mm256_fmadd_ps(ai, b1, c01);
+        ai = _mm256_broadcast_ss(a + 1);
+        c10 = _mm256_fmadd_ps(ai, b0, c10); c11 = _mm256_fmadd_ps(ai, b1, c11);
+        ai = _mm256_broadcast_ss(a + 2);
+        c20 = _mm256_fmadd_ps(ai, b0, c20); c21 = _mm256_fmadd_ps(ai, b1, c21);
+        ai = _mm256_broadcast_ss(a + 3);
+        c30 = _mm256_fmadd_ps(ai, b0, c30); c31 = _mm256_fmadd_ps(ai, b1, c31);
+        ai = _mm256_broadcast_ss(a + 4);
+        c40 = _mm256_fmadd_ps(ai, b0, c40); c41 = _mm256_fmadd_ps(ai, b1, c41);
+        ai = _mm256_broadcast_ss(a + 5);
+        c50 = _mm256_fmadd_ps(ai, b0, c50); c51 = _mm256_fmadd_ps(ai, b1, c51);
+    }
+
+    _mm256_storeu_ps(ab +  0, c00); _mm256_storeu_ps(ab +  8, c01);
+    _mm256_storeu_ps(ab + 16, c10); _mm256_storeu_ps(ab + 24, c11);
+    _mm256_storeu_ps(ab + 32, c20); _mm256_storeu_ps(ab + 40, c21);
+    _mm256_storeu_ps(ab + 48, c30); _mm256_storeu_ps(ab + 56, c31);
+    _mm256_storeu_ps(ab + 64, c40); _mm256_storeu_ps(ab + 72, c41);
+    _mm256_storeu_ps(ab + 80, c50); _mm256_storeu_ps(ab + 88, c51);
+}
+
+inline void micro_kernel(const size_t kc, const double* a, const double* b, double* ab)
+{
+    if(has_avx2_fma()) micro_kernel_avx2(kc, a, b, ab);
+    else micro_kernel<double>(kc, a, b, ab);
+}
+
+inline void micro_kernel(const size_t kc, const float* a, const float* b, float* ab)
+{
+    if(has_avx2_fma()) micro_kernel_avx2(kc, a, b, ab);
+    else micro_kernel<float>(kc, a, b, ab);
+}
+#endif
+
+}
+
+// C = alpha * A * B + beta * C, where A is m x k, B is k x n and C is m x n.
+// Every operand is addressed through a (row stride, column stride) pair, so transposed
+// or strided operands are handled by the packing routines at no extra cost.
+// When beta is zero C is never read.
+template <typename T>
+void gemm(const size_t m, const size_t n, const size_t k, const T alpha,
+          const T* a, const ptrdiff_t rsa, const ptrdiff_t csa,
+          const T* b, const ptrdiff_t rsb, const ptrdiff_t csb,
+          const T beta, T* c, const ptrdiff_t rsc, const ptrdiff_t csc)
+{
+    using blocking = gemm_blocking<T>;
+    constexpr size_t mr = blocking::mr;
+    constexpr size_t nr = blocking::nr;
+
+    if(m == 0 || n == 0) return;
+    if(k == 0 || alpha == T(0))
+    {
+        for(size_t i = 0; i < m; i++)
+            for(size_t j = 0; j < n; j++)
+            {
+                T& cij = c[ptrdiff_t(i) * rsc + ptrdiff_t(j) * csc];
+                cij = beta == T(0) ? T(0) : beta * cij;
+            }
+        return;
+    }
+
+    const size_t mcMax = std::min(blocking::mc, detail::round_up(m, mr));
+    const size_t kcMax = std::min(blocking::kc, k);
+    const size_t ncMax = std::min(blocking::nc, detail::round_up(n, nr));
+    // Every packed B row is nr elements (one cache line for the AVX kernels), so the
+    // micro-kernel can use aligned loads.
+    std::vector<T, aligned_allocator<T>> packedA(mcMax * kcMax);
+    std::vector<T, aligned_allocator<T>> packedB(kcMax * ncMax);
+    alignas(64) T ab[mr * nr];
+
+    for(size_t jc = 0; jc < n; jc += blocking::nc)
+    {
+        const size_t nb = std::min(blocking::nc, n - jc);
+        for(size_t pc = 0; pc < k; pc += blocking::kc)
+        {
+            const size_t kb = std::min(blocking::kc, k - pc);
+            const T betaBlock = pc == 0 ? beta : T(1);
+            detail::pack_b(kb, nb, b + ptrdiff_t(pc) * rsb + ptrdiff_t(jc) * csb, rsb, csb, packedB.data());
+
+            for(size_t ic = 0; ic < m; ic += blocking::mc)
+            {
+                const size_t mb = std::min(blocking::mc, m - ic);
+                detail::pack_a(mb, kb, a + ptrdiff_t(ic) * rsa + ptrdiff_t(pc) * csa, rsa, csa, packedA.data());
+
+                for(size_t jr = 0; jr < nb; jr += nr)
+                {
+                    const size_t cols = std::min(nr, nb - jr);
+                    for(size_t ir = 0; ir < mb; ir += mr)
+                    {
+                        const size_t rows = std::min(mr, mb - ir);
+                        detail::micro_kernel(kb, packedA.data() + ir * kb, packedB.data() + jr * kb, ab);
+
+                        T* tile = c + ptrdiff_t(ic + ir) * rsc + ptrdiff_t(jc + jr) * csc;
+                        for(size_t i = 0; i < rows; i++)
+                            for(size_t j = 0; j < cols; j++)
+                            {
+                                T& cij = tile[ptrdiff_t(i) * rsc + ptrdiff_t(j) * csc];
+                                cij = (betaBlock == T(0) ? T(0) : betaBlock * cij) + alpha * ab[i * nr + j];
+                            }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
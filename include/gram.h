@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "gemm.h"
+#include "matrix_view.h"
+#include "parallel.h"
+#include "storage.h"
+
+namespace numericals {
+
+template <typename T>
+struct gram_blocking
+{
+    // up to this many columns the product is accumulated row by row in a single sweep over A
+    static constexpr size_t narrow = 96;
+    // rows accumulated into a block sum before it is added to the running total
+    static constexpr size_t rows = 256;
+    // least number of rows worth handing to a separate thread
+    static constexpr size_t rows_per_thread = 8192;
+    // edge of the output tiles computed by gemm for wide matrices
+    static constexpr size_t tile = 128;
+};
+
+// Writes the upper triangle (x >= y) of A^T A into c and, when b is not null, A^T b into atb;
+// nothing below the diagonal of c is written. Tall-skinny A (up to gram_blocking::narrow
+// columns) is read in a single sweep: rows are split between threads, each accumulating rank-1
+// updates of its rows and of b into a private triangle, and the partial results are reduced.
+// Wide A is handled by gemm calls on the upper tiles of the result, spread over the threads,
+// which read each column block of A once per tile; the thread of a diagonal tile also forms the
+// matching part of A^T b, so b takes no pass of its own.
+template <typename T>
+void gram_upper(const std::type_identity_t<matrix_view<const T>>& a, const T* b, const matrix_view<T>& c, T* atb,
+                size_t threads = get_num_threads())
+{
+    using blocking = gram_blocking<T>;
+    const size_t m = a.GetSizeY();
+    const size_t n = a.GetSizeX();
+    const ptrdiff_t lda = a.GetLeadingDimension();
+
+    if(n > blocking::narrow)
+    {
+        scratch_vector<std::pair<size_t, size_t>> tiles;
+        for(size_t ib = 0; ib < n; ib += blocking::tile)
+            for(size_t jb = ib; jb < n; jb += blocking::tile)
+                tiles.emplace_back(ib, jb);
+
+        parallel_for(0, tiles.size(), threads_for(tiles.size(), threads), [&](const size_t first, const size_t last, size_t)
+        {
+            scratch_vector<T> scratch;
+            for(size_t t = first; t < last; t++)
+            {
+                const auto [ib, jb] = tiles[t];
+                const size_t bi = std::min(blocking::tile, n - ib);
+                const size_t bj = std::min(blocking::tile, n - jb);
+                if(ib != jb)
+                {
+                    gemm<T>(bi, bj, m, T(1), a.GetData() + ib, 1, lda, a.GetData() + jb, lda, 1,
+                            T(0), &c.GetElement(jb, ib), c.GetLeadingDimension(), 1);
+                    continue;
+                }
+
+                scratch.resize(bi * bi);
+                gemm<T>(bi, bi, m, T(1), a.GetData() + ib, 1, lda, a.GetData() + ib, lda, 1,
+                        T(0), scratch.data(), ptrdiff_t(bi), 1);
+                for(size_t y = 0; y < bi; y++)
+                    for(size_t x = y; x < bi; x++)
+                        c.GetElement(ib + x, ib + y) = scratch[y * bi + x];
+                if(b)
+                    gemm<T>(bi, 1, m, T(1), a.GetData() + ib, 1, lda, b, 1, 1, T(0), atb + ib, 1, 1);
+            }
+        });
+        return;
+    }
+
+    const size_t stride = n * n + n;
+    threads = threads_for(m / blocking::rows_per_thread, threads);
+    scratch_vector<T> partial(threads * stride, T(0));
+
+    parallel_for(0, m, threads, [&](const size_t first, const size_t last, const size_t index)
+    {
+        T* total = partial.data() + index * stride;
+        scratch_vector<T> block(stride);
+        for(size_t r0 = first; r0 < last; r0 += blocking::rows)
+        {
+            std::fill(block.begin(), block.end(), T(0));
+            T* blockRhs = block.data() + n * n;
+            const size_t r1 = std::min(last, r0 + blocking::rows);
+            for(size_t r = r0; r < r1; r++)
+            {
+                const T* row = a.GetData() + ptrdiff_t(r) * lda;
+                for(size_t i = 0; i < n; i++)
+                {
+                    const T ai = row[i];
+                    T* gi = block.data() + i * n;
+                    for(size_t j = i; j < n; j++)
+                        gi[j] += ai * row[j];
+                    if(b) blockRhs[i] += ai * b[r];
+                }
+            }
+            for(size_t i = 0; i < stride; i++)
+                total[i] += block[i];
+        }
+    });
+
+    for(size_t i = 0; i < n; i++)
+    {
+        for(size_t j = i; j < n; j++)
+        {
+            T sum = T(0);
+            for(size_t t = 0; t < threads; t++)
+                sum += partial[t * stride + i * n + j];
+            c.GetElement(j, i) = sum;
+        }
+        if(b)
+        {
+            T sum = T(0);
+            for(size_t t = 0; t < threads; t++)
+                sum += partial[t * stride + n * n + i];
+            atb[i] = sum;
+        }
+    }
+}
+
+// C += alpha A A^T on the lower triangle (x <= y) of the n x n matrix c, A being n x k; elements
+// above the diagonal are never touched. Tiles strictly below the diagonal are single gemm calls,
+// diagonal tiles go through a scratch product, and the tiles are spread over the threads.
+template <typename T>
+void syrk_lower(const size_t n, const size_t k, const T alpha, const T* a, const ptrdiff_t rsa, const ptrdiff_t csa,
+                T* c, const ptrdiff_t rsc, const ptrdiff_t csc, const size_t threads = get_num_threads())
+{
+    using blocking = gram_blocking<T>;
+    scratch_vector<std::pair<size_t, size_t>> tiles;
+    for(size_t ib = 0; ib < n; ib += blocking::tile)
+        for(size_t jb = 0; jb <= ib; jb += blocking::tile)
+            tiles.emplace_back(ib, jb);
+
+    parallel_for(0, tiles.size(), threads_for(tiles.size(), threads), [&](const size_t first, const size_t last, size_t)
+    {
+        scratch_vector<T> scratch;
+        for(size_t t = first; t < last; t++)
+        {
+            const auto [ib, jb] = tiles[t];
+            const size_t bi = std::min(blocking::tile, n - ib);
+            const size_t bj = std::min(blocking::tile, n - jb);
+            if(ib != jb)
+            {
+                gemm<T>(bi, bj, k, alpha, a + ptrdiff_t(ib) * rsa, rsa, csa, a + ptrdiff_t(jb) * rsa, csa, rsa,
+                        T(1), c + ptrdiff_t(ib) * rsc + ptrdiff_t(jb) * csc, rsc, csc);
+                continue;
+            }
+
+            scratch.resize(bi * bi);
+            gemm<T>(bi, bi, k, alpha, a + ptrdiff_t(ib) * rsa, rsa, csa, a + ptrdiff_t(ib) * rsa, csa, rsa,
+                    T(0), scratch.data(), ptrdiff_t(bi), 1);
+            for(size_t y = 0; y < bi; y++)
+                for(size_t x = 0; x <= y; x++)
+                    c[ptrdiff_t(ib + y) * rsc + ptrdiff_t(ib + x) * csc] += scratch[y * bi + x];
+        }
+    });
+}
+
+// Copies the upper triangle of a square matrix into its lower triangle.
+template <typename T>
+void mirror_upper(const matrix_view<T>& c)
+{
+    for(size_t y = 0; y < c.GetSizeY(); y++)
+        for(size_t x = y + 1; x < c.GetSizeX(); x++)
+            c.GetElement(y, x) = c.GetElement(x, y);
+}
+
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+#include <vector>
+#include "storage.h"
+
+// Hot-path instrumentation of the dense solvers and decompositions (MatrixSolver.cpp,
+// MatrixDecomposer.cpp). Configured with -DNUMERICALS_INSTRUMENTATION=ON, every instrumented
+// call appends a call_statistics to the sink of the calling thread; otherwise the hooks below
+// expand to nothing and the sink stays empty.
+
+namespace numericals {
+
+enum class solver_phase
+{
+    // elimination and the updates of the decompositions
+    factorization,
+    // looking for the pivot of an elimination step
+    pivot_search,
+    // exchanging rows or columns for a pivot, and undoing column exchanges on the solution
+    swaps,
+    // triangular solves and applying the factors to the right-hand side
+    substitution,
+    count
+};
+
+const char* to_string(solver_phase phase);
+
+// What one call did. Flops and bytes follow the operation-count model of the algorithm (bytes
+// being the matrix and vector elements it reads and writes once per pass) rather than being
+// counted operation by operation. Nested instrumented calls are recorded on their own and
+// also added into the call that made them, allocations included.
+struct call_statistics
+{
+    const char* function = "";
+    size_t size = 0;
+    // number of instrumented calls this one is nested in
+    size_t depth = 0;
+    std::chrono::nanoseconds time{0};
+    std::array<std::chrono::nanoseconds, size_t(solver_phase::count)> phase_time{};
+    double flops = 0.0;
+    double bytes = 0.0;
+    size_t pivot_swaps = 0;
+    // heap allocations through aligned_allocator (see heap_allocation_count)
+    size_t allocations = 0;
+    // smallest absolute pivot divided by, infinity if there was none
+    double min_pivot = std::numeric_limits<double>::infinity();
+
+    std::chrono::nanoseconds GetPhaseTime(const solver_phase phase) const { return phase_time[size_t(phase)]; }
+};
+
+namespace detail {
+class instrumented_call;
+class phase_timer;
+}
+
+// Per-thread record of the instrumented calls, in the order they started
+class instrumentation_sink
+{
+public:
+    static instrumentation_sink& ThreadLocal()
+    {
+        thread_local instrumentation_sink sink;
+        return sink;
+    }
+
+    const std::vector<call_statistics>& GetCalls() const { return calls; }
+    // every call of function summed up, with the smallest pivot of any of them
+    call_statistics Summarize(std::string_view function) const;
+    // one line per call, nested calls indented
+    void Dump(std::FILE* file = stdout) const;
+    // not from inside an instrumented call
+    void Clear() { calls.clear(); }
+
+    // the innermost call still running on this thread, nullptr if none
+    call_statistics* GetCurrent() { return open.empty() ? nullptr : &calls[open.back()]; }
+
+private:
+    friend class detail::instrumented_call;
+    friend class detail::phase_timer;
+
+    std::vector<call_statistics> calls;
+    // indices into calls of the calls still running, innermost last
+    std::vector<size_t> open;
+};
+
+namespace detail {
+
+// Records the enclosing function call from construction to destruction
+class instrumented_call
+{
+public:
+    instrumented_call(const char* function, const size_t size)
+        : sink(instrumentation_sink::ThreadLocal()), index(sink.calls.size()),
+          allocations(heap_allocation_count), start(std::chrono::steady_clock::now())
+    {
+        call_statistics& call = sink.calls.emplace_back();
+        call.function = function;
+        call.size = size;
+        call.depth = sink.open.size();
+        sink.open.push_back(index);
+    }
+    instrumented_call(const instrumented_call&) = delete;
+    instrumented_call& operator=(const instrumented_call&) = delete;
+    ~instrumented_call();
+
+private:
+    instrumentation_sink& sink;
+    size_t index;
+    size_t allocations;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Adds the time until the end of the scope to a phase of the current call; nothing outside of one.
+// Keeps an index rather than a pointer, as calls nested meanwhile may move the records.
+class phase_timer
+{
+public:
+    explicit phase_timer(const solver_phase phase)
+        : sink(instrumentation_sink::ThreadLocal()), phase(phase)
+    {
+        if(sink.open.empty()) return;
+        index = sink.open.back();
+        start = std::chrono::steady_clock::now();
+    }
+    phase_timer(const phase_timer&) = delete;
+    phase_timer& operator=(const phase_timer&) = delete;
+    ~phase_timer()
+    {
+        if(index != none) sink.calls[index].phase_time[size_t(phase)] += std::chrono::steady_clock::now() - start;
+    }
+
+private:
+    static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+    instrumentation_sink& sink;
+    solver_phase phase;
+    size_t index = none;
+    std::chrono::steady_clock::time_point start;
+};
+
+inline void count_work(const double flops, const double bytes)
+{
+    if(call_statistics* call = instrumentation_sink::ThreadLocal().GetCurrent())
+    {
+        call->flops += flops;
+        call->bytes += bytes;
+    }
+}
+
+inline void count_pivot_swap()
+{
+    if(call_statistics* call = instrumentation_sink::ThreadLocal().GetCurrent())
+        call->pivot_swaps++;
+}
+
+template <typename T>
+void observe_pivot(const T pivot)
+{
+    if(call_statistics* call = instrumentation_sink::ThreadLocal().GetCurrent())
+        call->min_pivot = std::min(call->min_pivot, double(std::abs(pivot)));
+}
+
+}
+
+}
+
+#define NUMERICALS_INSTRUMENTATION_CONCAT_(a, b) a##b
+#define NUMERICALS_INSTRUMENTATION_CONCAT(a, b) NUMERICALS_INSTRUMENTATION_CONCAT_(a, b)
+
+#ifdef NUMERICALS_INSTRUMENTATION
+// Records the enclosing function under name, for a problem of the given size
+#define NUMERICALS_INSTRUMENT_CALL(name, size) \
+    const ::numericals::detail::instrumented_call NUMERICALS_INSTRUMENTATION_CONCAT(instrumented_call_, __LINE__)(name, size)
+// Times the rest of the enclosing scope as a solver_phase of the current call
+#define NUMERICALS_INSTRUMENT_PHASE(phase) \
+    const ::numericals::detail::phase_timer NUMERICALS_INSTRUMENTATION_CONCAT(phase_timer_, __LINE__)(::numericals::solver_phase::phase)
+#define NUMERICALS_COUNT_WORK(flops, bytes) ::numericals::detail::count_work(flops, bytes)
+#define NUMERICALS_COUNT_PIVOT_SWAP() ::numericals::detail::count_pivot_swap()
+#define NUMERICALS_OBSERVE_PIVOT(pivot) ::numericals::detail::observe_pivot(pivot)
+#else
+#define NUMERICALS_INSTRUMENT_CALL(name, size) static_cast<void>(0)
+#define NUMERICALS_INSTRUMENT_PHASE(phase) static_cast<void>(0)
+// sizeof keeps the arguments used without evaluating them
+#define NUMERICALS_COUNT_WORK(flops, bytes) static_cast<void>(sizeof((flops) + (bytes)))
+#define NUMERICALS_COUNT_PIVOT_SWAP() static_cast<void>(0)
+#define NUMERICALS_OBSERVE_PIVOT(pivot) static_cast<void>(sizeof(pivot))
+#endif
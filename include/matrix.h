@@ -4,112 +4,167 @@
 #include <ostream>
 #include <stdexcept>
 #include <valarray>
+#include "gemm.h"
+#include "matrix_expression.h"
+#include "matrix_view.h"
+#include "numerical_types.h"
+#include "storage.h"
+#include "transpose.h"
 #include "vector.h"
 
-template <typename T> requires std::is_arithmetic_v<T>
+// Row-major matrix over a storage policy (see storage.h). Rows are GetLeadingDimension()
+// elements apart, which is more than GetSizeX() for padded storage.
+template <typename T, typename Storage> requires std::is_arithmetic_v<T>
 class matrix
 {
 public:
-    matrix(const size_t size_x, const size_t size_y) : data(size_y * size_x), size_y(size_y), size_x(size_x) {}
-    matrix(const size_t size_x, const size_t size_y, std::initializer_list<T> list) : data(list), size_y(size_y), size_x(size_x) 
+    using value_type = T;
+    using storage_type = Storage;
+
+    template <typename... Args> requires std::constructible_from<Storage, size_t, size_t, Args...>
+    matrix(const size_t size_x, const size_t size_y, Args&&... storageArgs)
+        : storage(size_y, size_x, std::forward<Args>(storageArgs)...), size_y(size_y), size_x(size_x) {}
+
+    matrix(const size_t size_x, const size_t size_y, std::initializer_list<T> list) : matrix(size_x, size_y)
     {
-        if(size_y * size_x != list.size()) [[unlikely]] std::runtime_error("Wrong matrix dimentions");
+        if(size_y * size_x != list.size()) [[unlikely]] throw std::runtime_error("Wrong matrix dimentions");
+        auto it = list.begin();
+        for(size_t y = 0; y < size_y; y++)
+            for(size_t x = 0; x < size_x; x++)
+                GetElement(x, y) = *it++;
     }
 
-    std::valarray<T> GetRow(const size_t row, const size_t offset = 0) const        
-    { 
-        return data[std::slice(row * size_x + offset, size_x - offset, 1)]; 
+    template <typename OtherStorage> requires (!std::is_same_v<OtherStorage, Storage>)
+    explicit matrix(const matrix<T, OtherStorage>& other) : matrix(other.GetSizeX(), other.GetSizeY())
+    {
+        for(size_t y = 0; y < size_y; y++)
+            Row(y) = other.Row(y);
     }
 
-    std::valarray<T> GetColumn(const size_t col, const size_t offset = 0) const     
-    { 
-        return data[std::slice(col + offset * size_x, size_y - offset, size_x)]; 
+    template <matrix_expression_node E> requires std::is_same_v<typename E::value_type, T>
+    matrix(const E& expression) : matrix(expression.GetSizeX(), expression.GetSizeY())
+    {
+        expression.EvaluateTo(View());
     }
 
-    std::slice_array<T> GetColumnSlice(const size_t col, const size_t offset = 0)   
-    { 
-        return data[std::slice(col + offset * size_x, size_y - offset, size_x)]; 
+    template <matrix_expression_node E> requires std::is_same_v<typename E::value_type, T>
+    matrix& operator=(const E& expression)
+    {
+        if(GetSizeX() != expression.GetSizeX() || GetSizeY() != expression.GetSizeY() || 
+           expression.Aliases(GetData(), GetData() + storage.GetSize()))
+            return *this = matrix(expression);
+
+        expression.EvaluateTo(View());
+        return *this;
     }
 
-    std::slice_array<T> GetRowSlice(const size_t row, const size_t offset = 0)      
+    std::valarray<T> GetRow(const size_t row, const size_t offset = 0) const        
     { 
-        return data[std::slice(row * size_x + offset, size_x - offset, 1)]; 
+        return Row(row, offset); 
     }
 
-    const std::slice_array<T> GetColumnSlice(const size_t col, const size_t offset = 0) const  
+    std::valarray<T> GetColumn(const size_t col, const size_t offset = 0) const     
     { 
-        return data[std::slice(col + offset * size_x, size_y - offset, size_x)]; 
+        return Column(col, offset); 
     }
 
-    const std::slice_array<T> GetRowSlice(const size_t row, const size_t offset = 0) const      
-    { 
-        return data[std::slice(row * size_x + offset, size_x - offset, 1)]; 
+    vector_view<T> GetColumnSlice(const size_t col, const size_t offset = 0) { return Column(col, offset); }
+    vector_view<T> GetRowSlice(const size_t row, const size_t offset = 0) { return Row(row, offset); }
+    vector_view<const T> GetColumnSlice(const size_t col, const size_t offset = 0) const { return Column(col, offset); }
+    vector_view<const T> GetRowSlice(const size_t row, const size_t offset = 0) const { return Row(row, offset); }
+
+    vector_view<T> Row(const size_t row, const size_t offset = 0) { return View().Row(row, offset); }
+    vector_view<const T> Row(const size_t row, const size_t offset = 0) const { return View().Row(row, offset); }
+    vector_view<T> Column(const size_t col, const size_t offset = 0) { return View().Column(col, offset); }
+    vector_view<const T> Column(const size_t col, const size_t offset = 0) const { return View().Column(col, offset); }
+
+    matrix_view<T> Block(const size_t x, const size_t y, const size_t block_size_x, const size_t block_size_y)
+    {
+        return View().Block(x, y, block_size_x, block_size_y);
     }
 
+    matrix_view<const T> Block(const size_t x, const size_t y, const size_t block_size_x, const size_t block_size_y) const
+    {
+        return View().Block(x, y, block_size_x, block_size_y);
+    }
+
+    matrix_view<T> View() { return {GetData(), size_x, size_y, GetLeadingDimension()}; }
+    matrix_view<const T> View() const { return {GetData(), size_x, size_y, GetLeadingDimension()}; }
+
     matrix<T> Transposed() const
     {
         matrix<T> result{GetSizeY(), GetSizeX()};
-        for(size_t i = 0; i < GetSizeX(); i++)
-            result.GetRowSlice(i) = GetColumn(i);
-        
+        numericals::transpose_copy(GetData(), GetLeadingDimension(), GetSizeY(), GetSizeX(), result.GetData(), result.GetLeadingDimension());
         return result;
     }
 
-    T GetElement(const size_t x, const size_t y) const { return data[x + y * size_x]; }
-    T& GetElement(const size_t x, const size_t y) { return data[x + y * size_x]; }
-    T GetElement(const size_t i) const { return data[i]; }
-    T& GetElement(const size_t i) { return data[i]; }
+    // Square matrices are transposed without a second buffer
+    void TransposeInPlace() requires std::constructible_from<Storage, size_t, size_t>
+    {
+        if(GetSizeX() != GetSizeY())
+        {
+            *this = matrix(transpose(*this));
+            return;
+        }
+        numericals::transpose_in_place(GetData(), GetLeadingDimension(), GetSizeX());
+    }
 
+    T GetElement(const size_t x, const size_t y) const { return GetData()[x + y * GetLeadingDimension()]; }
+    T& GetElement(const size_t x, const size_t y) { return GetData()[x + y * GetLeadingDimension()]; }
+    // Element i in row-major order, skipping any row padding
+    T GetElement(const size_t i) const { return IsContiguous() ? GetData()[i] : GetElement(i % size_x, i / size_x); }
+    T& GetElement(const size_t i) { return IsContiguous() ? GetData()[i] : GetElement(i % size_x, i / size_x); }
+
+    T* GetData() { return storage.GetData(); }
+    const T* GetData() const { return storage.GetData(); }
+    ptrdiff_t GetLeadingDimension() const { return ptrdiff_t(storage.GetLeadingDimension()); }
+    bool IsContiguous() const { return storage.GetLeadingDimension() == size_x; }
+    const Storage& GetStorage() const { return storage; }
 
     size_t GetSizeY() const { return size_y; }
     size_t GetSizeX() const { return size_x; }
    
-    auto begin() { return data.begin(); }
-    auto end() { return data.end(); }
-    auto begin() const { return data.begin(); }
-    auto end() const { return data.end(); }
+    // Iterate the underlying storage, row padding included
+    T* begin() { return GetData(); }
+    T* end() { return GetData() + storage.GetSize(); }
+    const T* begin() const { return GetData(); }
+    const T* end() const { return GetData() + storage.GetSize(); }
     
-    vector<T> operator*(const vector<T>& other)
+    template <typename S>
+    vector<T> operator*(const vector<T, S>& other) const
     {
-        if(GetSizeX() != other.GetSize()) [[unlikely]] std::runtime_error("Wrong matrices dimensions on multiplication operator");
+        if(GetSizeX() != other.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrices dimensions on multiplication operator");
         vector<T> result = vector<T>(GetSizeY());
         for(size_t i = 0; i < GetSizeY(); i++)
-        {   
-            result[i] = 0.0;
-            for(size_t j = 0; j < GetSizeX(); j++)
-                result[i] += GetElement(j, i) * other[j];
-        }
+            result[i] = dot(Row(i), other.View());
 
         return result;
     }
 
-    matrix<T> operator*(const matrix<T>& other)
+    template <typename S>
+    matrix<T> operator*(const matrix<T, S>& other) const
     {
-        if(GetSizeX() != other.GetSizeY()) [[unlikely]] std::runtime_error("Wrong matrices dimensions on multiplication operator");
+        if(GetSizeX() != other.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrices dimensions on multiplication operator");
         
         matrix<T> result{other.GetSizeX(), GetSizeY()};
-
-        for(size_t y = 0; y < GetSizeY(); y++)
-            for(size_t x = 0; x < other.GetSizeX(); x++)
-            {    
-                result.GetElement(x, y) = 0.0;
-                for(size_t i = 0; i < GetSizeX(); i++)
-                    result.GetElement(x, y) += GetElement(i, y) * other.GetElement(x, i);
-            }
+        numericals::gemm<T>(GetSizeY(), other.GetSizeX(), GetSizeX(), T(1),
+                            GetData(), GetLeadingDimension(), 1,
+                            other.GetData(), other.GetLeadingDimension(), 1,
+                            T(0), result.GetData(), result.GetLeadingDimension(), 1);
         return result;
     }
 
-    matrix<T>& operator+= (const matrix<T>& other)
+    template <typename S>
+    matrix& operator+= (const matrix<T, S>& other)
     {
-        if(GetSizeX() != other.GetSizeX() || GetSizeY() != other.GetSizeY()) [[unlikely]] std::runtime_error("Wrong matrices dimensions on multiplication operator");
+        if(GetSizeX() != other.GetSizeX() || GetSizeY() != other.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrices dimensions on addition operator");
     
-        for(size_t x = 0; x < GetSizeX(); x++)
-            for(size_t y = 0; y < GetSizeY(); y++)
-                GetElement(x, y) += other.GetElement(x, y);
+        for(size_t y = 0; y < GetSizeY(); y++)
+            Row(y) += other.Row(y);
         return *this;
     }
 
-    matrix<T> operator-()
+    matrix<T> operator-() const
     {
         matrix<T> result{GetSizeX(), GetSizeY()};
         for(size_t x = 0; x < GetSizeX(); x++)
@@ -120,14 +175,14 @@ public:
     }
 
 private:
-    std::valarray<T> data;
+    Storage storage;
     size_t size_y;
     size_t size_x;
 
 };
 
-template <typename T> requires std::is_arithmetic_v<T>
-std::ostream& operator<< (std::ostream& stream, matrix<T> toPrint)
+template <typename T, typename S> requires std::is_arithmetic_v<T>
+std::ostream& operator<< (std::ostream& stream, const matrix<T, S>& toPrint)
 {
     for(size_t y = 0; y < toPrint.GetSizeY(); y++)
     {
@@ -138,4 +193,3 @@ std::ostream& operator<< (std::ostream& stream, matrix<T> toPrint)
 
     return stream;
 }
-
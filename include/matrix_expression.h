@@ -0,0 +1,492 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include "gemm.h"
+#include "gram.h"
+#include "matrix_view.h"
+#include "numerical_types.h"
+#include "transpose.h"
+
+// Expression templates over matrix<T> and vector<T>. Arithmetic on expressions builds a tree
+// of lightweight nodes that is evaluated only when assigned to a matrix or vector: element-wise
+// chains are fused into a single pass, transposes only swap strides, and products are handed
+// straight to gemm with the destination as output (transpose(x) * x goes to the symmetric
+// gram_upper kernel instead).
+//
+//     matrix<real> normal = transpose(a) * a;   // one gemm call, no transposed copy
+//     vector<real> rhs    = transpose(a) * b;   // column sweep over a, no transposed copy
+//
+// Leaves reference the operands, so an expression must be evaluated before they go away.
+
+struct matrix_expression_tag {};
+struct vector_expression_tag {};
+
+template <typename E>
+concept matrix_expression_node = std::derived_from<E, matrix_expression_tag>;
+
+template <typename E>
+concept vector_expression_node = std::derived_from<E, vector_expression_tag>;
+
+template <typename M> struct is_plain_matrix : std::false_type {};
+template <typename T, typename S> struct is_plain_matrix<matrix<T, S>> : std::true_type {};
+template <typename T> struct is_plain_matrix<matrix_view<T>> : std::true_type {};
+
+template <typename V> struct is_plain_vector : std::false_type {};
+template <typename T, typename S> struct is_plain_vector<vector<T, S>> : std::true_type {};
+template <typename T> struct is_plain_vector<vector_view<T>> : std::true_type {};
+
+template <typename M>
+concept matrix_operand = matrix_expression_node<M> || is_plain_matrix<M>::value;
+
+template <typename V>
+concept vector_operand = vector_expression_node<V> || is_plain_vector<V>::value;
+
+// Strided, read-only reference to matrix storage: element (x, y) lives at
+// data[y * row_stride + x * column_stride]. Transposing only swaps the strides.
+template <typename T>
+class matrix_ref : public matrix_expression_tag
+{
+public:
+    using value_type = T;
+
+    matrix_ref(const T* data, const size_t size_x, const size_t size_y, const ptrdiff_t row_stride, const ptrdiff_t column_stride)
+        : data(data), size_y(size_y), size_x(size_x), row_stride(row_stride), column_stride(column_stride) {}
+
+    matrix_ref(const matrix_view<const T>& view)
+        : matrix_ref(view.GetData(), view.GetSizeX(), view.GetSizeY(), view.GetLeadingDimension(), 1) {}
+
+    size_t GetSizeY() const { return size_y; }
+    size_t GetSizeX() const { return size_x; }
+    const T* GetData() const { return data; }
+    ptrdiff_t GetRowStride() const { return row_stride; }
+    ptrdiff_t GetColumnStride() const { return column_stride; }
+
+    T GetElement(const size_t x, const size_t y) const { return data[ptrdiff_t(y) * row_stride + ptrdiff_t(x) * column_stride]; }
+
+    matrix_ref Transposed() const { return {data, size_y, size_x, column_stride, row_stride}; }
+
+    bool Aliases(const T* begin, const T* end) const
+    {
+        if(size_x == 0 || size_y == 0) return false;
+        const T* last = data + ptrdiff_t(size_y - 1) * row_stride + ptrdiff_t(size_x - 1) * column_stride;
+        return std::min(data, last) < end && begin <= std::max(data, last);
+    }
+
+    void EvaluateTo(const matrix_view<T>& dest) const
+    {
+        if(row_stride == 1 && column_stride > 0)
+        {
+            numericals::transpose_copy(data, column_stride, size_x, size_y, dest.GetData(), dest.GetLeadingDimension());
+            return;
+        }
+        for(size_t y = 0; y < size_y; y++)
+            for(size_t x = 0; x < size_x; x++)
+                dest.GetElement(x, y) = GetElement(x, y);
+    }
+
+private:
+    const T* data;
+    size_t size_y;
+    size_t size_x;
+    ptrdiff_t row_stride;
+    ptrdiff_t column_stride;
+};
+
+template <matrix_expression_node E>
+const E& as_expression(const E& expression) { return expression; }
+
+template <typename T, typename S>
+matrix_ref<T> as_expression(const matrix<T, S>& mat) { return mat.View(); }
+
+template <typename T>
+matrix_ref<std::remove_const_t<T>> as_expression(const matrix_view<T>& view) { return matrix_view<const std::remove_const_t<T>>(view); }
+
+template <typename M>
+using matrix_expression_of = std::remove_cvref_t<decltype(as_expression(std::declval<const M&>()))>;
+
+template <matrix_expression_node E>
+void evaluate_elementwise(const E& expression, const matrix_view<typename E::value_type>& dest)
+{
+    for(size_t y = 0; y < expression.GetSizeY(); y++)
+        for(size_t x = 0; x < expression.GetSizeX(); x++)
+            dest.GetElement(x, y) = expression.GetElement(x, y);
+}
+
+// Returns a strided reference to the expression, evaluating it into storage first
+// unless it already is one.
+template <matrix_expression_node E>
+matrix_ref<typename E::value_type> as_strided(const E& expression, std::optional<matrix<typename E::value_type>>& storage)
+{
+    if constexpr(std::is_same_v<E, matrix_ref<typename E::value_type>>)
+        return expression;
+    else
+        return matrix_ref<typename E::value_type>(storage.emplace(expression).View());
+}
+
+template <matrix_expression_node E>
+class transpose_expr : public matrix_expression_tag
+{
+public:
+    using value_type = typename E::value_type;
+
+    explicit transpose_expr(const E& inner) : inner(inner) {}
+
+    size_t GetSizeY() const { return inner.GetSizeX(); }
+    size_t GetSizeX() const { return inner.GetSizeY(); }
+    value_type GetElement(const size_t x, const size_t y) const { return inner.GetElement(y, x); }
+    bool Aliases(const value_type* begin, const value_type* end) const { return inner.Aliases(begin, end); }
+    void EvaluateTo(const matrix_view<value_type>& dest) const { evaluate_elementwise(*this, dest); }
+
+private:
+    E inner;
+};
+
+template <matrix_expression_node E>
+class scale_expr : public matrix_expression_tag
+{
+public:
+    using value_type = typename E::value_type;
+
+    scale_expr(const value_type alpha, const E& inner) : alpha(alpha), inner(inner) {}
+
+    size_t GetSizeY() const { return inner.GetSizeY(); }
+    size_t GetSizeX() const { return inner.GetSizeX(); }
+    value_type GetElement(const size_t x, const size_t y) const { return alpha * inner.GetElement(x, y); }
+    bool Aliases(const value_type* begin, const value_type* end) const { return inner.Aliases(begin, end); }
+
+    void EvaluateTo(const matrix_view<value_type>& dest) const
+    {
+        if constexpr(requires { inner.EvaluateTo(dest, alpha); })
+            inner.EvaluateTo(dest, alpha);
+        else
+            evaluate_elementwise(*this, dest);
+    }
+
+private:
+    value_type alpha;
+    E inner;
+};
+
+template <matrix_expression_node L, matrix_expression_node R, typename Op>
+class binary_expr : public matrix_expression_tag
+{
+public:
+    using value_type = typename L::value_type;
+
+    binary_expr(const L& left, const R& right) : left(left), right(right)
+    {
+        if(left.GetSizeX() != right.GetSizeX() || left.GetSizeY() != right.GetSizeY()) [[unlikely]]
+            throw std::runtime_error("Wrong matrices dimensions in element-wise expression");
+    }
+
+    size_t GetSizeY() const { return left.GetSizeY(); }
+    size_t GetSizeX() const { return left.GetSizeX(); }
+    value_type GetElement(const size_t x, const size_t y) const { return Op{}(left.GetElement(x, y), right.GetElement(x, y)); }
+    bool Aliases(const value_type* begin, const value_type* end) const { return left.Aliases(begin, end) || right.Aliases(begin, end); }
+    void EvaluateTo(const matrix_view<value_type>& dest) const { evaluate_elementwise(*this, dest); }
+
+private:
+    L left;
+    R right;
+};
+
+template <matrix_expression_node L, matrix_expression_node R>
+class product_expr : public matrix_expression_tag
+{
+public:
+    using value_type = typename L::value_type;
+
+    product_expr(const L& left, const R& right) : left(left), right(right)
+    {
+        if(left.GetSizeX() != right.GetSizeY()) [[unlikely]]
+            throw std::runtime_error("Wrong matrices dimensions on multiplication operator");
+    }
+
+    size_t GetSizeY() const { return left.GetSizeY(); }
+    size_t GetSizeX() const { return right.GetSizeX(); }
+    bool Aliases(const value_type* begin, const value_type* end) const { return left.Aliases(begin, end) || right.Aliases(begin, end); }
+
+    // Only reached when the product is nested inside an element-wise expression;
+    // the product is then evaluated once and cached.
+    value_type GetElement(const size_t x, const size_t y) const
+    {
+        if(!cache) EvaluateTo(cache.emplace(GetSizeX(), GetSizeY()).View());
+        return cache->GetElement(x, y);
+    }
+
+    void EvaluateTo(const matrix_view<value_type>& dest, const value_type alpha = value_type(1)) const
+    {
+        std::optional<matrix<value_type>> leftStorage;
+        std::optional<matrix<value_type>> rightStorage;
+        const auto a = as_strided(left, leftStorage);
+        const auto b = as_strided(right, rightStorage);
+        if(b.GetColumnStride() == 1 && a.GetData() == b.GetData() &&
+           a.GetRowStride() == b.GetColumnStride() && a.GetColumnStride() == b.GetRowStride() &&
+           a.GetSizeY() == b.GetSizeX() && a.GetSizeX() == b.GetSizeY())
+        {
+            // transpose(x) * x: only the upper triangle is computed, then mirrored
+            numericals::gram_upper<value_type>(matrix_view<const value_type>(b.GetData(), b.GetSizeX(), b.GetSizeY(), b.GetRowStride()),
+                                               nullptr, dest, nullptr);
+            numericals::mirror_upper(dest);
+            if(alpha != value_type(1))
+                for(size_t y = 0; y < dest.GetSizeY(); y++)
+                    dest.Row(y) *= alpha;
+            return;
+        }
+        numericals::gemm<value_type>(GetSizeY(), GetSizeX(), a.GetSizeX(), alpha,
+                                     a.GetData(), a.GetRowStride(), a.GetColumnStride(),
+                                     b.GetData(), b.GetRowStride(), b.GetColumnStride(),
+                                     value_type(0), dest.GetData(), dest.GetLeadingDimension(), 1);
+    }
+
+private:
+    L left;
+    R right;
+    mutable std::optional<matrix<value_type>> cache;
+};
+
+template <typename T, typename S>
+matrix_ref<T> transpose(const matrix<T, S>& mat) { return as_expression(mat).Transposed(); }
+
+template <typename T>
+matrix_ref<T> transpose(const matrix_ref<T>& mat) { return mat.Transposed(); }
+
+template <matrix_expression_node E>
+transpose_expr<E> transpose(const E& expression) { return transpose_expr<E>(expression); }
+
+template <matrix_operand L, matrix_operand R>
+auto operator+(const L& left, const R& right)
+{
+    return binary_expr<matrix_expression_of<L>, matrix_expression_of<R>, std::plus<>>(as_expression(left), as_expression(right));
+}
+
+template <matrix_operand L, matrix_operand R>
+auto operator-(const L& left, const R& right)
+{
+    return binary_expr<matrix_expression_of<L>, matrix_expression_of<R>, std::minus<>>(as_expression(left), as_expression(right));
+}
+
+template <matrix_expression_node E>
+auto operator-(const E& expression)
+{
+    return scale_expr<E>(typename E::value_type(-1), expression);
+}
+
+template <matrix_operand M>
+auto operator*(const typename matrix_expression_of<M>::value_type alpha, const M& mat)
+{
+    return scale_expr<matrix_expression_of<M>>(alpha, as_expression(mat));
+}
+
+template <matrix_operand M>
+auto operator*(const M& mat, const typename matrix_expression_of<M>::value_type alpha)
+{
+    return alpha * mat;
+}
+
+template <matrix_operand M>
+auto operator/(const M& mat, const typename matrix_expression_of<M>::value_type alpha)
+{
+    return scale_expr<matrix_expression_of<M>>(typename matrix_expression_of<M>::value_type(1) / alpha, as_expression(mat));
+}
+
+// matrix * matrix between two plain matrices stays the eager member operator
+template <matrix_operand L, matrix_operand R> requires matrix_expression_node<L> || matrix_expression_node<R>
+auto operator*(const L& left, const R& right)
+{
+    return product_expr<matrix_expression_of<L>, matrix_expression_of<R>>(as_expression(left), as_expression(right));
+}
+
+template <typename T>
+class vector_ref : public vector_expression_tag
+{
+public:
+    using value_type = T;
+
+    vector_ref(const vector_view<const T>& view) : view(view) {}
+
+    size_t GetSize() const { return view.GetSize(); }
+    const T* GetData() const { return view.GetData(); }
+    ptrdiff_t GetStride() const { return view.GetStride(); }
+    T GetElement(const size_t i) const { return view[i]; }
+
+    bool Aliases(const T* begin, const T* end) const
+    {
+        if(view.GetSize() == 0) return false;
+        const T* last = &view[view.GetSize() - 1];
+        return std::min(view.GetData(), last) < end && begin <= std::max(view.GetData(), last);
+    }
+
+    void EvaluateTo(const vector_view<T>& dest) const { dest = view; }
+
+private:
+    vector_view<const T> view;
+};
+
+template <vector_expression_node E>
+const E& as_expression(const E& expression) { return expression; }
+
+template <typename T, typename S>
+vector_ref<T> as_expression(const vector<T, S>& vec) { return vec.View(); }
+
+template <typename T>
+vector_ref<std::remove_const_t<T>> as_expression(const vector_view<T>& view) { return vector_view<const std::remove_const_t<T>>(view); }
+
+template <typename V>
+using vector_expression_of = std::remove_cvref_t<decltype(as_expression(std::declval<const V&>()))>;
+
+template <vector_expression_node E>
+void evaluate_elementwise(const E& expression, const vector_view<typename E::value_type>& dest)
+{
+    for(size_t i = 0; i < expression.GetSize(); i++)
+        dest[i] = expression.GetElement(i);
+}
+
+template <vector_expression_node E>
+class vector_scale_expr : public vector_expression_tag
+{
+public:
+    using value_type = typename E::value_type;
+
+    vector_scale_expr(const value_type alpha, const E& inner) : alpha(alpha), inner(inner) {}
+
+    size_t GetSize() const { return inner.GetSize(); }
+    value_type GetElement(const size_t i) const { return alpha * inner.GetElement(i); }
+    bool Aliases(const value_type* begin, const value_type* end) const { return inner.Aliases(begin, end); }
+
+    void EvaluateTo(const vector_view<value_type>& dest) const
+    {
+        if constexpr(requires { inner.EvaluateTo(dest, alpha); })
+            inner.EvaluateTo(dest, alpha);
+        else
+            evaluate_elementwise(*this, dest);
+    }
+
+private:
+    value_type alpha;
+    E inner;
+};
+
+template <vector_expression_node L, vector_expression_node R, typename Op>
+class vector_binary_expr : public vector_expression_tag
+{
+public:
+    using value_type = typename L::value_type;
+
+    vector_binary_expr(const L& left, const R& right) : left(left), right(right)
+    {
+        if(left.GetSize() != right.GetSize()) [[unlikely]]
+            throw std::runtime_error("Wrong vector sizes in element-wise expression");
+    }
+
+    size_t GetSize() const { return left.GetSize(); }
+    value_type GetElement(const size_t i) const { return Op{}(left.GetElement(i), right.GetElement(i)); }
+    bool Aliases(const value_type* begin, const value_type* end) const { return left.Aliases(begin, end) || right.Aliases(begin, end); }
+    void EvaluateTo(const vector_view<value_type>& dest) const { evaluate_elementwise(*this, dest); }
+
+private:
+    L left;
+    R right;
+};
+
+template <matrix_expression_node M, vector_expression_node V>
+class matvec_expr : public vector_expression_tag
+{
+public:
+    using value_type = typename M::value_type;
+
+    matvec_expr(const M& mat, const V& vec) : mat(mat), vec(vec)
+    {
+        if(mat.GetSizeX() != vec.GetSize()) [[unlikely]]
+            throw std::runtime_error("Wrong matrix-vector dimensions on multiplication operator");
+    }
+
+    size_t GetSize() const { return mat.GetSizeY(); }
+    bool Aliases(const value_type* begin, const value_type* end) const { return mat.Aliases(begin, end) || vec.Aliases(begin, end); }
+
+    value_type GetElement(const size_t i) const
+    {
+        if(!cache) EvaluateTo(cache.emplace(GetSize()).View());
+        return (*cache)[i];
+    }
+
+    void EvaluateTo(const vector_view<value_type>& dest, const value_type alpha = value_type(1)) const
+    {
+        std::optional<matrix<value_type>> matStorage;
+        std::optional<vector<value_type>> vecStorage;
+        const auto a = as_strided(mat, matStorage);
+        const vector_view<const value_type> x = [&]() -> vector_view<const value_type> {
+            if constexpr(std::is_same_v<V, vector_ref<value_type>>)
+                return {vec.GetData(), vec.GetSize(), vec.GetStride()};
+            else
+                return vecStorage.emplace(vec).View();
+        }();
+
+        if(a.GetColumnStride() == 1 || a.GetRowStride() != 1)
+        {
+            for(size_t y = 0; y < a.GetSizeY(); y++)
+                dest[y] = alpha * dot(vector_view<const value_type>(a.GetData() + ptrdiff_t(y) * a.GetRowStride(), a.GetSizeX(), a.GetColumnStride()), x);
+        }
+        else
+        {
+            // columns are contiguous (a transposed row-major matrix): accumulate column by column
+            dest = value_type(0);
+            for(size_t col = 0; col < a.GetSizeX(); col++)
+                dest.AddScaled(alpha * x[col], vector_view<const value_type>(a.GetData() + ptrdiff_t(col) * a.GetColumnStride(), a.GetSizeY(), 1));
+        }
+    }
+
+private:
+    M mat;
+    V vec;
+    mutable std::optional<vector<value_type>> cache;
+};
+
+template <vector_operand L, vector_operand R>
+auto operator+(const L& left, const R& right)
+{
+    return vector_binary_expr<vector_expression_of<L>, vector_expression_of<R>, std::plus<>>(as_expression(left), as_expression(right));
+}
+
+template <vector_operand L, vector_operand R>
+auto operator-(const L& left, const R& right)
+{
+    return vector_binary_expr<vector_expression_of<L>, vector_expression_of<R>, std::minus<>>(as_expression(left), as_expression(right));
+}
+
+template <vector_expression_node E>
+auto operator-(const E& expression)
+{
+    return vector_scale_expr<E>(typename E::value_type(-1), expression);
+}
+
+template <vector_operand V>
+auto operator*(const typename vector_expression_of<V>::value_type alpha, const V& vec)
+{
+    return vector_scale_expr<vector_expression_of<V>>(alpha, as_expression(vec));
+}
+
+template <vector_operand V>
+auto operator*(const V& vec, const typename vector_expression_of<V>::value_type alpha)
+{
+    return alpha * vec;
+}
+
+template <vector_operand V>
+auto operator/(const V& vec, const typename vector_expression_of<V>::value_type alpha)
+{
+    return vector_scale_expr<vector_expression_of<V>>(typename vector_expression_of<V>::value_type(1) / alpha, as_expression(vec));
+}
+
+// matrix * vector between a plain matrix and a plain vector stays the eager member operator
+template <matrix_operand M, vector_operand V> requires matrix_expression_node<M> || vector_expression_node<V>
+auto operator*(const M& mat, const V& vec)
+{
+    return matvec_expr<matrix_expression_of<M>, vector_expression_of<V>>(as_expression(mat), as_expression(vec));
+}
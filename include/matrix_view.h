@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <valarray>
+
+// Non-owning, strided window into matrix or vector storage. Copying a view never copies
+// elements, while assigning to one writes through to the viewed storage (like std::slice_array).
+template <typename T> requires std::is_arithmetic_v<std::remove_const_t<T>>
+class vector_view
+{
+public:
+    using value_type = std::remove_const_t<T>;
+
+    vector_view(T* data, const size_t size, const ptrdiff_t stride = 1) : data(data), size(size), stride(stride) {}
+    vector_view(const vector_view& other) = default;
+
+    template <typename U> requires std::is_same_v<const U, T> && (!std::is_same_v<U, T>)
+    vector_view(const vector_view<U>& other) : data(other.GetData()), size(other.GetSize()), stride(other.GetStride()) {}
+
+    size_t GetSize() const { return size; }
+    ptrdiff_t GetStride() const { return stride; }
+    T* GetData() const { return data; }
+
+    T& operator[](const size_t index) const { return data[ptrdiff_t(index) * stride]; }
+
+    vector_view Subview(const size_t offset, const size_t count) const
+    {
+        return {data + ptrdiff_t(offset) * stride, count, stride};
+    }
+
+    const vector_view& operator=(const vector_view& other) const requires (!std::is_const_v<T>)
+    {
+        for(size_t i = 0; i < size; i++)
+            (*this)[i] = other[i];
+        return *this;
+    }
+
+    template <typename U> requires std::is_same_v<std::remove_const_t<U>, value_type>
+    const vector_view& operator=(const vector_view<U>& other) const requires (!std::is_const_v<T>)
+    {
+        for(size_t i = 0; i < size; i++)
+            (*this)[i] = other[i];
+        return *this;
+    }
+
+    const vector_view& operator=(const std::valarray<value_type>& other) const requires (!std::is_const_v<T>)
+    {
+        for(size_t i = 0; i < size; i++)
+            (*this)[i] = other[i];
+        return *this;
+    }
+
+    const vector_view& operator=(const value_type value) const requires (!std::is_const_v<T>)
+    {
+        for(size_t i = 0; i < size; i++)
+            (*this)[i] = value;
+        return *this;
+    }
+
+    const vector_view& operator*=(const value_type value) const requires (!std::is_const_v<T>)
+    {
+        for(size_t i = 0; i < size; i++)
+            (*this)[i] *= value;
+        return *this;
+    }
+
+    const vector_view& operator/=(const value_type value) const requires (!std::is_const_v<T>)
+    {
+        for(size_t i = 0; i < size; i++)
+            (*this)[i] /= value;
+        return *this;
+    }
+
+    template <typename U> requires std::is_same_v<std::remove_const_t<U>, value_type>
+    const vector_view& operator+=(const vector_view<U>& other) const requires (!std::is_const_v<T>)
+    {
+        return AddScaled(value_type(1), other);
+    }
+
+    template <typename U> requires std::is_same_v<std::remove_const_t<U>, value_type>
+    const vector_view& operator-=(const vector_view<U>& other) const requires (!std::is_const_v<T>)
+    {
+        return AddScaled(value_type(-1), other);
+    }
+
+    // this += alpha * other, element by element in order; views of the same storage may overlap
+    template <typename U> requires std::is_same_v<std::remove_const_t<U>, value_type>
+    const vector_view& AddScaled(const value_type alpha, const vector_view<U>& other) const requires (!std::is_const_v<T>)
+    {
+        const std::uintptr_t out = reinterpret_cast<std::uintptr_t>(data), in = reinterpret_cast<std::uintptr_t>(other.GetData());
+        const std::uintptr_t bytes = size * sizeof(value_type);
+        if(stride == 1 && other.GetStride() == 1 && (out + bytes <= in || in + bytes <= out))
+        {
+            T* __restrict out = data;
+            const U* __restrict in = other.GetData();
+            for(size_t i = 0; i < size; i++)
+                out[i] += alpha * in[i];
+        }
+        else
+            for(size_t i = 0; i < size; i++)
+                (*this)[i] += alpha * other[i];
+        return *this;
+    }
+
+    operator std::valarray<value_type>() const
+    {
+        std::valarray<value_type> result(size);
+        for(size_t i = 0; i < size; i++)
+            result[i] = (*this)[i];
+        return result;
+    }
+
+private:
+    T* data;
+    size_t size;
+    ptrdiff_t stride;
+};
+
+template <typename U, typename V> requires std::is_same_v<std::remove_const_t<U>, std::remove_const_t<V>>
+std::remove_const_t<U> dot(const vector_view<U>& first, const vector_view<V>& second)
+{
+    std::remove_const_t<U> result = 0.0;
+    for(size_t i = 0; i < first.GetSize(); i++)
+        result += first[i] * second[i];
+    return result;
+}
+
+// Non-owning view of a row-major sub-block; rows are leading_dimension elements apart.
+template <typename T> requires std::is_arithmetic_v<std::remove_const_t<T>>
+class matrix_view
+{
+public:
+    matrix_view(T* data, const size_t size_x, const size_t size_y, const ptrdiff_t leading_dimension)
+        : data(data), size_y(size_y), size_x(size_x), leading_dimension(leading_dimension) {}
+
+    template <typename U> requires std::is_same_v<const U, T> && (!std::is_same_v<U, T>)
+    matrix_view(const matrix_view<U>& other)
+        : data(other.GetData()), size_y(other.GetSizeY()), size_x(other.GetSizeX()), leading_dimension(other.GetLeadingDimension()) {}
+
+    size_t GetSizeY() const { return size_y; }
+    size_t GetSizeX() const { return size_x; }
+    ptrdiff_t GetLeadingDimension() const { return leading_dimension; }
+    T* GetData() const { return data; }
+
+    T& GetElement(const size_t x, const size_t y) const { return data[ptrdiff_t(x) + ptrdiff_t(y) * leading_dimension]; }
+
+    vector_view<T> Row(const size_t row, const size_t offset = 0) const
+    {
+        return {data + ptrdiff_t(row) * leading_dimension + ptrdiff_t(offset), size_x - offset, 1};
+    }
+
+    vector_view<T> Column(const size_t col, const size_t offset = 0) const
+    {
+        return {data + ptrdiff_t(col) + ptrdiff_t(offset) * leading_dimension, size_y - offset, leading_dimension};
+    }
+
+    matrix_view Block(const size_t x, const size_t y, const size_t block_size_x, const size_t block_size_y) const
+    {
+        return {data + ptrdiff_t(x) + ptrdiff_t(y) * leading_dimension, block_size_x, block_size_y, leading_dimension};
+    }
+
+private:
+    T* data;
+    size_t size_y;
+    size_t size_x;
+    ptrdiff_t leading_dimension;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+class arena_scope;
+
+// Bump allocator handing out memory from large chunks. Single allocations are never freed;
+// Release() makes the whole arena available again in one step, keeping its chunks for reuse,
+// and Rewind() does the same back to an earlier mark.
+class memory_arena
+{
+public:
+    // Counted since construction or the last ResetStatistics()
+    struct statistics
+    {
+        // the most bytes in use at once, alignment gaps included
+        size_t peak_bytes = 0;
+        size_t allocations = 0;
+        // TryAllocate calls refused by the capacity limit, which the caller served from the heap
+        size_t heap_fallbacks = 0;
+    };
+
+    // Position to rewind to, taken with GetMark()
+    struct mark
+    {
+        size_t chunk;
+        size_t offset;
+        size_t used;
+    };
+
+    // capacity_limit bounds the bytes of chunks TryAllocate may add; Allocate ignores it
+    explicit memory_arena(const size_t chunk_size = size_t(1) << 20,
+                          const size_t capacity_limit = std::numeric_limits<size_t>::max())
+        : chunk_size(chunk_size), capacity_limit(capacity_limit) {}
+    memory_arena(const memory_arena&) = delete;
+    memory_arena& operator=(const memory_arena&) = delete;
+    ~memory_arena();
+
+    // The block starts phase bytes past a multiple of alignment (phase < alignment)
+    void* Allocate(const size_t bytes, const size_t alignment = 64, const size_t phase = 0);
+    // nullptr instead of growing past the capacity limit
+    void* TryAllocate(const size_t bytes, const size_t alignment = 64, const size_t phase = 0);
+    void Release();
+
+    mark GetMark() const { return {current, offset, used}; }
+    void Rewind(const mark m);
+
+    // whether p points into one of the arena's chunks
+    bool Owns(const void* p) const;
+
+    // bytes handed out, the alignment gaps between blocks included
+    size_t GetUsedBytes() const { return used; }
+    size_t GetCapacity() const;
+    const statistics& GetStatistics() const { return stats; }
+    void ResetStatistics() { stats = {used, 0, 0}; }
+
+    // Arena used by arena_allocator when none is given explicitly
+    static memory_arena& ThreadDefault();
+    // Arena bound to the calling thread by the innermost arena_scope, nullptr outside of any
+    static memory_arena* GetBound();
+
+private:
+    friend class arena_scope;
+
+    struct chunk
+    {
+        std::byte* data;
+        size_t size;
+    };
+
+    // from the chunks already held, nullptr if none has room
+    void* AllocateFromChunks(size_t bytes, size_t alignment, size_t phase);
+    void* AddChunk(size_t bytes, size_t alignment, size_t phase);
+
+    std::vector<chunk> chunks;
+    size_t current = 0;
+    size_t offset = 0;
+    size_t used = 0;
+    size_t chunk_size;
+    size_t capacity_limit;
+    statistics stats;
+
+    // the innermost arena_scope of the thread; each one links to the scope it is nested in
+    static inline thread_local arena_scope* innermost = nullptr;
+};
+
+// Binds an arena to the calling thread for the lifetime of the scope: every aligned_allocator
+// allocation of the thread meanwhile, which includes the storage of matrix<T> and vector<T>
+// and so all the temporaries of the solvers, is served by the arena (or by the heap once its
+// capacity limit is reached). At scope end the arena is rewound to where the scope found it,
+// in O(1) whatever was allocated, and the previous binding is restored. Objects allocated
+// inside the scope must therefore not be used after it; copy results out first. Releasing
+// them is harmless anywhere, in a nested scope or after the arena itself is gone: the
+// allocator recognises arena memory by its address and never touches it.
+class arena_scope
+{
+public:
+    explicit arena_scope(memory_arena& arena)
+        : arena(arena), start(arena.GetMark()), previous(std::exchange(memory_arena::innermost, this)) {}
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+    ~arena_scope()
+    {
+        memory_arena::innermost = previous;
+        arena.Rewind(start);
+    }
+
+private:
+    friend class memory_arena;
+
+    memory_arena& arena;
+    memory_arena::mark start;
+    arena_scope* previous;
+};
+
+inline memory_arena* memory_arena::GetBound() { return innermost ? &innermost->arena : nullptr; }
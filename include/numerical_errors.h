@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace numericals {
+
+// Thrown by the Cholesky factorizations when a pivot is not positive; GetPivot is the
+// zero-based index of the first failing diagonal entry.
+class not_positive_definite : public std::runtime_error
+{
+public:
+    explicit not_positive_definite(const size_t pivot)
+        : std::runtime_error("Matrix is not positive definite in llt decomposition"), pivot(pivot) {}
+
+    size_t GetPivot() const { return pivot; }
+
+private:
+    size_t pivot;
+};
+
+}
@@ -2,12 +2,20 @@
 
 #include <cstddef>
 #include <stack>
+#include <type_traits>
 #include <utility>
+#include "storage.h"
 
+// Default scalar type; the solvers themselves are templates instantiated for float, double and long double.
 typedef float real;
-//typedef double real;
 
-typedef std::stack<std::pair<size_t, size_t>> permutation_stack;
+template <typename T, typename Storage = aligned_heap_storage<T>> requires std::is_arithmetic_v<T>
+class matrix;
+
+template <typename T, typename Storage = aligned_heap_storage<T>> requires std::is_arithmetic_v<T>
+class vector;
+
+typedef std::stack<std::pair<size_t, size_t>, scratch_vector<std::pair<size_t, size_t>>> permutation_stack;
 
 enum MatrixFlag
 {
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace numericals {
+
+namespace detail {
+inline std::atomic<size_t> thread_count{0};
+}
+
+// Number of threads used by the multithreaded kernels; 0 (the default) means one per hardware thread.
+inline void set_num_threads(const size_t threads) { detail::thread_count = threads; }
+
+inline size_t get_num_threads()
+{
+    const size_t threads = detail::thread_count;
+    if(threads != 0) return threads;
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Threads to start for work worth `chunks` threads: at least one and at most threads, where 0
+// stands for get_num_threads() as in set_num_threads
+inline size_t threads_for(const size_t chunks, const size_t threads)
+{
+    return std::clamp<size_t>(chunks, 1, threads ? threads : get_num_threads());
+}
+
+// Splits [begin, end) into at most `threads` contiguous chunks and calls
+// body(chunk_begin, chunk_end, chunk_index) for each of them, the first one on the
+// calling thread. Exceptions thrown by the body are rethrown after all chunks finished.
+template <typename F>
+void parallel_for(const size_t begin, const size_t end, size_t threads, F&& body)
+{
+    if(begin >= end) return;
+    const size_t count = end - begin;
+    threads = std::clamp<size_t>(threads, 1, count);
+    if(threads == 1)
+    {
+        body(begin, end, size_t(0));
+        return;
+    }
+
+    const size_t chunk = count / threads;
+    const size_t remainder = count % threads;
+    auto chunk_begin = [&](const size_t index) { return begin + index * chunk + std::min(index, remainder); };
+
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for(size_t t = 1; t < threads; t++)
+        workers.emplace_back([&, t]
+        {
+            try { body(chunk_begin(t), chunk_begin(t + 1), t); }
+            catch(...) { errors[t] = std::current_exception(); }
+        });
+
+    try { body(chunk_begin(0), chunk_begin(1), size_t(0)); }
+    catch(...) { errors[0] = std::current_exception(); }
+
+    for(auto& worker : workers)
+        worker.join();
+    for(const auto& error : errors)
+        if(error) std::rethrow_exception(error);
+}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "numerical_types.h"
+#include "matrix.h"
+#include "matrix_view.h"
+#include "parallel.h"
+#include "vector.h"
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace numericals {
+
+// One entry of a sparse matrix under assembly, at column x and row y; entries sharing a
+// position are summed
+template <typename T = real>
+struct triplet
+{
+    size_t x;
+    size_t y;
+    T value;
+};
+
+enum class sparse_layout { rows, columns };
+
+// Compressed sparse rows (layout rows) or columns (layout columns). The stored entries of outer
+// index o (a row for CSR, a column for CSC) are [offsets[o], offsets[o + 1]), their inner
+// indices ascending without repeats.
+template <typename T, sparse_layout Layout>
+class compressed_matrix
+{
+public:
+    static constexpr sparse_layout layout = Layout;
+
+    compressed_matrix(const size_t size_x, const size_t size_y)
+        : size_x(size_x), size_y(size_y), offsets(OuterSize() + 1, 0) {}
+    compressed_matrix(size_t size_x, size_t size_y, std::span<const triplet<T>> entries);
+    // takes already compressed arrays as they are
+    compressed_matrix(size_t size_x, size_t size_y, std::vector<size_t> offsets, std::vector<size_t> indices, std::vector<T> values);
+    // the same matrix in the other layout
+    template <sparse_layout Other> requires (Other != Layout)
+    explicit compressed_matrix(const compressed_matrix<T, Other>& other);
+
+    size_t GetSizeX() const { return size_x; }
+    size_t GetSizeY() const { return size_y; }
+    size_t GetNonZeroCount() const { return values.size(); }
+
+    const std::vector<size_t>& GetOffsets() const { return offsets; }
+    const std::vector<size_t>& GetIndices() const { return indices; }
+    const std::vector<T>& GetValues() const { return values; }
+    // the pattern is fixed, the values may be refilled for a new factorization
+    std::vector<T>& GetValues() { return values; }
+
+    // zero when (x, y) is not stored
+    T GetElement(size_t x, size_t y) const;
+    matrix<T> ToDense() const;
+
+private:
+    size_t OuterSize() const { return Layout == sparse_layout::rows ? size_y : size_x; }
+
+    size_t size_x;
+    size_t size_y;
+    std::vector<size_t> offsets;
+    std::vector<size_t> indices;
+    std::vector<T> values;
+};
+
+template <typename T = real>
+using csr_matrix = compressed_matrix<T, sparse_layout::rows>;
+template <typename T = real>
+using csc_matrix = compressed_matrix<T, sparse_layout::columns>;
+
+// y = A x; the rows are split between up to threads threads, each taking a similar share of
+// the stored entries
+template <typename T>
+void multiply(const csr_matrix<T>& a, vector_view<const T> x, vector_view<T> y, size_t threads = get_num_threads());
+// y = A x, column by column
+template <typename T>
+void multiply(const csc_matrix<T>& a, vector_view<const T> x, vector_view<T> y);
+
+template <typename T, sparse_layout Layout>
+vector<T> operator*(const compressed_matrix<T, Layout>& a, const vector<T>& x)
+{
+    vector<T> y(a.GetSizeY());
+    multiply(a, x.View(), y.View());
+    return y;
+}
+
+}
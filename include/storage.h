@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "memory_arena.h"
+
+// Storage policies for matrix<T, Storage> and vector<T, Storage>. A storage owns (or refers to)
+// rows * leading_dimension elements and is constructed from (rows, cols, extra arguments...),
+// the extra arguments being forwarded from the matrix/vector constructor.
+
+// Heap allocations made by the calling thread through aligned_allocator, which backs the
+// default storage of matrix and vector. Allocations served by an arena bound with arena_scope
+// are not counted. The dense solvers and decompositions (MatrixSolver.h, MatrixDecomposer.h,
+// Factorization.h) take every buffer, scratch or returned, from aligned_allocator as matrices,
+// vectors or scratch_vector, so around their calls an unchanged count means no heap allocation
+// at all. Only the worker threads of the multithreaded kernels and, when built with
+// NUMERICALS_INSTRUMENTATION, the statistics sink of instrumentation.h bypass it.
+inline thread_local size_t heap_allocation_count = 0;
+
+template <typename T, size_t Alignment = 64>
+struct aligned_allocator
+{
+    using value_type = T;
+    template <typename U> struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+    // Blocks are aligned to alignment either way, but arena blocks start at an odd multiple of
+    // it and heap blocks at an even one, so deallocate tells them apart from the address alone,
+    // on any thread and whether the arena is still bound, or still alive, or not. The arena
+    // places its blocks at the odd multiples directly, so the marking costs no extra bytes
+    // beyond the gaps it may leave between blocks, which its statistics count.
+    static constexpr size_t alignment = std::max(Alignment, alignof(T));
+
+    aligned_allocator() = default;
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Alignment>&) {}
+
+    // from the arena bound to the thread by an arena_scope (memory_arena.h) if there is one
+    // with room, from the heap otherwise
+    T* allocate(const size_t n)
+    {
+        if(memory_arena* arena = memory_arena::GetBound())
+            if(void* p = arena->TryAllocate(n * sizeof(T), 2 * alignment, alignment))
+                return static_cast<T*>(p);
+        heap_allocation_count++;
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(2 * alignment)));
+    }
+    // arena memory, whether its scope is still open or not, is left to its arena
+    void deallocate(T* p, size_t)
+    {
+        if(reinterpret_cast<std::uintptr_t>(p) & alignment) return;
+        ::operator delete(p, std::align_val_t(2 * alignment));
+    }
+
+    template <typename U>
+    bool operator==(const aligned_allocator<U, Alignment>&) const { return true; }
+};
+
+// Scratch buffer of the solvers: counted in heap_allocation_count and served by a bound arena
+template <typename T>
+using scratch_vector = std::vector<T, aligned_allocator<T>>;
+
+// Hands out memory from a memory_arena; deallocation is a no-op, the memory comes back when
+// the arena is released.
+template <typename T>
+class arena_allocator
+{
+public:
+    using value_type = T;
+    template <typename U> struct rebind { using other = arena_allocator<U>; };
+
+    arena_allocator() : arena(&memory_arena::ThreadDefault()) {}
+    explicit arena_allocator(memory_arena& arena) : arena(&arena) {}
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other) : arena(&other.GetArena()) {}
+
+    T* allocate(const size_t n) { return static_cast<T*>(arena->Allocate(n * sizeof(T), std::max<size_t>(alignof(T), 64))); }
+    void deallocate(T*, size_t) {}
+
+    memory_arena& GetArena() const { return *arena; }
+
+    template <typename U>
+    bool operator==(const arena_allocator<U>& other) const { return arena == &other.GetArena(); }
+
+private:
+    memory_arena* arena;
+};
+
+// Owning, zero-initialised storage obtained from Allocator. Rows start every
+// round_up(cols, RowPadding) elements, so RowPadding = elements per cache line keeps every
+// row cache-line aligned.
+template <typename T, typename Allocator = aligned_allocator<T>, size_t RowPadding = 1>
+class heap_storage
+{
+public:
+    heap_storage(const size_t rows, const size_t cols, const Allocator& allocator = Allocator())
+        : allocator(allocator), leading_dimension((cols + RowPadding - 1) / RowPadding * RowPadding),
+          size(rows * leading_dimension), data(Allocate(size))
+    {
+        std::fill_n(data, size, T(0));
+    }
+
+    heap_storage(const heap_storage& other)
+        : allocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.allocator)),
+          leading_dimension(other.leading_dimension), size(other.size), data(Allocate(size))
+    {
+        std::copy_n(other.data, size, data);
+    }
+
+    heap_storage(heap_storage&& other) noexcept
+        : allocator(other.allocator), leading_dimension(other.leading_dimension),
+          size(std::exchange(other.size, 0)), data(std::exchange(other.data, nullptr)) {}
+
+    heap_storage& operator=(heap_storage other) noexcept
+    {
+        std::swap(allocator, other.allocator);
+        std::swap(leading_dimension, other.leading_dimension);
+        std::swap(size, other.size);
+        std::swap(data, other.data);
+        return *this;
+    }
+
+    ~heap_storage()
+    {
+        if(data) allocator.deallocate(data, size);
+    }
+
+    T* GetData() { return data; }
+    const T* GetData() const { return data; }
+    size_t GetLeadingDimension() const { return leading_dimension; }
+    size_t GetSize() const { return size; }
+
+private:
+    T* Allocate(const size_t count) { return count ? allocator.allocate(count) : nullptr; }
+
+    Allocator allocator;
+    size_t leading_dimension;
+    size_t size;
+    T* data;
+};
+
+template <typename T>
+using aligned_heap_storage = heap_storage<T, aligned_allocator<T, 64>>;
+
+template <typename T>
+using padded_storage = heap_storage<T, aligned_allocator<T, 64>, std::max<size_t>(1, 64 / sizeof(T))>;
+
+template <typename T>
+using arena_storage = heap_storage<T, arena_allocator<T>>;
+
+// Non-owning storage over an existing buffer (e.g. one handed over by an I/O layer).
+// Copies refer to the same buffer.
+template <typename T>
+class external_storage
+{
+public:
+    external_storage(const size_t rows, const size_t cols, T* data, size_t leading_dimension = 0)
+        : leading_dimension(leading_dimension ? leading_dimension : cols), size(rows * this->leading_dimension), data(data)
+    {
+        if(this->leading_dimension < cols) [[unlikely]] throw std::runtime_error("Leading dimension smaller than the row length");
+    }
+
+    T* GetData() { return data; }
+    const T* GetData() const { return data; }
+    size_t GetLeadingDimension() const { return leading_dimension; }
+    size_t GetSize() const { return size; }
+
+private:
+    size_t leading_dimension;
+    size_t size;
+    T* data;
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "cpu_features.h"
+
+namespace numericals {
+
+// Edge of the square blocks transposed in registers, and of the cache-resident leaves the
+// recursion stops at.
+template <typename T>
+struct transpose_blocking
+{
+    static constexpr size_t micro = 4;
+    static constexpr size_t leaf = 32;
+};
+
+#if defined(NUMERICALS_X86_KERNELS)
+// 8 x 8 blocks for the AVX2 kernel, and for the generic one on CPUs without AVX2
+template <>
+struct transpose_blocking<float>
+{
+    static constexpr size_t micro = 8;
+    static constexpr size_t leaf = 64;
+};
+#endif
+
+namespace detail {
+
+// dst (micro x micro) = src^T
+template <typename T>
+void transpose_micro(const T* src, const ptrdiff_t lds, T* dst, const ptrdiff_t ldd)
+{
+    constexpr size_t micro = transpose_blocking<T>::micro;
+    for(size_t i = 0; i < micro; i++)
+        for(size_t j = 0; j < micro; j++)
+            dst[ptrdiff_t(j) * ldd + ptrdiff_t(i)] = src[ptrdiff_t(i) * lds + ptrdiff_t(j)];
+}
+
+#if defined(NUMERICALS_X86_KERNELS)
+NUMERICALS_TARGET_AVX2_FMA
+inline void transpose_micro_avx2(const float* src, const ptrdiff_t lds, float* dst, const ptrdiff_t ldd)
+{
+    const __m256 r0 = _mm256_loadu_ps(src + 0 * lds), r1 = _mm256_loadu_ps(src + 1 * lds);
+    const __m256 r2 = _mm256_loadu_ps(src + 2 * lds), r3 = _mm256_loadu_ps(src + 3 * lds);
+    const __m256 r4 = _mm256_loadu_ps(src + 4 * lds), r5 = _mm256_loadu_ps(src + 5 * lds);
+    const __m256 r6 = _mm256_loadu_ps(src + 6 * lds), r7 = _mm256_loadu_ps(src + 7 * lds);
+
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    const __m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+    const __m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)), s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)), s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(dst + 0 * ldd, _mm256_permute2f128_ps(s0, s4, 0x20));
+    _mm256_storeu_ps(dst + 1 * ldd, _mm256_permute2f128_ps(s1, s5, 0x20));
+    _mm256_storeu_ps(dst + 2 * ldd, _mm256_permute2f128_ps(s2, s6, 0x20));
+    _mm256_storeu_ps(dst + 3 * ldd, _mm256_permute2f128_ps(s3, s7, 0x20));
+    _mm256_storeu_ps(dst + 4 * ldd, _mm256_permute2f128_ps(s0, s4, 0x31));
+    _mm256_storeu_ps(dst + 5 * ldd, _mm256_permute2f128_ps(s1, s5, 0x31));
+    _mm256_storeu_ps(dst + 6 * ldd, _mm256_permute2f128_ps(s2, s6, 0x31));
+    _mm256_storeu_ps(dst + 7 * ldd, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
+NUMERICALS_TARGET_AVX2_FMA
+inline void transpose_micro_avx2(const double* src, const ptrdiff_t lds, double* dst, const ptrdiff_t ldd)
+{
+    const __m256d r0 = _mm256_loadu_pd(src + 0 * lds), r1 = _mm256_loadu_pd(src + 1 * lds);
+    const __m256d r2 = _mm256_loadu_pd(src + 2 * lds), r3 = _mm256_loadu_pd(src + 3 * lds);
+
+    const __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+    const __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+
+    _mm256_storeu_pd(dst + 0 * ldd, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(dst + 1 * ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(dst + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(dst + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+inline void transpose_micro(const float* src, const ptrdiff_t lds, float* dst, const ptrdiff_t ldd)
+{
+    if(has_avx2_fma()) transpose_micro_avx2(src, lds, dst, ldd);
+    else transpose_micro<float>(src, lds, dst, ldd);
+}
+
+inline void transpose_micro(const double* src, const ptrdiff_t lds, double* dst, const ptrdiff_t ldd)
+{
+    if(has_avx2_fma()) transpose_micro_avx2(src, lds, dst, ldd);
+    else transpose_micro<double>(src, lds, dst, ldd);
+}
+#endif
+
+template <typename T>
+void transpose_leaf(const T* src, const ptrdiff_t lds, const size_t rows, const size_t cols, T* dst, const ptrdiff_t ldd)
+{
+    constexpr size_t micro = transpose_blocking<T>::micro;
+    const size_t fullRows = rows / micro * micro;
+    const size_t fullCols = cols / micro * micro;
+    for(size_t i = 0; i < fullRows; i += micro)
+        for(size_t j = 0; j < fullCols; j += micro)
+            transpose_micro(src + ptrdiff_t(i) * lds + ptrdiff_t(j), lds, dst + ptrdiff_t(j) * ldd + ptrdiff_t(i), ldd);
+
+    for(size_t i = 0; i < rows; i++)
+        for(size_t j = i < fullRows ? fullCols : 0; j < cols; j++)
+            dst[ptrdiff_t(j) * ldd + ptrdiff_t(i)] = src[ptrdiff_t(i) * lds + ptrdiff_t(j)];
+}
+
+// Swaps the micro x micro block at a with the transpose of the one at b (a == b transposes in place).
+template <typename T>
+void transpose_swap_micro(T* a, T* b, const ptrdiff_t ld)
+{
+    constexpr size_t micro = transpose_blocking<T>::micro;
+    alignas(64) T tmp[micro * micro];
+    transpose_micro(a, ld, tmp, ptrdiff_t(micro));
+    if(a != b) transpose_micro(b, ld, a, ld);
+    for(size_t i = 0; i < micro; i++)
+        std::copy(tmp + i * micro, tmp + (i + 1) * micro, b + ptrdiff_t(i) * ld);
+}
+
+}
+
+// dst (cols x rows) = src^T for a row-major rows x cols source. Recursively halves the larger
+// dimension until a tile fits in L1, so neither side is streamed with a cache-missing stride;
+// tiles are transposed register block by register block. src and dst must not overlap.
+template <typename T>
+void transpose_copy(const T* src, const ptrdiff_t lds, const size_t rows, const size_t cols, T* dst, const ptrdiff_t ldd)
+{
+    constexpr size_t micro = transpose_blocking<T>::micro;
+    constexpr size_t leaf = transpose_blocking<T>::leaf;
+    if(rows <= leaf && cols <= leaf)
+    {
+        detail::transpose_leaf(src, lds, rows, cols, dst, ldd);
+        return;
+    }
+
+    if(rows >= cols)
+    {
+        const size_t half = (rows / 2 + micro - 1) / micro * micro;
+        transpose_copy(src, lds, half, cols, dst, ldd);
+        transpose_copy(src + ptrdiff_t(half) * lds, lds, rows - half, cols, dst + ptrdiff_t(half), ldd);
+    }
+    else
+    {
+        const size_t half = (cols / 2 + micro - 1) / micro * micro;
+        transpose_copy(src, lds, rows, half, dst, ldd);
+        transpose_copy(src + ptrdiff_t(half), lds, rows, cols - half, dst + ptrdiff_t(half) * ldd, ldd);
+    }
+}
+
+// Transposes a square n x n matrix in place, tile pair by tile pair across the diagonal.
+template <typename T>
+void transpose_in_place(T* data, const ptrdiff_t ld, const size_t n)
+{
+    constexpr size_t micro = transpose_blocking<T>::micro;
+    constexpr size_t leaf = transpose_blocking<T>::leaf;
+    const size_t full = n / micro * micro;
+
+    for(size_t ib = 0; ib < full; ib += leaf)
+        for(size_t jb = ib; jb < full; jb += leaf)
+        {
+            const size_t iEnd = std::min(full, ib + leaf);
+            const size_t jEnd = std::min(full, jb + leaf);
+            for(size_t i = ib; i < iEnd; i += micro)
+                for(size_t j = (ib == jb ? i : jb); j < jEnd; j += micro)
+                    detail::transpose_swap_micro(data + ptrdiff_t(i) * ld + ptrdiff_t(j), data + ptrdiff_t(j) * ld + ptrdiff_t(i), ld);
+        }
+
+    for(size_t i = 0; i < n; i++)
+        for(size_t j = std::max(i + 1, full); j < n; j++)
+            std::swap(data[ptrdiff_t(i) * ld + ptrdiff_t(j)], data[ptrdiff_t(j) * ld + ptrdiff_t(i)]);
+}
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "gemm.h"
+#include "matrix_view.h"
+
+namespace numericals {
+
+enum class triangle { lower, upper };
+
+// Rows of the triangle solved per block: the diagonal block stays cache resident while it is
+// applied to every right-hand side, and everything off the diagonal goes through gemm.
+template <typename T>
+struct trsm_blocking
+{
+    static constexpr size_t block = 64;
+};
+
+namespace detail {
+
+// b = L^-1 b for the size x size lower triangle at t; element (i, k) is t[i * rs + k * cs].
+// Each step updates whole rows of b, which vectorises across the right-hand sides.
+template <typename T>
+void trsm_lower_unblocked(const T* t, const ptrdiff_t rs, const ptrdiff_t cs, const size_t size,
+                          const bool unitDiagonal, const matrix_view<T> b)
+{
+    for(size_t i = 0; i < size; i++)
+    {
+        const auto row = b.Row(i);
+        if(b.GetSizeX() == 1)
+            row[0] -= dot(vector_view<const T>(t + ptrdiff_t(i) * rs, i, cs), b.Column(0).Subview(0, i));
+        else
+            for(size_t k = 0; k < i; k++)
+                row.AddScaled(-t[ptrdiff_t(i) * rs + ptrdiff_t(k) * cs], b.Row(k));
+        if(!unitDiagonal)
+            row /= t[ptrdiff_t(i) * (rs + cs)];
+    }
+}
+
+// b = U^-1 b for the size x size upper triangle at t
+template <typename T>
+void trsm_upper_unblocked(const T* t, const ptrdiff_t rs, const ptrdiff_t cs, const size_t size,
+                          const bool unitDiagonal, const matrix_view<T> b)
+{
+    for(size_t i = size; i-- > 0;)
+    {
+        const auto row = b.Row(i);
+        if(b.GetSizeX() == 1)
+            row[0] -= dot(vector_view<const T>(t + ptrdiff_t(i) * (rs + cs) + cs, size - i - 1, cs),
+                          b.Column(0).Subview(i + 1, size - i - 1));
+        else
+            for(size_t k = i + 1; k < size; k++)
+                row.AddScaled(-t[ptrdiff_t(i) * rs + ptrdiff_t(k) * cs], b.Row(k));
+        if(!unitDiagonal)
+            row /= t[ptrdiff_t(i) * (rs + cs)];
+    }
+}
+
+}
+
+// b = op(A)^-1 b for every column of b, where A is the lower or upper triangle of the square
+// view t and op(A) is A or A^T. With unitDiagonal the diagonal of t is not read.
+template <typename T>
+void trsm(const triangle part, const bool transposed, const bool unitDiagonal,
+          const std::type_identity_t<matrix_view<const T>> t, const matrix_view<T> b)
+{
+    const size_t size = t.GetSizeY();
+    if(t.GetSizeX() != size || b.GetSizeY() != size) [[unlikely]] throw std::runtime_error("Wrong matrix sizes in triangular solve");
+
+    const T* data = t.GetData();
+    ptrdiff_t rs = t.GetLeadingDimension();
+    ptrdiff_t cs = 1;
+    bool lower = part == triangle::lower;
+    if(transposed)
+    {
+        std::swap(rs, cs);
+        lower = !lower;
+    }
+
+    const size_t width = b.GetSizeX();
+    if(width == 1 || size <= trsm_blocking<T>::block)
+    {
+        if(lower) detail::trsm_lower_unblocked(data, rs, cs, size, unitDiagonal, b);
+        else      detail::trsm_upper_unblocked(data, rs, cs, size, unitDiagonal, b);
+        return;
+    }
+
+    constexpr size_t block = trsm_blocking<T>::block;
+    const ptrdiff_t ldb = b.GetLeadingDimension();
+    auto at = [&](const size_t i, const size_t k) { return data + ptrdiff_t(i) * rs + ptrdiff_t(k) * cs; };
+    if(lower)
+        for(size_t ib = 0; ib < size; ib += block)
+        {
+            const size_t bs = std::min(block, size - ib);
+            detail::trsm_lower_unblocked(at(ib, ib), rs, cs, bs, unitDiagonal, b.Block(0, ib, width, bs));
+
+            // the rows below take the solved block off through one rank-bs update
+            const size_t rest = size - ib - bs;
+            if(rest != 0)
+                gemm<T>(rest, width, bs, T(-1), at(ib + bs, ib), rs, cs,
+                        &b.GetElement(0, ib), ldb, 1, T(1), &b.GetElement(0, ib + bs), ldb, 1);
+        }
+    else
+        for(size_t ie = size; ie > 0;)
+        {
+            const size_t bs = std::min(block, ie);
+            const size_t ib = ie - bs;
+            detail::trsm_upper_unblocked(at(ib, ib), rs, cs, bs, unitDiagonal, b.Block(0, ib, width, bs));
+
+            if(ib != 0)
+                gemm<T>(ib, width, bs, T(-1), at(0, ib), rs, cs,
+                        &b.GetElement(0, ib), ldb, 1, T(1), b.GetData(), ldb, 1);
+            ie = ib;
+        }
+}
+
+}
@@ -1,23 +1,36 @@
 #pragma once
+#include <cmath>
 #include <utility>
 #include <valarray>
 #include <matrix.h>
 
 template <typename T> requires std::is_arithmetic_v<T>
-size_t find_index_of_valarray_max(const std::valarray<T>& vals, size_t start, size_t end)
+size_t find_index_of_valarray_max(const vector_view<const T>& vals, size_t start, size_t end)
 {
     size_t maxInd = start;
-    T max = vals[start];
+    T max = std::abs(vals[start]);
     for(size_t i = start + 1; i < end; i++)
-        if(vals[i] > max)
+        if(std::abs(vals[i]) > max)
         {
-            max = vals[i];
+            max = std::abs(vals[i]);
             maxInd = i;
         }
 
     return maxInd; 
 }
 
+template <typename T> requires std::is_arithmetic_v<T>
+size_t find_index_of_valarray_max(const std::valarray<T>& vals, size_t start, size_t end)
+{
+    return find_index_of_valarray_max(vector_view<const T>(std::begin(vals), vals.size()), start, end);
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+size_t find_index_of_valarray_max(const vector_view<T>& vals, size_t start, size_t end)
+{
+    return find_index_of_valarray_max(vector_view<const T>(vals), start, end);
+}
+
 template <typename T> requires std::is_arithmetic_v<T>
 std::pair<size_t, size_t> find_index_of_matrix_max(const matrix<T>& mat, const size_t startX = 0, const size_t startY = 0,
                                                    size_t endX = 0, size_t endY = 0)
@@ -25,16 +38,16 @@ std::pair<size_t, size_t> find_index_of_matrix_max(const matrix<T>& mat, const s
     if(endX == 0) endX = mat.GetSizeX();
     if(endY == 0) endY = mat.GetSizeY();
 
-    T max = mat.GetElement(0);
+    T max = std::abs(mat.GetElement(startX, startY));
     size_t indX = startX;
     size_t indY = startY;
     for(size_t y = startY; y < endY; y++)
         for(size_t x = startX; x < endX; x++)
-            if(mat.GetElement(x, y) > max)
+            if(std::abs(mat.GetElement(x, y)) > max)
             {
                 indX = x;
                 indY = y;
-                max = mat.GetElement(x, y);
+                max = std::abs(mat.GetElement(x, y));
             }
 
     return {indX, indY};
@@ -55,3 +68,10 @@ void swap_slices(std::valarray<T>& first, std::valarray<T>& second)
     first = second;
     second = tmp; 
 }
+
+template <typename T> requires std::is_arithmetic_v<T>
+void swap_slices(const vector_view<T>& first, const vector_view<T>& second)
+{
+    for(size_t i = 0; i < first.GetSize(); i++)
+        std::swap(first[i], second[i]);
+}
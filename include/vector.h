@@ -4,42 +4,83 @@
 #include <initializer_list>
 #include <iostream>
 #include <span>
+#include "matrix_expression.h"
+#include "matrix_view.h"
+#include "numerical_types.h"
+#include "storage.h"
 #include <valarray>
 #include <iostream>
 
-template <typename T> requires std::is_arithmetic_v<T>
+template <typename T, typename Storage> requires std::is_arithmetic_v<T>
 class vector{
 public:
-    vector(const size_t size) : data(size){};
-    vector(std::initializer_list<T> list) : data(list){}
-    vector(std::valarray<T> array) : data(array){}
-    vector(std::span<T> array)
+    using value_type = T;
+    using storage_type = Storage;
+
+    template <typename... Args> requires std::constructible_from<Storage, size_t, size_t, Args...>
+    vector(const size_t size, Args&&... storageArgs) : storage(1, size, std::forward<Args>(storageArgs)...), size(size) {}
+    vector(std::initializer_list<T> list) : vector(list.size())
+    {
+        std::copy(list.begin(), list.end(), GetData());
+    }
+    vector(const std::valarray<T>& array) : vector(array.size())
+    {
+        std::copy(std::begin(array), std::end(array), GetData());
+    }
+    vector(std::span<T> array) : vector(array.size())
     {
-        data.resize(array.size());
-        std::copy(array.begin(), array.end(), std::begin(data));
+        std::copy(array.begin(), array.end(), GetData());
+    }
+
+    template <typename OtherStorage> requires (!std::is_same_v<OtherStorage, Storage>)
+    explicit vector(const vector<T, OtherStorage>& other) : vector(other.GetSize())
+    {
+        View() = other.View();
     }
     
-    size_t GetSize() const {return data.size();}
+    template <vector_expression_node E> requires std::is_same_v<typename E::value_type, T>
+    vector(const E& expression) : vector(expression.GetSize())
+    {
+        expression.EvaluateTo(View());
+    }
+
+    template <vector_expression_node E> requires std::is_same_v<typename E::value_type, T>
+    vector& operator=(const E& expression)
+    {
+        if(GetSize() != expression.GetSize() || expression.Aliases(GetData(), GetData() + GetSize()))
+            return *this = vector(expression);
+
+        expression.EvaluateTo(View());
+        return *this;
+    }
+
+    size_t GetSize() const {return size;}
 
-    T operator*(const vector<T>& other)
+    template <typename S>
+    T operator*(const vector<T, S>& other) const
     {
-        T result = 0.0;
-        for(size_t i = 0; i < data.size(); i++)
-            result += data[i] * other[i];
-        return result;
+        return dot(View(), other.View());
     }
 
-    T& operator[](const size_t index) { return data[index]; }
-    T operator[](const size_t index) const { return data[index]; }
+    T& operator[](const size_t index) { return GetData()[index]; }
+    T operator[](const size_t index) const { return GetData()[index]; }
+
+    T* GetData() { return storage.GetData(); }
+    const T* GetData() const { return storage.GetData(); }
+    const Storage& GetStorage() const { return storage; }
+
+    vector_view<T> View() { return {GetData(), GetSize()}; }
+    vector_view<const T> View() const { return {GetData(), GetSize()}; }
     
-    operator std::valarray<T> () const {return data;}
+    operator std::valarray<T> () const {return View();}
 private:
-    std::valarray<T> data;
+    Storage storage;
+    size_t size;
 };
 
 
-template <typename F> requires std::is_arithmetic_v<F>
-std::ostream& operator<< (std::ostream& stream, vector<F> toPrint)
+template <typename F, typename S> requires std::is_arithmetic_v<F>
+std::ostream& operator<< (std::ostream& stream, const vector<F, S>& toPrint)
 {
     for(size_t i = 0; i < toPrint.GetSize(); i++)
         stream << toPrint[i] << "\t";
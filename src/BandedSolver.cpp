@@ -0,0 +1,140 @@
+#include "BandedSolver.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace numericals {
+
+template <typename T>
+band_matrix<T>::band_matrix(const matrix_view<const T> a, const size_t lower, const size_t upper)
+    : band_matrix(a.GetSizeY(), lower, upper)
+{
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Band of a non-square matrix");
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = GetFirstColumn(y); x < GetLastColumn(y); x++)
+            GetElement(x, y) = a.GetElement(x, y);
+}
+
+template <typename T>
+matrix<T> band_matrix<T>::ToDense() const
+{
+    matrix<T> result{size, size};
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = GetFirstColumn(y); x < GetLastColumn(y); x++)
+            result.GetElement(x, y) = GetElement(x, y);
+    return result;
+}
+
+template <typename T>
+void multiply(const band_matrix<T>& a, const vector_view<const T> x, const vector_view<T> y)
+{
+    if(x.GetSize() != a.GetSize() || y.GetSize() != a.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in band product");
+    for(size_t r = 0; r < a.GetSize(); r++)
+    {
+        const size_t first = a.GetFirstColumn(r);
+        y[r] = dot(a.Row(r), x.Subview(first, a.GetLastColumn(r) - first));
+    }
+}
+
+template <typename T>
+vector<T> operator*(const band_matrix<T>& a, const vector<T>& x)
+{
+    vector<T> y(a.GetSize());
+    multiply(a, x.View(), y.View());
+    return y;
+}
+
+template <typename T>
+BandedLUFactorization<T>::BandedLUFactorization(const band_matrix<T>& a, const band_pivoting pivoting)
+    : lu(a.GetSize(), a.GetLowerBandwidth(),
+         a.GetUpperBandwidth() + (pivoting == band_pivoting::partial ? a.GetLowerBandwidth() : 0))
+{
+    const size_t n = a.GetSize();
+    const size_t kl = lu.GetLowerBandwidth();
+    for(size_t y = 0; y < n; y++)
+        for(size_t x = a.GetFirstColumn(y); x < a.GetLastColumn(y); x++)
+            lu.GetElement(x, y) = a.GetElement(x, y);
+    if(pivoting == band_pivoting::partial)
+        swaps.resize(n);
+
+    for(size_t k = 0; k < n; k++)
+    {
+        const size_t lastRow = std::min(n, k + kl + 1);
+        // row k reaches GetLastColumn(k) after any exchange, and every row below it reaches further
+        const size_t lastColumn = lu.GetLastColumn(k);
+        if(pivoting == band_pivoting::partial)
+        {
+            size_t best = k;
+            for(size_t i = k + 1; i < lastRow; i++)
+                if(std::abs(lu.GetElement(k, i)) > std::abs(lu.GetElement(k, best)))
+                    best = i;
+            swaps[k] = best;
+            if(best != k)
+                for(size_t c = k; c < lastColumn; c++)
+                    std::swap(lu.GetElement(c, k), lu.GetElement(c, best));
+        }
+
+        const T pivot = lu.GetElement(k, k);
+        if(pivot == T(0)) [[unlikely]] throw std::runtime_error("Singular matrix in banded lu");
+        const T* const pivotRow = &lu.GetElement(k, k);
+        for(size_t i = k + 1; i < lastRow; i++)
+        {
+            const T multiplier = lu.GetElement(k, i) /= pivot;
+            if(multiplier == T(0)) continue;
+            T* const row = &lu.GetElement(k, i);
+            for(size_t c = 1; c < lastColumn - k; c++)
+                row[c] -= multiplier * pivotRow[c];
+        }
+    }
+}
+
+template <typename T>
+void BandedLUFactorization<T>::SolveInPlace(const matrix_view<T> b) const
+{
+    const size_t n = lu.GetSize();
+    const size_t kl = lu.GetLowerBandwidth();
+    if(b.GetSizeY() != n) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
+
+    // L y = P b, exchanging and eliminating whole rows of b so every right-hand side moves together
+    for(size_t k = 0; k < n; k++)
+    {
+        if(!swaps.empty() && swaps[k] != k)
+            for(size_t c = 0; c < b.GetSizeX(); c++)
+                std::swap(b.GetElement(c, k), b.GetElement(c, swaps[k]));
+        for(size_t i = k + 1; i < std::min(n, k + kl + 1); i++)
+            if(lu.GetElement(k, i) != T(0))
+                b.Row(i).AddScaled(-lu.GetElement(k, i), b.Row(k));
+    }
+
+    // U x = y
+    for(size_t k = n; k-- > 0;)
+    {
+        for(size_t c = k + 1; c < lu.GetLastColumn(k); c++)
+            if(lu.GetElement(c, k) != T(0))
+                b.Row(k).AddScaled(-lu.GetElement(c, k), b.Row(c));
+        b.Row(k) /= lu.GetElement(k, k);
+    }
+}
+
+template <typename T>
+vector<T> solve_banded_matrix_eq(const band_matrix<T>& a, const vector<T>& b, const band_pivoting pivoting)
+{
+    if(a.GetSize() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
+
+    return BandedLUFactorization<T>(a, pivoting).Solve(b);
+}
+
+#define NUMERICALS_INSTANTIATE_BANDED_SOLVER(T) \
+    template class band_matrix<T>; \
+    template class BandedLUFactorization<T>; \
+    template void multiply<T>(const band_matrix<T>&, vector_view<const T>, vector_view<T>); \
+    template vector<T> operator*<T>(const band_matrix<T>&, const vector<T>&); \
+    template vector<T> solve_banded_matrix_eq<T>(const band_matrix<T>&, const vector<T>&, band_pivoting);
+
+NUMERICALS_INSTANTIATE_BANDED_SOLVER(float)
+NUMERICALS_INSTANTIATE_BANDED_SOLVER(double)
+NUMERICALS_INSTANTIATE_BANDED_SOLVER(long double)
+#undef NUMERICALS_INSTANTIATE_BANDED_SOLVER
+
+}
@@ -0,0 +1,380 @@
+#include "BatchedSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace numericals {
+
+namespace detail {
+
+// Groups handled by one thread at the least, so small batches stay on the calling thread
+constexpr size_t batch_groups_per_thread = 256;
+
+template <typename T, typename F>
+void for_each_group(const size_t groups, const size_t threads, F&& body)
+{
+    parallel_for(0, groups, threads_for(groups / batch_groups_per_thread, threads),
+                 [&](const size_t first, const size_t last, size_t)
+    {
+        for(size_t group = first; group < last; group++)
+            body(group);
+    });
+}
+
+// Element (x, y) of a group, as a pointer to its lanes
+template <typename T>
+struct group_matrix
+{
+    static constexpr size_t lanes = batch_lanes<T>;
+    T* data;
+    size_t size;
+
+    T* operator()(const size_t x, const size_t y) const { return data + (y * size + x) * lanes; }
+};
+
+// y -= a * x, lane by lane
+template <typename T>
+inline void subtract_product_lanes(T* __restrict y, const T* __restrict a, const T* __restrict x)
+{
+    for(size_t l = 0; l < batch_lanes<T>; l++)
+        y[l] -= a[l] * x[l];
+}
+
+template <typename T>
+inline void divide_lanes(T* __restrict y, const T* __restrict x)
+{
+    for(size_t l = 0; l < batch_lanes<T>; l++)
+        y[l] /= x[l];
+}
+
+// Keeps, per lane, the larger of maxAbs and |candidate| and the row it came from
+template <typename T>
+inline void select_pivot_lanes(const T* __restrict candidate, const T row, T* __restrict maxAbs, T* __restrict pivot)
+{
+    for(size_t l = 0; l < batch_lanes<T>; l++)
+    {
+        const T value = std::abs(candidate[l]);
+        const bool larger = value > maxAbs[l];
+        maxAbs[l] = larger ? value : maxAbs[l];
+        pivot[l] = larger ? row : pivot[l];
+    }
+}
+
+// Swaps first and second in the lanes whose pivot is row
+template <typename T>
+inline void swap_selected_lanes(T* __restrict first, T* __restrict second, const T* __restrict pivot, const T row)
+{
+    for(size_t l = 0; l < batch_lanes<T>; l++)
+    {
+        const bool selected = pivot[l] == row;
+        const T x = first[l], y = second[l];
+        first[l] = selected ? y : x;
+        second[l] = selected ? x : y;
+    }
+}
+
+// Copies the per-lane breakdown flags of a group into the status of its systems
+template <typename T>
+void record_failed_lanes(batch_status& status, const size_t group, const bool* failed)
+{
+    constexpr size_t lanes = batch_lanes<T>;
+    for(size_t l = 0; l < lanes && group * lanes + l < status.failed.size(); l++)
+        status.failed[group * lanes + l] = failed[l];
+}
+
+template <typename T>
+void check_batch(const size_t size, const size_t count, const batched_vector<T>& b)
+{
+    if(b.GetSize() != size || b.GetCount() != count) [[unlikely]] throw std::runtime_error("Wrong batch sizes in solver");
+}
+
+// x = U^-1 b for every lane, U in the upper triangle of a
+template <typename T>
+void back_substitute_group(const group_matrix<const T> a, T* b, const bool assumeDiagonalOnes)
+{
+    constexpr size_t lanes = batch_lanes<T>;
+    for(size_t i = a.size; i-- > 0;)
+    {
+        for(size_t k = i + 1; k < a.size; k++)
+            subtract_product_lanes(b + i * lanes, a(k, i), b + k * lanes);
+        if(!assumeDiagonalOnes)
+            divide_lanes(b + i * lanes, a(i, i));
+    }
+}
+
+// x = L^-1 b for every lane, L in the lower triangle of a
+template <typename T>
+void forward_substitute_group(const group_matrix<const T> a, T* b, const bool assumeDiagonalOnes)
+{
+    constexpr size_t lanes = batch_lanes<T>;
+    for(size_t i = 0; i < a.size; i++)
+    {
+        for(size_t k = 0; k < i; k++)
+            subtract_product_lanes(b + i * lanes, a(k, i), b + k * lanes);
+        if(!assumeDiagonalOnes)
+            divide_lanes(b + i * lanes, a(i, i));
+    }
+}
+
+}
+
+template <typename T>
+batched_matrix<T>::batched_matrix(const size_t size, const size_t count)
+    : size(size), count(count), data((count + lanes - 1) / lanes * lanes * size * size, T(0))
+{
+    for(size_t system = count; system < GetGroupCount() * lanes; system++)
+        for(size_t i = 0; i < size; i++)
+            GetElement(system, i, i) = T(1);
+}
+
+template <typename T>
+void batched_matrix<T>::Set(const size_t system, const matrix_view<const T> a)
+{
+    if(a.GetSizeX() != size || a.GetSizeY() != size) [[unlikely]] throw std::runtime_error("Wrong matrix size for the batch");
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x < size; x++)
+            GetElement(system, x, y) = a.GetElement(x, y);
+}
+
+template <typename T>
+matrix<T> batched_matrix<T>::Get(const size_t system) const
+{
+    matrix<T> result{size, size};
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x < size; x++)
+            result.GetElement(x, y) = GetElement(system, x, y);
+    return result;
+}
+
+template <typename T>
+void batched_vector<T>::Set(const size_t system, const vector_view<const T> b)
+{
+    if(b.GetSize() != size) [[unlikely]] throw std::runtime_error("Wrong vector size for the batch");
+    for(size_t i = 0; i < size; i++)
+        GetElement(system, i) = b[i];
+}
+
+template <typename T>
+vector<T> batched_vector<T>::Get(const size_t system) const
+{
+    vector<T> result(size);
+    for(size_t i = 0; i < size; i++)
+        result[i] = GetElement(system, i);
+    return result;
+}
+
+template <typename T>
+batch_status solve_matrix_eq_gauss_batched(batched_matrix<T>& a, batched_vector<T>& b, size_t threads)
+{
+    detail::check_batch(a.GetSize(), a.GetCount(), b);
+    constexpr size_t lanes = batch_lanes<T>;
+    const size_t size = a.GetSize();
+    batch_status status{std::vector<unsigned char>(a.GetCount(), 0)};
+
+    detail::for_each_group<T>(a.GetGroupCount(), threads, [&](const size_t group)
+    {
+        const detail::group_matrix<T> m{a.GetGroup(group), size};
+        T* rhs = b.GetGroup(group);
+        alignas(64) T maxAbs[lanes];
+        alignas(64) T pivot[lanes];
+        alignas(64) T inverse[lanes];
+        bool failed[lanes] = {};
+
+        for(size_t d = 0; d < size; d++)
+        {
+            // pivot row per lane, kept as a T so the selects below stay in one vector type
+            for(size_t l = 0; l < lanes; l++)
+            {
+                maxAbs[l] = std::abs(m(d, d)[l]);
+                pivot[l] = T(d);
+            }
+            for(size_t i = d + 1; i < size; i++)
+                detail::select_pivot_lanes(m(d, i), T(i), maxAbs, pivot);
+            for(size_t l = 0; l < lanes; l++)
+                failed[l] |= maxAbs[l] == T(0);
+
+            // swap row d with the pivot row in the lanes that chose row i
+            for(size_t i = d + 1; i < size; i++)
+            {
+                bool any = false;
+                for(size_t l = 0; l < lanes; l++)
+                    any |= pivot[l] == T(i);
+                if(!any) continue;
+
+                for(size_t k = d; k < size; k++)
+                    detail::swap_selected_lanes(m(k, d), m(k, i), pivot, T(i));
+                detail::swap_selected_lanes(rhs + d * lanes, rhs + i * lanes, pivot, T(i));
+            }
+
+            const T* diagonal = m(d, d);
+            for(size_t l = 0; l < lanes; l++)
+                inverse[l] = T(1) / diagonal[l];
+            for(size_t i = d + 1; i < size; i++)
+            {
+                T* multiplier = m(d, i);
+                for(size_t l = 0; l < lanes; l++)
+                    multiplier[l] *= inverse[l];
+                for(size_t k = d + 1; k < size; k++)
+                    detail::subtract_product_lanes(m(k, i), multiplier, m(k, d));
+                detail::subtract_product_lanes(rhs + i * lanes, multiplier, rhs + d * lanes);
+            }
+        }
+
+        detail::back_substitute_group<T>({m.data, size}, rhs, false);
+        detail::record_failed_lanes<T>(status, group, failed);
+    });
+    return status;
+}
+
+template <typename T>
+batch_status lu_decomposition_batched(batched_matrix<T>& a, size_t threads)
+{
+    constexpr size_t lanes = batch_lanes<T>;
+    const size_t size = a.GetSize();
+    batch_status status{std::vector<unsigned char>(a.GetCount(), 0)};
+
+    detail::for_each_group<T>(a.GetGroupCount(), threads, [&](const size_t group)
+    {
+        const detail::group_matrix<T> m{a.GetGroup(group), size};
+        alignas(64) T inverse[lanes];
+        bool failed[lanes] = {};
+        for(size_t d = 0; d < size; d++)
+        {
+            const T* diagonal = m(d, d);
+            for(size_t l = 0; l < lanes; l++)
+            {
+                failed[l] |= diagonal[l] == T(0);
+                inverse[l] = T(1) / diagonal[l];
+            }
+            for(size_t i = d + 1; i < size; i++)
+            {
+                T* multiplier = m(d, i);
+                for(size_t l = 0; l < lanes; l++)
+                    multiplier[l] *= inverse[l];
+                for(size_t k = d + 1; k < size; k++)
+                    detail::subtract_product_lanes(m(k, i), multiplier, m(k, d));
+            }
+        }
+        detail::record_failed_lanes<T>(status, group, failed);
+    });
+    return status;
+}
+
+template <typename T>
+batch_status llt_decomposition_batched(batched_matrix<T>& a, size_t threads)
+{
+    constexpr size_t lanes = batch_lanes<T>;
+    const size_t size = a.GetSize();
+    batch_status status{std::vector<unsigned char>(a.GetCount(), 0)};
+
+    detail::for_each_group<T>(a.GetGroupCount(), threads, [&](const size_t group)
+    {
+        const detail::group_matrix<T> m{a.GetGroup(group), size};
+        bool failed[lanes] = {};
+        for(size_t i = 0; i < size; i++)
+        {
+            for(size_t j = 0; j < i; j++)
+            {
+                T* lij = m(j, i);
+                for(size_t k = 0; k < j; k++)
+                    detail::subtract_product_lanes(lij, m(k, j), m(k, i));
+                const T* ljj = m(j, j);
+                T* mirror = m(i, j);
+                for(size_t l = 0; l < lanes; l++)
+                {
+                    lij[l] /= ljj[l];
+                    mirror[l] = lij[l];
+                }
+            }
+
+            T* lii = m(i, i);
+            for(size_t k = 0; k < i; k++)
+                detail::subtract_product_lanes(lii, m(k, i), m(k, i));
+            for(size_t l = 0; l < lanes; l++)
+            {
+                failed[l] |= !(lii[l] > T(0));
+                lii[l] = std::sqrt(lii[l]);
+            }
+        }
+        detail::record_failed_lanes<T>(status, group, failed);
+    });
+    return status;
+}
+
+template <typename T>
+void solve_matrix_eq_with_lu_batched(const batched_matrix<T>& lu, batched_vector<T>& b, size_t threads)
+{
+    detail::check_batch(lu.GetSize(), lu.GetCount(), b);
+    constexpr bool assume_diagonal_ones = true;
+    detail::for_each_group<T>(lu.GetGroupCount(), threads, [&](const size_t group)
+    {
+        const detail::group_matrix<const T> m{lu.GetGroup(group), lu.GetSize()};
+        detail::forward_substitute_group(m, b.GetGroup(group), assume_diagonal_ones);
+        detail::back_substitute_group(m, b.GetGroup(group), false);
+    });
+}
+
+template <typename T>
+void solve_matrix_eq_with_llt_batched(const batched_matrix<T>& llt, batched_vector<T>& b, size_t threads)
+{
+    detail::check_batch(llt.GetSize(), llt.GetCount(), b);
+    detail::for_each_group<T>(llt.GetGroupCount(), threads, [&](const size_t group)
+    {
+        const detail::group_matrix<const T> m{llt.GetGroup(group), llt.GetSize()};
+        detail::forward_substitute_group(m, b.GetGroup(group), false);
+        detail::back_substitute_group(m, b.GetGroup(group), false);
+    });
+}
+
+template <typename T>
+void solve_tridiagonal_matrix_eq_batched(batched_vector<T>& lower, batched_vector<T>& diagonal, const batched_vector<T>& upper,
+                                         batched_vector<T>& b, size_t threads)
+{
+    const size_t size = b.GetSize();
+    detail::check_batch(size, b.GetCount(), diagonal);
+    detail::check_batch(size == 0 ? 0 : size - 1, b.GetCount(), lower);
+    detail::check_batch(size == 0 ? 0 : size - 1, b.GetCount(), upper);
+    if(size == 0) return;
+
+    constexpr size_t lanes = batch_lanes<T>;
+    detail::for_each_group<T>(b.GetGroupCount(), threads, [&](const size_t group)
+    {
+        T* l = lower.GetGroup(group);
+        T* d = diagonal.GetGroup(group);
+        const T* u = upper.GetGroup(group);
+        T* x = b.GetGroup(group);
+
+        for(size_t i = 1; i < size; i++)
+        {
+            T* li = l + (i - 1) * lanes;
+            detail::divide_lanes(li, d + (i - 1) * lanes);
+            detail::subtract_product_lanes(d + i * lanes, li, u + (i - 1) * lanes);
+            detail::subtract_product_lanes(x + i * lanes, li, x + (i - 1) * lanes);
+        }
+
+        detail::divide_lanes(x + (size - 1) * lanes, d + (size - 1) * lanes);
+        for(size_t i = size - 1; i-- > 0;)
+        {
+            detail::subtract_product_lanes(x + i * lanes, u + i * lanes, x + (i + 1) * lanes);
+            detail::divide_lanes(x + i * lanes, d + i * lanes);
+        }
+    });
+}
+
+#define NUMERICALS_INSTANTIATE_BATCHED_SOLVER(T) \
+    template class batched_matrix<T>; \
+    template class batched_vector<T>; \
+    template batch_status solve_matrix_eq_gauss_batched<T>(batched_matrix<T>&, batched_vector<T>&, size_t); \
+    template batch_status lu_decomposition_batched<T>(batched_matrix<T>&, size_t); \
+    template batch_status llt_decomposition_batched<T>(batched_matrix<T>&, size_t); \
+    template void solve_matrix_eq_with_lu_batched<T>(const batched_matrix<T>&, batched_vector<T>&, size_t); \
+    template void solve_matrix_eq_with_llt_batched<T>(const batched_matrix<T>&, batched_vector<T>&, size_t); \
+    template void solve_tridiagonal_matrix_eq_batched<T>(batched_vector<T>&, batched_vector<T>&, const batched_vector<T>&, batched_vector<T>&, size_t);
+
+NUMERICALS_INSTANTIATE_BATCHED_SOLVER(float)
+NUMERICALS_INSTANTIATE_BATCHED_SOLVER(double)
+NUMERICALS_INSTANTIATE_BATCHED_SOLVER(long double)
+#undef NUMERICALS_INSTANTIATE_BATCHED_SOLVER
+
+}
@@ -0,0 +1,182 @@
+#include "Factorization.h"
+#include "MatrixDecomposer.h"
+#include "trsm.h"
+#include "utils.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace numericals {
+
+namespace detail {
+
+template <typename T>
+void check_square(const matrix<T>& a)
+{
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Factorization of a non-square matrix");
+}
+
+}
+
+template <typename T>
+void Factorization<T>::SolveInPlace(vector<T>& b) const
+{
+    if(b.GetSize() != GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+    SolveInPlace(matrix_view<T>(b.GetData(), 1, b.GetSize(), 1));
+}
+
+template <typename T>
+vector<T> Factorization<T>::Solve(const vector<T>& b) const
+{
+    vector<T> x = b;
+    SolveInPlace(x);
+    if(GetSizeX() == GetSizeY()) return x;
+
+    vector<T> result(GetSizeX());
+    result.View() = x.View().Subview(0, GetSizeX());
+    return result;
+}
+
+template <typename T>
+matrix<T> Factorization<T>::Solve(const matrix<T>& b) const
+{
+    if(b.GetSizeY() != GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+
+    matrix<T> x = b;
+    SolveInPlace(x.View());
+    if(GetSizeX() == GetSizeY()) return x;
+
+    matrix<T> result{b.GetSizeX(), GetSizeX()};
+    for(size_t i = 0; i < GetSizeX(); i++)
+        result.Row(i) = x.Row(i);
+    return result;
+}
+
+template <typename T>
+LUFactorization<T>::LUFactorization(const matrix<T>& a) : lu(0, 0)
+{
+    detail::check_square(a);
+    std::tie(lu, permutation) = lu_decomposition_with_pivoting(a);
+
+    // position[r] is where original row r currently sits while the swaps are replayed
+    const size_t size = permutation.size();
+    scratch_vector<size_t> current(size), position(size);
+    for(size_t i = 0; i < size; i++)
+        current[i] = position[i] = i;
+    swaps.resize(size);
+    for(size_t i = 0; i < size; i++)
+    {
+        const size_t from = position[permutation[i]];
+        swaps[i] = from;
+        std::swap(current[i], current[from]);
+        position[current[i]] = i;
+        position[current[from]] = from;
+    }
+}
+
+template <typename T>
+void LUFactorization<T>::SolveInPlace(const matrix_view<T> b) const
+{
+    if(b.GetSizeY() != GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+
+    for(size_t i = 0; i < swaps.size(); i++)
+        if(swaps[i] != i)
+            swap_slices(b.Row(i), b.Row(swaps[i]));
+
+    constexpr bool assume_diagonal_ones = true;
+    trsm<T>(triangle::lower, false, assume_diagonal_ones, lu.View(), b);
+    trsm<T>(triangle::upper, false, false, lu.View(), b);
+}
+
+template <typename T>
+LDLTFactorization<T>::LDLTFactorization(const matrix<T>& a) : ldlt(0, 0)
+{
+    detail::check_square(a);
+    ldlt = ldlt_decomposition(a);
+}
+
+template <typename T>
+void LDLTFactorization<T>::SolveInPlace(const matrix_view<T> b) const
+{
+    if(b.GetSizeY() != GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+
+    constexpr bool assume_diagonal_ones = true;
+    trsm<T>(triangle::lower, false, assume_diagonal_ones, ldlt.View(), b);
+    for(size_t i = 0; i < GetSizeY(); i++)
+        b.Row(i) /= ldlt.GetElement(i, i);
+    trsm<T>(triangle::upper, false, assume_diagonal_ones, ldlt.View(), b);
+}
+
+template <typename T>
+LLTFactorization<T>::LLTFactorization(const matrix<T>& a) : llt(0, 0)
+{
+    detail::check_square(a);
+    llt = a;
+    llt_decomposition_in_place(llt.View());
+}
+
+template <typename T>
+void LLTFactorization<T>::SolveInPlace(const matrix_view<T> b) const
+{
+    if(b.GetSizeY() != GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+
+    constexpr bool transposed = true;
+    trsm<T>(triangle::lower, false, false, llt.View(), b);
+    trsm<T>(triangle::lower, transposed, false, llt.View(), b);
+}
+
+template <typename T>
+QRFactorization<T>::QRFactorization(const matrix<T>& a) : qr(a)
+{
+    if(a.GetSizeY() < a.GetSizeX()) [[unlikely]] throw std::runtime_error("QR factorization needs at least as many rows as columns");
+
+    tau = qr_decomposition_in_place(qr.View());
+}
+
+template <typename T>
+void QRFactorization<T>::ApplyQTransposed(const matrix_view<T> b) const
+{
+    if(b.GetSizeY() != GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+
+    constexpr bool transposed = true;
+    apply_householder_q<T>(qr.View(), tau, b, transposed);
+}
+
+template <typename T>
+void QRFactorization<T>::ApplyQ(const matrix_view<T> b) const
+{
+    if(b.GetSizeY() != GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+
+    apply_householder_q<T>(qr.View(), tau, b, false);
+}
+
+template <typename T>
+matrix<T> QRFactorization<T>::GetR() const
+{
+    matrix<T> r{GetSizeX(), GetSizeX()};
+    for(size_t y = 0; y < GetSizeX(); y++)
+        r.Row(y, y) = qr.Row(y, y);
+    return r;
+}
+
+template <typename T>
+void QRFactorization<T>::SolveInPlace(const matrix_view<T> b) const
+{
+    ApplyQTransposed(b);
+    trsm<T>(triangle::upper, false, false, qr.View().Block(0, 0, GetSizeX(), GetSizeX()), b.Block(0, 0, b.GetSizeX(), GetSizeX()));
+}
+
+#define NUMERICALS_INSTANTIATE_FACTORIZATION(T) \
+    template class Factorization<T>; \
+    template class LUFactorization<T>; \
+    template class LDLTFactorization<T>; \
+    template class LLTFactorization<T>; \
+    template class QRFactorization<T>;
+
+NUMERICALS_INSTANTIATE_FACTORIZATION(float)
+NUMERICALS_INSTANTIATE_FACTORIZATION(double)
+NUMERICALS_INSTANTIATE_FACTORIZATION(long double)
+#undef NUMERICALS_INSTANTIATE_FACTORIZATION
+
+}
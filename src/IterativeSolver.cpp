@@ -0,0 +1,446 @@
+#include "IterativeSolver.h"
+#include "MatrixDecomposer.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace numericals {
+
+namespace detail {
+
+constexpr size_t no_diagonal = size_t(-1);
+
+template <typename T>
+T norm(const vector_view<const T> v)
+{
+    return std::sqrt(dot(v, v));
+}
+
+template <typename T>
+void check_iterative_sizes(const vector<T>& b, const vector<T>& x)
+{
+    if(b.GetSize() != x.GetSize()) [[unlikely]] throw std::runtime_error("Wrong vector sizes in iterative solver");
+}
+
+// Records one iteration in the report and tells the monitor; true once converged
+template <typename T>
+bool record_iteration(iterative_report<T>& report, const iterative_controls<T>& controls, const T residual)
+{
+    report.iterations++;
+    report.residual = residual;
+    report.converged = residual <= controls.tolerance;
+    if(controls.monitor) controls.monitor(report.iterations, residual);
+    return report.converged;
+}
+
+// r = b - A x; returns ||r|| / ||b|| (||r|| for a zero b)
+template <typename T>
+T residual(const linear_operator<T>& a, const vector<T>& b, const vector<T>& x, vector<T>& r, const T bNorm)
+{
+    a(x.View(), r.View());
+    r.View() *= T(-1);
+    r.View() += b.View();
+    const T rNorm = norm<T>(r.View());
+    return bNorm > T(0) ? rNorm / bNorm : rNorm;
+}
+
+template <typename T>
+size_t find_diagonal(const csr_matrix<T>& a, const size_t row)
+{
+    const auto& offsets = a.GetOffsets();
+    const auto& indices = a.GetIndices();
+    for(size_t p = offsets[row]; p < offsets[row + 1]; p++)
+        if(indices[p] == row)
+            return p;
+    return no_diagonal;
+}
+
+template <typename T>
+void check_preconditioner_square(const size_t sizeX, const size_t sizeY)
+{
+    if(sizeX != sizeY) [[unlikely]] throw std::runtime_error("Preconditioner of a non-square matrix");
+}
+
+}
+
+template <typename T>
+linear_operator<T> as_operator(const matrix<T>& a)
+{
+    return [&a](const vector_view<const T> x, const vector_view<T> y)
+    {
+        if(x.GetSize() != a.GetSizeX() || y.GetSize() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in operator");
+        for(size_t r = 0; r < a.GetSizeY(); r++)
+            y[r] = dot(a.Row(r), x);
+    };
+}
+
+template <typename T>
+linear_operator<T> as_operator(const csr_matrix<T>& a, const size_t threads)
+{
+    return [&a, threads](const vector_view<const T> x, const vector_view<T> y) { multiply(a, x, y, threads); };
+}
+
+template <typename T>
+JacobiPreconditioner<T>::JacobiPreconditioner(const matrix<T>& a) : inverseDiagonal(a.GetSizeY())
+{
+    detail::check_preconditioner_square<T>(a.GetSizeX(), a.GetSizeY());
+    for(size_t i = 0; i < inverseDiagonal.size(); i++)
+    {
+        if(a.GetElement(i, i) == T(0)) [[unlikely]] throw std::runtime_error("Zero diagonal in jacobi preconditioner");
+        inverseDiagonal[i] = T(1) / a.GetElement(i, i);
+    }
+}
+
+template <typename T>
+JacobiPreconditioner<T>::JacobiPreconditioner(const csr_matrix<T>& a) : inverseDiagonal(a.GetSizeY())
+{
+    detail::check_preconditioner_square<T>(a.GetSizeX(), a.GetSizeY());
+    for(size_t i = 0; i < inverseDiagonal.size(); i++)
+    {
+        const size_t p = detail::find_diagonal(a, i);
+        if(p == detail::no_diagonal || a.GetValues()[p] == T(0)) [[unlikely]] throw std::runtime_error("Zero diagonal in jacobi preconditioner");
+        inverseDiagonal[i] = T(1) / a.GetValues()[p];
+    }
+}
+
+template <typename T>
+void JacobiPreconditioner<T>::Apply(const vector_view<const T> r, const vector_view<T> z) const
+{
+    for(size_t i = 0; i < inverseDiagonal.size(); i++)
+        z[i] = inverseDiagonal[i] * r[i];
+}
+
+template <typename T>
+ILU0Preconditioner<T>::ILU0Preconditioner(const csr_matrix<T>& a) : lu(a), diagonal(a.GetSizeY())
+{
+    detail::check_preconditioner_square<T>(a.GetSizeX(), a.GetSizeY());
+    const size_t n = a.GetSizeY();
+    const auto& offsets = lu.GetOffsets();
+    const auto& indices = lu.GetIndices();
+    auto& values = lu.GetValues();
+    for(size_t i = 0; i < n; i++)
+    {
+        diagonal[i] = detail::find_diagonal(lu, i);
+        if(diagonal[i] == detail::no_diagonal) [[unlikely]] throw std::runtime_error("Missing diagonal in ilu preconditioner");
+    }
+
+    // IKJ elimination in which every update outside the pattern of a is dropped
+    std::vector<size_t> where(n, detail::no_diagonal);
+    for(size_t i = 0; i < n; i++)
+    {
+        for(size_t p = offsets[i]; p < offsets[i + 1]; p++)
+            where[indices[p]] = p;
+        for(size_t p = offsets[i]; p < diagonal[i]; p++)
+        {
+            const size_t k = indices[p];
+            if(values[diagonal[k]] == T(0)) [[unlikely]] throw std::runtime_error("Zero pivot in ilu preconditioner");
+            const T multiplier = values[p] /= values[diagonal[k]];
+            for(size_t q = diagonal[k] + 1; q < offsets[k + 1]; q++)
+                if(where[indices[q]] != detail::no_diagonal)
+                    values[where[indices[q]]] -= multiplier * values[q];
+        }
+        for(size_t p = offsets[i]; p < offsets[i + 1]; p++)
+            where[indices[p]] = detail::no_diagonal;
+    }
+}
+
+template <typename T>
+void ILU0Preconditioner<T>::Apply(const vector_view<const T> r, const vector_view<T> z) const
+{
+    const auto& offsets = lu.GetOffsets();
+    const auto& indices = lu.GetIndices();
+    const auto& values = lu.GetValues();
+    const size_t n = diagonal.size();
+    for(size_t i = 0; i < n; i++)
+    {
+        T sum = r[i];
+        for(size_t p = offsets[i]; p < diagonal[i]; p++)
+            sum -= values[p] * z[indices[p]];
+        z[i] = sum;
+    }
+    for(size_t i = n; i-- > 0;)
+    {
+        T sum = z[i];
+        for(size_t p = diagonal[i] + 1; p < offsets[i + 1]; p++)
+            sum -= values[p] * z[indices[p]];
+        z[i] = sum / values[diagonal[i]];
+    }
+}
+
+template <typename T>
+IncompleteCholeskyPreconditioner<T>::IncompleteCholeskyPreconditioner(const csr_matrix<T>& a) : l(0, 0)
+{
+    detail::check_preconditioner_square<T>(a.GetSizeX(), a.GetSizeY());
+    const size_t n = a.GetSizeY();
+    const auto& aOffsets = a.GetOffsets();
+    const auto& aIndices = a.GetIndices();
+    const auto& aValues = a.GetValues();
+
+    // the lower pattern of a, row by row
+    std::vector<size_t> offsets(n + 1, 0), indices;
+    std::vector<T> values;
+    for(size_t i = 0; i < n; i++)
+    {
+        for(size_t p = aOffsets[i]; p < aOffsets[i + 1] && aIndices[p] <= i; p++)
+        {
+            indices.push_back(aIndices[p]);
+            values.push_back(aValues[p]);
+        }
+        if(indices.size() == offsets[i] || indices.back() != i) [[unlikely]] throw std::runtime_error("Missing diagonal in incomplete cholesky preconditioner");
+        offsets[i + 1] = indices.size();
+    }
+
+    // L(i, k) = (A(i, k) - sum_j L(i, j) L(k, j)) / L(k, k) over the shared pattern of rows i and k
+    for(size_t i = 0; i < n; i++)
+    {
+        for(size_t p = offsets[i]; p < offsets[i + 1]; p++)
+        {
+            const size_t k = indices[p];
+            T sum = values[p];
+            for(size_t pi = offsets[i], pk = offsets[k]; pi < p && indices[pk] < k;)
+            {
+                if(indices[pi] < indices[pk]) pi++;
+                else if(indices[pk] < indices[pi]) pk++;
+                else sum -= values[pi++] * values[pk++];
+            }
+            if(k < i)
+                values[p] = sum / values[offsets[k + 1] - 1];
+            else
+            {
+                if(!(sum > T(0))) [[unlikely]] throw not_positive_definite(i);
+                values[p] = std::sqrt(sum);
+            }
+        }
+    }
+    l = csr_matrix<T>(n, n, std::move(offsets), std::move(indices), std::move(values));
+}
+
+template <typename T>
+void IncompleteCholeskyPreconditioner<T>::Apply(const vector_view<const T> r, const vector_view<T> z) const
+{
+    const auto& offsets = l.GetOffsets();
+    const auto& indices = l.GetIndices();
+    const auto& values = l.GetValues();
+    const size_t n = l.GetSizeY();
+    for(size_t i = 0; i < n; i++)
+    {
+        T sum = r[i];
+        for(size_t p = offsets[i]; p + 1 < offsets[i + 1]; p++)
+            sum -= values[p] * z[indices[p]];
+        z[i] = sum / values[offsets[i + 1] - 1];
+    }
+
+    // L^T by columns: row i of L is column i of L^T
+    for(size_t i = n; i-- > 0;)
+    {
+        z[i] /= values[offsets[i + 1] - 1];
+        for(size_t p = offsets[i]; p + 1 < offsets[i + 1]; p++)
+            z[indices[p]] -= values[p] * z[i];
+    }
+}
+
+template <typename T>
+iterative_report<T> solve_matrix_eq_cg(const linear_operator<T>& a, const vector<T>& b, vector<T>& x,
+                                       const Preconditioner<T>& preconditioner, const iterative_controls<T>& controls)
+{
+    detail::check_iterative_sizes(b, x);
+    const size_t n = b.GetSize();
+    const T bNorm = detail::norm<T>(b.View());
+    vector<T> r(n), z(n), p(n), q(n);
+
+    iterative_report<T> report;
+    report.residual = detail::residual(a, b, x, r, bNorm);
+    report.converged = report.residual <= controls.tolerance;
+    if(report.converged) return report;
+
+    preconditioner.Apply(r.View(), z.View());
+    p.View() = z.View();
+    T rz = dot(r.View(), z.View());
+    while(report.iterations < controls.max_iterations)
+    {
+        a(p.View(), q.View());
+        const T pq = dot(p.View(), q.View());
+        if(!(pq > T(0)) || !std::isfinite(pq)) break;
+        const T alpha = rz / pq;
+        x.View().AddScaled(alpha, p.View());
+        r.View().AddScaled(-alpha, q.View());
+        const T rNorm = detail::norm<T>(r.View());
+        if(detail::record_iteration(report, controls, bNorm > T(0) ? rNorm / bNorm : rNorm)) break;
+
+        preconditioner.Apply(r.View(), z.View());
+        const T rzNext = dot(r.View(), z.View());
+        p.View() *= rzNext / rz;
+        p.View() += z.View();
+        rz = rzNext;
+    }
+    return report;
+}
+
+template <typename T>
+iterative_report<T> solve_matrix_eq_bicgstab(const linear_operator<T>& a, const vector<T>& b, vector<T>& x,
+                                             const Preconditioner<T>& preconditioner, const iterative_controls<T>& controls)
+{
+    detail::check_iterative_sizes(b, x);
+    const size_t n = b.GetSize();
+    const T bNorm = detail::norm<T>(b.View());
+    const auto relative = [bNorm](const T value) { return bNorm > T(0) ? value / bNorm : value; };
+    vector<T> r(n), shadow(n), p(n), v(n), pHat(n), s(n), sHat(n), t(n);
+
+    iterative_report<T> report;
+    report.residual = detail::residual(a, b, x, r, bNorm);
+    report.converged = report.residual <= controls.tolerance;
+    if(report.converged) return report;
+
+    shadow.View() = r.View();
+    T rho = T(1), alpha = T(1), omega = T(1);
+    while(report.iterations < controls.max_iterations)
+    {
+        const T rhoNext = dot(shadow.View(), r.View());
+        if(rhoNext == T(0)) break;
+
+        // p = r + beta (p - omega v)
+        const T beta = (rhoNext / rho) * (alpha / omega);
+        p.View().AddScaled(-omega, v.View());
+        p.View() *= beta;
+        p.View() += r.View();
+        preconditioner.Apply(p.View(), pHat.View());
+        a(pHat.View(), v.View());
+        alpha = rhoNext / dot(shadow.View(), v.View());
+
+        s.View() = r.View();
+        s.View().AddScaled(-alpha, v.View());
+        const T sNorm = relative(detail::norm<T>(s.View()));
+        if(sNorm <= controls.tolerance)
+        {
+            x.View().AddScaled(alpha, pHat.View());
+            detail::record_iteration(report, controls, sNorm);
+            break;
+        }
+
+        preconditioner.Apply(s.View(), sHat.View());
+        a(sHat.View(), t.View());
+        const T tt = dot(t.View(), t.View());
+        omega = tt > T(0) ? dot(t.View(), s.View()) / tt : T(0);
+        x.View().AddScaled(alpha, pHat.View());
+        x.View().AddScaled(omega, sHat.View());
+        r.View() = s.View();
+        r.View().AddScaled(-omega, t.View());
+        if(detail::record_iteration(report, controls, relative(detail::norm<T>(r.View()))) || omega == T(0)) break;
+        rho = rhoNext;
+    }
+    return report;
+}
+
+template <typename T>
+iterative_report<T> solve_matrix_eq_gmres(const linear_operator<T>& a, const vector<T>& b, vector<T>& x,
+                                          const Preconditioner<T>& preconditioner, const iterative_controls<T>& controls)
+{
+    detail::check_iterative_sizes(b, x);
+    if(controls.restart == 0) [[unlikely]] throw std::runtime_error("GMRES needs a positive restart length");
+
+    const size_t n = b.GetSize();
+    const size_t m = controls.restart;
+    const T bNorm = detail::norm<T>(b.View());
+    const auto relative = [bNorm](const T value) { return bNorm > T(0) ? value / bNorm : value; };
+
+    // orthonormal Krylov basis by rows, the Hessenberg matrix turned triangular by Givens rotations
+    matrix<T> basis{n, m + 1};
+    matrix<T> h{m, m + 1};
+    std::vector<T> cosines(m), sines(m), g(m + 1);
+    vector<T> r(n), w(n), z(n);
+
+    iterative_report<T> report;
+    report.residual = detail::residual(a, b, x, r, bNorm);
+    report.converged = report.residual <= controls.tolerance;
+    bool breakdown = false;
+    while(!report.converged && !breakdown && report.iterations < controls.max_iterations)
+    {
+        const T beta = detail::norm<T>(r.View());
+        basis.Row(0) = r.View();
+        basis.Row(0) /= beta;
+        std::fill(g.begin(), g.end(), T(0));
+        g[0] = beta;
+
+        size_t k = 0;
+        while(k < m && report.iterations < controls.max_iterations)
+        {
+            preconditioner.Apply(basis.Row(k), z.View());
+            a(z.View(), w.View());
+            const T column = detail::norm<T>(w.View());
+
+            // modified Gram-Schmidt against the basis so far
+            for(size_t i = 0; i <= k; i++)
+            {
+                h.GetElement(k, i) = dot(w.View(), basis.Row(i));
+                w.View().AddScaled(-h.GetElement(k, i), basis.Row(i));
+            }
+            const T next = detail::norm<T>(w.View());
+            h.GetElement(k, k + 1) = next;
+            if(next > T(0))
+            {
+                basis.Row(k + 1) = w.View();
+                basis.Row(k + 1) /= next;
+            }
+
+            for(size_t i = 0; i < k; i++)
+            {
+                const T upper = h.GetElement(k, i), lower = h.GetElement(k, i + 1);
+                h.GetElement(k, i) = cosines[i] * upper + sines[i] * lower;
+                h.GetElement(k, i + 1) = -sines[i] * upper + cosines[i] * lower;
+            }
+            // A M^-1 v_k within rounding of the previous directions leaves H singular: stop and
+            // solve over the columns so far
+            const T radius = std::hypot(h.GetElement(k, k), next);
+            if(radius <= T(16) * std::numeric_limits<T>::epsilon() * column)
+            {
+                breakdown = true;
+                break;
+            }
+            cosines[k] = h.GetElement(k, k) / radius;
+            sines[k] = next / radius;
+            h.GetElement(k, k) = radius;
+            h.GetElement(k, k + 1) = T(0);
+            g[k + 1] = -sines[k] * g[k];
+            g[k] *= cosines[k];
+
+            k++;
+            if(detail::record_iteration(report, controls, relative(std::abs(g[k]))) || next == T(0)) break;
+        }
+
+        // y = H^-1 g, x += M^-1 V y
+        for(size_t i = k; i-- > 0;)
+        {
+            for(size_t j = i + 1; j < k; j++)
+                g[i] -= h.GetElement(j, i) * g[j];
+            g[i] /= h.GetElement(i, i);
+        }
+        w.View() = T(0);
+        for(size_t i = 0; i < k; i++)
+            w.View().AddScaled(g[i], basis.Row(i));
+        preconditioner.Apply(w.View(), z.View());
+        x.View() += z.View();
+
+        // the rotated residual estimate drifts over restarts; restart from the true one
+        report.residual = detail::residual(a, b, x, r, bNorm);
+        report.converged = report.residual <= controls.tolerance;
+    }
+    return report;
+}
+
+#define NUMERICALS_INSTANTIATE_ITERATIVE_SOLVER(T) \
+    template linear_operator<T> as_operator<T>(const matrix<T>&); \
+    template linear_operator<T> as_operator<T>(const csr_matrix<T>&, size_t); \
+    template class JacobiPreconditioner<T>; \
+    template class ILU0Preconditioner<T>; \
+    template class IncompleteCholeskyPreconditioner<T>; \
+    template iterative_report<T> solve_matrix_eq_cg<T>(const linear_operator<T>&, const vector<T>&, vector<T>&, const Preconditioner<T>&, const iterative_controls<T>&); \
+    template iterative_report<T> solve_matrix_eq_bicgstab<T>(const linear_operator<T>&, const vector<T>&, vector<T>&, const Preconditioner<T>&, const iterative_controls<T>&); \
+    template iterative_report<T> solve_matrix_eq_gmres<T>(const linear_operator<T>&, const vector<T>&, vector<T>&, const Preconditioner<T>&, const iterative_controls<T>&);
+
+NUMERICALS_INSTANTIATE_ITERATIVE_SOLVER(float)
+NUMERICALS_INSTANTIATE_ITERATIVE_SOLVER(double)
+NUMERICALS_INSTANTIATE_ITERATIVE_SOLVER(long double)
+#undef NUMERICALS_INSTANTIATE_ITERATIVE_SOLVER
+
+}
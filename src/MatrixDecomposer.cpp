@@ -1,109 +1,484 @@
 #include "MatrixDecomposer.h"
 #include "PivotingStrategy.h"
+#include "gemm.h"
+#include "gram.h"
+#include "instrumentation.h"
+#include "trsm.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
 
 namespace numericals
 {
 
-std::pair<matrix<real>, matrix<real>> qr_decomposition(const matrix<real>& a)
+template <typename T>
+matrix<T> ldlt_decomposition(const matrix<T>& a)
 {
-    matrix<real> q{a.GetSizeX(), a.GetSizeY()};
-    matrix<real> r{a.GetSizeX(), a.GetSizeX()};
- 
-    for(size_t k = 0; k < a.GetSizeX(); k++)
-    {    
-        q.GetColumnSlice(k) = a.GetColumn(k);
-        for(size_t i = 0; i < k; i++)
-            q.GetColumnSlice(k) -= q.GetColumn(i) * r.GetElement(k, i);
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix sizes in ldlt decomposition");
+    
+    size_t size = a.GetSizeX();
+    NUMERICALS_INSTRUMENT_CALL("ldlt_decomposition", size);
+    NUMERICALS_COUNT_WORK(2.0 / 3.0 * double(size) * double(size) * double(size),
+                          sizeof(T) * 2.0 / 3.0 * double(size) * double(size) * double(size));
+    NUMERICALS_INSTRUMENT_PHASE(factorization);
+    matrix<T> result = a;
+    if(size == 0) return result;
 
+    // Row by row on the lower triangle, as the packed ldlt: row i first collects
+    // t_j = L(i, j) D(j) from contiguous dot products with the finished rows above it
+    for(size_t i = 0; i < size; i++)
+    {
+        T* rowI = &result.GetElement(0, i);
+        for(size_t j = 0; j < i; j++)
+            rowI[j] -= std::inner_product(rowI, rowI + j, &result.GetElement(0, j), T(0));
 
-        r.GetElement(k, k) = 1.0;
-        for(size_t i = 0; i < k; i++)
+        T diagonal = rowI[i];
+        for(size_t k = 0; k < i; k++)
         {
-            std::cout << r << '\n' << q << '\n';
-            double d = vector<real>(q.GetColumn(k)) * vector<real>(q.GetColumn(k));
-            r.GetElement(k , i) = vector<real>(q.GetColumn(i)) * vector<real>(a.GetColumn(k))/d;
-        }        
+            const T l = rowI[k] / result.GetElement(k, k);
+            diagonal -= rowI[k] * l;
+            rowI[k] = l;
+        }
+        NUMERICALS_OBSERVE_PIVOT(diagonal);
+        if(diagonal == T(0)) [[unlikely]] throw std::runtime_error("Zero pivot in ldlt decomposition");
+        rowI[i] = diagonal;
     }
-    return { q, r };
+
+    for(size_t i = 0; i < size; i++)
+        for(size_t j = i + 1; j < size; j++)
+            result.GetElement(j, i) = result.GetElement(i, j);
+    return result;
 }
 
-matrix<real> llt_decomposition(const matrix<real>& a) 
+namespace detail {
+
+// Operation-count model reported to the instrumentation, as for unblocked elimination
+template <typename T>
+void count_lu_work(const size_t size)
 {
-    if(a.GetSizeY() != a.GetSizeY()) [[unlikely]] std::runtime_error("Wrong matrix-vector sizes in ldl decomposition");
- 
-    size_t size = a.GetSizeX();
-    matrix<real> result{size, size};
-    for(int i = 0; i < (int)size; i++)
+    const double n = double(size);
+    NUMERICALS_COUNT_WORK(2.0 / 3.0 * n * n * n, sizeof(T) * 2.0 / 3.0 * n * n * n);
+}
+
+// Right-looking blocked LU of the square view a, in place. Each block column is factored as a
+// tall panel; the block row right of it is solved against the panel's unit lower triangle and
+// the trailing submatrix gets a single GEMM update. When permutation is given, rows are
+// partially pivoted (whole rows are swapped) and the swaps are recorded in it; a column with no
+// nonzero candidate left throws. Without it, a zero pivot that would be divided by throws.
+template <typename T>
+void blocked_lu(const matrix_view<T> a, scratch_vector<size_t>* permutation)
+{
+    constexpr size_t block = 64;
+    const size_t size = a.GetSizeX();
+    const ptrdiff_t ld = a.GetLeadingDimension();
+
+    for(size_t j = 0; j < size; j += block)
     {
-        for(int j = 0; j < i; j++)
+        const size_t nb = std::min(block, size - j);
+        for(size_t d = j; d < j + nb; d++)
         {
-            result.GetElement(j, i) = a.GetElement(j, i);
-            for(int k = 0; k < j; k++)
-               result.GetElement(j, i) -= result.GetElement(k, j) * result.GetElement(k, i);
-            result.GetElement(j, i) /= result.GetElement(j, j);
+            if(permutation)
+            {
+                size_t pivot = d;
+                {
+                    NUMERICALS_INSTRUMENT_PHASE(pivot_search);
+                    T max = std::abs(a.GetElement(d, d));
+                    for(size_t i = d + 1; i < size; i++)
+                        if(std::abs(a.GetElement(d, i)) > max)
+                        {
+                            max = std::abs(a.GetElement(d, i));
+                            pivot = i;
+                        }
+                    if(max == T(0)) [[unlikely]] throw std::runtime_error("Singular matrix in lu decomposition");
+                }
+                if(pivot != d)
+                {
+                    NUMERICALS_INSTRUMENT_PHASE(swaps);
+                    NUMERICALS_COUNT_PIVOT_SWAP();
+                    swap_slices(a.Row(d), a.Row(pivot));
+                    std::swap((*permutation)[d], (*permutation)[pivot]);
+                }
+            }
+            // unpivoted, only the last pivot may be zero: it divides nothing here
+            else if(d + 1 < size && a.GetElement(d, d) == T(0)) [[unlikely]]
+                throw std::runtime_error("Zero pivot in lu decomposition");
+
+            NUMERICALS_INSTRUMENT_PHASE(factorization);
+            NUMERICALS_OBSERVE_PIVOT(a.GetElement(d, d));
+            const T inverse = T(1) / a.GetElement(d, d);
+            const auto pivotRow = a.Row(d).Subview(d + 1, j + nb - d - 1);
+            for(size_t i = d + 1; i < size; i++)
+            {
+                T& multiplier = a.GetElement(d, i);
+                multiplier *= inverse;
+                a.Row(i).Subview(d + 1, j + nb - d - 1).AddScaled(-multiplier, pivotRow);
+            }
         }
-        result.GetElement(i, i) = a.GetElement(i, i);
-        for(int k = 0; k < i; k++)
-            result.GetElement(i, i) -= pow(result.GetElement(k, i), 2);
-        result.GetElement(i, i) = sqrt(result.GetElement(i, i));
-    } 
 
-    for(size_t i = 0; i < size; i++)
-        for(size_t j = i + 1; j < size; j++)
-            result.GetElement(j, i) = result.GetElement(i, j);
-    return result;
+        const size_t rest = size - j - nb;
+        if(rest == 0) break;
+        NUMERICALS_INSTRUMENT_PHASE(factorization);
+
+        // U12 = L11^-1 A12
+        constexpr bool assume_diagonal_ones = true;
+        trsm<T>(triangle::lower, false, assume_diagonal_ones, a.Block(j, j, nb, nb), a.Block(j + nb, j, rest, nb));
+
+        // A22 -= L21 U12
+        gemm<T>(rest, rest, nb, T(-1),
+                &a.GetElement(j, j + nb), ld, 1,
+                &a.GetElement(j + nb, j), ld, 1,
+                T(1), &a.GetElement(j + nb, j + nb), ld, 1);
+    }
 }
 
-matrix<real> ldlt_decomposition(const matrix<real>& a)
+// Unblocked Cholesky of the diagonal block at (j, j) of edge nb, whose earlier columns have
+// already been subtracted. l(i, k) is element (row i, column k) of the factor L; indices in the
+// error are global.
+template <typename T, typename Factor>
+void llt_diagonal_block(const Factor& l, const size_t j, const size_t nb)
 {
-    if(a.GetSizeY() != a.GetSizeY()) [[unlikely]] std::runtime_error("Wrong matrix-vector sizes in ldlt decomposition");
-    
-    size_t size = a.GetSizeX();
-    matrix<real> result {size, size};
-    result.GetElement(0, 0) = a.GetElement(0, 0); 
-    for(size_t i = 1; i < size; i++)
+    for(size_t d = j; d < j + nb; d++)
     {
-        for(size_t j = 0; j < i; j++)
+        T pivot = l(d, d);
+        for(size_t k = j; k < d; k++)
+            pivot -= l(d, k) * l(d, k);
+        if(!(pivot > T(0))) [[unlikely]] throw not_positive_definite(d);
+
+        const T diagonal = std::sqrt(pivot);
+        NUMERICALS_OBSERVE_PIVOT(diagonal);
+        l(d, d) = diagonal;
+        for(size_t i = d + 1; i < j + nb; i++)
+        {
+            T sum = l(i, d);
+            for(size_t k = j; k < d; k++)
+                sum -= l(i, k) * l(d, k);
+            l(i, d) = sum / diagonal;
+        }
+    }
+}
+
+// Right-looking blocked Cholesky of the square view a, touching only the triangle named by part:
+// L is built in the lower triangle, or L^T in the upper one. The block column under each
+// factored diagonal block is solved against it with trsm (through a transposed copy when L is
+// stored by rows), and the trailing triangle gets a single syrk_lower update.
+template <typename T>
+void blocked_llt(const matrix_view<T> a, const triangle part, const size_t threads)
+{
+    constexpr size_t block = 64;
+    const size_t size = a.GetSizeX();
+    const bool upper = part == triangle::upper;
+    const ptrdiff_t ld = a.GetLeadingDimension();
+    const ptrdiff_t rs = upper ? 1 : ld;
+    const ptrdiff_t cs = upper ? ld : 1;
+    const auto l = [data = a.GetData(), rs, cs](const size_t i, const size_t k) -> T& { return data[ptrdiff_t(i) * rs + ptrdiff_t(k) * cs]; };
+    scratch_vector<T> panel;
+
+    for(size_t j = 0; j < size; j += block)
+    {
+        const size_t nb = std::min(block, size - j);
+        llt_diagonal_block<T>(l, j, nb);
+
+        const size_t rest = size - j - nb;
+        if(rest == 0) break;
+
+        // L21 = A21 L11^-T, solved as L11 L21^T = A21^T; the upper layout already stores A21^T by rows
+        constexpr bool transposed = true;
+        if(upper)
+            trsm<T>(triangle::upper, transposed, false, a.Block(j, j, nb, nb), a.Block(j + nb, j, rest, nb));
+        else
         {
-            auto& l = result.GetElement(j, i);
-            auto& c = result.GetElement(i, j);
-            
-            l = a.GetElement(j, i);
-            for(size_t k = 0; k < j; k++)
-                l -= result.GetElement(i, k) * result.GetElement(k, j);
-            l /= result.GetElement(j, j);
-
-            c = result.GetElement(j, j) * l;
-            result.GetElement(i, i) = a.GetElement(i, i);
-            
+            panel.resize(nb * rest);
+            const matrix_view<T> l21t(panel.data(), rest, nb, rest);
+            for(size_t i = 0; i < rest; i++)
+                for(size_t k = 0; k < nb; k++)
+                    l21t.GetElement(i, k) = l(j + nb + i, j + k);
+            trsm<T>(triangle::lower, false, false, a.Block(j, j, nb, nb), l21t);
+            for(size_t i = 0; i < rest; i++)
+                for(size_t k = 0; k < nb; k++)
+                    l(j + nb + i, j + k) = l21t.GetElement(i, k);
+        }
+
+        // A22 -= L21 L21^T
+        syrk_lower<T>(rest, nb, T(-1), &l(j + nb, j), rs, cs, &l(j + nb, j + nb), rs, cs, threads);
+    }
+}
+
+// Unblocked Householder QR of the columns [j, j + nb) of a, from row j down; the reflectors are
+// applied to those columns only. H = I - tau v v^T with v = (1, x[1:] / (x0 - alpha)) maps the
+// column x onto alpha e1.
+template <typename T>
+void householder_panel(const matrix_view<T> a, T* tau, const size_t j, const size_t nb)
+{
+    const size_t rows = a.GetSizeY();
+    scratch_vector<T> w(nb);
+    for(size_t c = j; c < j + nb; c++)
+    {
+        const auto x = a.Column(c, c);
+        const T norm = std::sqrt(dot(x, x));
+        tau[c] = T(0);
+        if(norm == T(0)) continue;
+
+        const T x0 = x[0];
+        const T alpha = x0 > T(0) ? -norm : norm;
+        NUMERICALS_OBSERVE_PIVOT(alpha);
+        tau[c] = (alpha - x0) / alpha;
+        x.Subview(1, rows - c - 1) /= x0 - alpha;
+        x[0] = alpha;
+
+        // the panel columns right of c: A -= tau v (v^T A)
+        const size_t rest = j + nb - c - 1;
+        if(rest == 0) continue;
+        const vector_view<T> wView(w.data(), rest);
+        wView = a.Row(c).Subview(c + 1, rest);
+        for(size_t i = c + 1; i < rows; i++)
+            wView.AddScaled(a.GetElement(c, i), a.Row(i).Subview(c + 1, rest));
+        a.Row(c).Subview(c + 1, rest).AddScaled(-tau[c], wView);
+        for(size_t i = c + 1; i < rows; i++)
+            a.Row(i).Subview(c + 1, rest).AddScaled(-tau[c] * a.GetElement(c, i), wView);
+    }
+}
+
+// Compact WY form H(j) ... H(j + nb - 1) = I - V T V^T of a block of reflectors stored below the
+// diagonal of qr: v gets V explicitly (unit diagonal, zeros above it) as rows x nb, t the upper
+// triangular nb x nb factor T.
+template <typename T>
+void householder_block(const matrix_view<const T> qr, const T* tau, const size_t j, const size_t nb,
+                       scratch_vector<T>& v, scratch_vector<T>& t)
+{
+    const size_t rows = qr.GetSizeY() - j;
+    v.assign(rows * nb, T(0));
+    t.assign(nb * nb, T(0));
+    for(size_t i = 0; i < rows; i++)
+        for(size_t c = 0; c < std::min(i + 1, nb); c++)
+            v[i * nb + c] = i == c ? T(1) : qr.GetElement(j + c, j + i);
+
+    // T(0:c, c) = -tau_c T(0:c, 0:c) V(:, 0:c)^T v_c
+    scratch_vector<T> column(nb);
+    for(size_t c = 0; c < nb; c++)
+    {
+        std::fill(column.begin(), column.end(), T(0));
+        for(size_t i = c; i < rows; i++)
+            for(size_t k = 0; k < c; k++)
+                column[k] += v[i * nb + k] * v[i * nb + c];
+        for(size_t k = 0; k < c; k++)
+        {
+            T sum = T(0);
+            for(size_t l = k; l < c; l++)
+                sum += t[k * nb + l] * column[l];
+            t[k * nb + c] = -tau[j + c] * sum;
+        }
+        t[c * nb + c] = tau[j + c];
+    }
+}
+
+// c = (I - V T V^T) c, or its transpose applied when transposed, for the rows x width block c
+template <typename T>
+void apply_householder_block(const scratch_vector<T>& v, const scratch_vector<T>& t, const size_t nb,
+                             const bool transposed, const matrix_view<T> c, scratch_vector<T>& w)
+{
+    const size_t rows = c.GetSizeY();
+    const size_t width = c.GetSizeX();
+    const ptrdiff_t ldc = c.GetLeadingDimension();
+    if(width == 0) return;
+    w.resize(nb * width);
+
+    // W = V^T C
+    gemm<T>(nb, width, rows, T(1), v.data(), 1, ptrdiff_t(nb), c.GetData(), ldc, 1, T(0), w.data(), ptrdiff_t(width), 1);
+
+    // W = T W, or T^T W, in place: T is upper triangular, so each row only needs rows not yet overwritten
+    const matrix_view<T> wView(w.data(), width, nb, ptrdiff_t(width));
+    if(transposed)
+        for(size_t i = nb; i-- > 0;)
+        {
+            wView.Row(i) *= t[i * nb + i];
             for(size_t k = 0; k < i; k++)
-                result.GetElement(i, i) -= result.GetElement(i, k) * result.GetElement(k, i);       
-        }   
+                wView.Row(i).AddScaled(t[k * nb + i], wView.Row(k));
+        }
+    else
+        for(size_t i = 0; i < nb; i++)
+        {
+            wView.Row(i) *= t[i * nb + i];
+            for(size_t k = i + 1; k < nb; k++)
+                wView.Row(i).AddScaled(t[i * nb + k], wView.Row(k));
+        }
+
+    // C -= V W
+    gemm<T>(rows, width, nb, T(-1), v.data(), ptrdiff_t(nb), 1, w.data(), ptrdiff_t(width), 1, T(1), c.GetData(), ldc, 1);
+}
+
+// Panels of this many columns are factored unblocked; everything right of them is updated with
+// the compact WY form of the panel's reflectors through gemm.
+constexpr size_t qr_block = 32;
+
+}
+
+template <typename T>
+scratch_vector<T> qr_decomposition_in_place(const matrix_view<T> a)
+{
+    const size_t reflectors = std::min(a.GetSizeX(), a.GetSizeY());
+    NUMERICALS_INSTRUMENT_CALL("qr_decomposition_in_place", a.GetSizeX());
+    {
+        // sum over the reflectors c of the (m - c) x (n - c) block each one updates
+        const double m = double(a.GetSizeY()), n = double(a.GetSizeX()), k = double(reflectors);
+        const double updated = m * n * k - (m + n) * k * k / 2.0 + k * k * k / 3.0;
+        NUMERICALS_COUNT_WORK(4.0 * updated, sizeof(T) * 2.0 * updated);
+    }
+    NUMERICALS_INSTRUMENT_PHASE(factorization);
+    scratch_vector<T> tau(reflectors, T(0));
+    scratch_vector<T> v, t, w;
+    for(size_t j = 0; j < reflectors; j += detail::qr_block)
+    {
+        const size_t nb = std::min(detail::qr_block, reflectors - j);
+        detail::householder_panel(a, tau.data(), j, nb);
+
+        const size_t rest = a.GetSizeX() - j - nb;
+        if(rest == 0) continue;
+        constexpr bool transposed = true;
+        detail::householder_block<T>(a, tau.data(), j, nb, v, t);
+        detail::apply_householder_block(v, t, nb, transposed, a.Block(j + nb, j, rest, a.GetSizeY() - j), w);
     }
- 
+    return tau;
+}
+
+template <typename T>
+void apply_householder_q(const std::type_identity_t<matrix_view<const T>> qr, const scratch_vector<T>& tau, const matrix_view<T> b, const bool transposed)
+{
+    if(b.GetSizeY() != qr.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix sizes in householder product");
+
+    NUMERICALS_INSTRUMENT_CALL("apply_householder_q", qr.GetSizeY());
+    NUMERICALS_COUNT_WORK(4.0 * double(qr.GetSizeY()) * double(tau.size()) * double(b.GetSizeX()),
+                          sizeof(T) * 2.0 * double(b.GetSizeY()) * double(b.GetSizeX()) * double(tau.size()) / double(detail::qr_block));
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+
+    // Q^T = H(k-1) ... H(0) takes the blocks first to last, Q the other way round
+    const size_t blocks = (tau.size() + detail::qr_block - 1) / detail::qr_block;
+    scratch_vector<T> v, t, w;
+    for(size_t step = 0; step < blocks; step++)
+    {
+        const size_t j = (transposed ? step : blocks - 1 - step) * detail::qr_block;
+        const size_t nb = std::min(detail::qr_block, tau.size() - j);
+        detail::householder_block<T>(qr, tau.data(), j, nb, v, t);
+        detail::apply_householder_block(v, t, nb, transposed, b.Block(0, j, b.GetSizeX(), b.GetSizeY() - j), w);
+    }
+}
+
+template <typename T>
+std::pair<matrix<T>, matrix<T>> qr_decomposition(const matrix<T>& a, const qr_mode mode)
+{
+    NUMERICALS_INSTRUMENT_CALL("qr_decomposition", a.GetSizeX());
+    matrix<T> factors = a;
+    const scratch_vector<T> tau = qr_decomposition_in_place(factors.View());
+
+    const size_t rows = a.GetSizeY();
+    const size_t k = mode == qr_mode::full ? rows : tau.size();
+    matrix<T> q{k, rows};
+    for(size_t i = 0; i < k; i++)
+        q.GetElement(i, i) = T(1);
+    apply_householder_q<T>(factors.View(), tau, q.View(), false);
+
+    matrix<T> r{a.GetSizeX(), k};
+    for(size_t y = 0; y < std::min(k, tau.size()); y++)
+        r.Row(y, y) = factors.Row(y, y);
+
+    // flip signs so that R has a non-negative diagonal, which makes the factorization unique
+    for(size_t y = 0; y < tau.size(); y++)
+        if(r.GetElement(y, y) < T(0))
+        {
+            r.Row(y) *= T(-1);
+            q.Column(y) *= T(-1);
+        }
+    return {std::move(q), std::move(r)};
+}
+
+template <typename T>
+void llt_decomposition_in_place(const matrix_view<T> a, const triangle part, const size_t threads)
+{
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix sizes in llt decomposition");
+
+    NUMERICALS_INSTRUMENT_CALL("llt_decomposition_in_place", a.GetSizeX());
+    NUMERICALS_COUNT_WORK(double(a.GetSizeX()) * double(a.GetSizeX()) * double(a.GetSizeX()) / 3.0,
+                          sizeof(T) * double(a.GetSizeX()) * double(a.GetSizeX()) * double(a.GetSizeX()) / 3.0);
+    NUMERICALS_INSTRUMENT_PHASE(factorization);
+    detail::blocked_llt(a, part, threads);
+}
+
+template <typename T>
+matrix<T> llt_decomposition(const matrix<T>& a)
+{
+    NUMERICALS_INSTRUMENT_CALL("llt_decomposition", a.GetSizeX());
+    matrix<T> result = a;
+    llt_decomposition_in_place(result.View());
+
+    const size_t size = result.GetSizeX();
     for(size_t i = 0; i < size; i++)
         for(size_t j = i + 1; j < size; j++)
             result.GetElement(j, i) = result.GetElement(i, j);
-
-   
     return result;
 }
 
-matrix<real> lu_decomposition(matrix<real> a, PivotingStrategy&& strategy)
+template <typename T>
+matrix<T> lu_decomposition(matrix<T> a)
 {
-    if(a.GetSizeY() != a.GetSizeY()) [[unlikely]] std::runtime_error("Wrong matrix-vector sizes in solver");
-    size_t size = a.GetSizeX();
-    
-    for(size_t j = 0; j < size; j++)
-    {    
-        for(size_t i = j+1; i < size; i++)
-        {
-            const real multiplier = a.GetElement(j, i) / a.GetElement(j, j); 
-            a.GetRowSlice(i, j) -= multiplier * a.GetRow(j, j);
-            a.GetElement(j, i) = multiplier;
-        }
-    }
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix sizes in lu decomposition");
+
+    NUMERICALS_INSTRUMENT_CALL("lu_decomposition", a.GetSizeX());
+    detail::count_lu_work<T>(a.GetSizeX());
+    detail::blocked_lu(a.View(), static_cast<scratch_vector<size_t>*>(nullptr));
     return a;
 }
 
+template <typename T>
+matrix<T> lu_decomposition(matrix<T> a, PivotingStrategy<T>&& strategy, scratch_vector<size_t>& permutation)
+{
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix sizes in lu decomposition");
+
+    NUMERICALS_INSTRUMENT_CALL("lu_decomposition", a.GetSizeX());
+    detail::count_lu_work<T>(a.GetSizeX());
+    permutation.resize(a.GetSizeY());
+    std::iota(permutation.begin(), permutation.end(), size_t(0));
+    detail::blocked_lu(a.View(), strategy.ExchangesRows() ? &permutation : nullptr);
+    return a;
+}
+
+template <typename T>
+matrix<T> lu_decomposition(matrix<T> a, PivotingStrategy<T>&&)
+{
+    return lu_decomposition(std::move(a));
+}
+
+template <typename T>
+std::pair<matrix<T>, scratch_vector<size_t>> lu_decomposition_with_pivoting(matrix<T> a)
+{
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix sizes in lu decomposition");
+
+    NUMERICALS_INSTRUMENT_CALL("lu_decomposition_with_pivoting", a.GetSizeX());
+    detail::count_lu_work<T>(a.GetSizeX());
+    scratch_vector<size_t> permutation(a.GetSizeY());
+    std::iota(permutation.begin(), permutation.end(), size_t(0));
+    detail::blocked_lu(a.View(), &permutation);
+    return {std::move(a), std::move(permutation)};
+}
+
+
+#define NUMERICALS_INSTANTIATE_MATRIX_DECOMPOSER(T) \
+    template std::pair<matrix<T>, matrix<T>> qr_decomposition<T>(const matrix<T>&, qr_mode); \
+    template scratch_vector<T> qr_decomposition_in_place<T>(matrix_view<T>); \
+    template void apply_householder_q<T>(matrix_view<const T>, const scratch_vector<T>&, matrix_view<T>, bool); \
+    template matrix<T> llt_decomposition<T>(const matrix<T>&); \
+    template void llt_decomposition_in_place<T>(matrix_view<T>, triangle, size_t); \
+    template matrix<T> ldlt_decomposition<T>(const matrix<T>&); \
+    template matrix<T> lu_decomposition<T>(matrix<T>); \
+    template matrix<T> lu_decomposition<T>(matrix<T>, PivotingStrategy<T>&&, scratch_vector<size_t>&); \
+    template matrix<T> lu_decomposition<T>(matrix<T>, PivotingStrategy<T>&&); \
+    template std::pair<matrix<T>, scratch_vector<size_t>> lu_decomposition_with_pivoting<T>(matrix<T>);
+
+NUMERICALS_INSTANTIATE_MATRIX_DECOMPOSER(float)
+NUMERICALS_INSTANTIATE_MATRIX_DECOMPOSER(double)
+NUMERICALS_INSTANTIATE_MATRIX_DECOMPOSER(long double)
+#undef NUMERICALS_INSTANTIATE_MATRIX_DECOMPOSER
+
 }
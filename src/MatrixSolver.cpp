@@ -2,172 +2,603 @@
 #include "PivotingStrategy.h"
 #include "vector.h"
 #include "MatrixDecomposer.h"
+#include "Factorization.h"
+#include "gram.h"
+#include "instrumentation.h"
+#include "parallel.h"
+#include "trsm.h"
+#include "utils.h"
 
+#include <algorithm>
+#include <barrier>
 #include <cmath>
 #include <cstddef>
+#include <numeric>
+#include <optional>
 #include <ranges>
 #include <stdexcept>
 
 namespace numericals{
 
-vector<real> solve_high_trian_matrix_eq(const matrix<real>& a, const vector<real>& b, bool assumeDiagonalOnes)
+namespace detail {
+
+// Operation-count models reported to the instrumentation: flops and the bytes of matrix and
+// vector elements read and written, for elimination on an n x n matrix with m right-hand sides
+template <typename T>
+void count_gauss_work(const size_t size, const size_t rhs)
 {
-    if(a.GetSizeY() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] std::runtime_error("Wrong matrix-vector sizes in solver");
+    const double n = double(size), m = double(rhs);
+    NUMERICALS_COUNT_WORK(2.0 / 3.0 * n * n * n + 2.0 * n * n * m, sizeof(T) * (2.0 / 3.0 * n * n * n + 2.0 * n * m));
+}
 
-    vector<real> x(a.GetSizeX());
-    size_t last = x.GetSize() - 1;
-    for(size_t i = 0; i < x.GetSize(); i++)
-    {    
-        size_t index = last - i;
-        x[index] = b[index];
-        for(size_t j = 1; j <= i; j++)
-            x[index] -= a.GetElement(index + j, index) * x[index + j]; 
-        if(!assumeDiagonalOnes)
-            x[index] /= a.GetElement(index, index);
-    }
-    
+template <typename T>
+void count_jordan_work(const size_t size, const size_t rhs)
+{
+    const double n = double(size), m = double(rhs);
+    NUMERICALS_COUNT_WORK(n * n * n + 2.0 * n * n * m, sizeof(T) * (n * n * n + 2.0 * n * n * m));
+}
+
+template <typename T>
+void count_triangular_work(const size_t size, const size_t rhs)
+{
+    const double n = double(size), m = double(rhs);
+    NUMERICALS_COUNT_WORK(n * n * m, sizeof(T) * (n * n / 2.0 + 2.0 * n * m));
+}
+
+}
+
+template <typename T>
+vector<T> solve_high_trian_matrix_eq(const matrix<T>& a, const vector<T>& b, bool assumeDiagonalOnes)
+{
+    if(a.GetSizeX() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
+
+    NUMERICALS_INSTRUMENT_CALL("solve_high_trian_matrix_eq", b.GetSize());
+    detail::count_triangular_work<T>(b.GetSize(), 1);
+    vector<T> x = b;
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+    trsm<T>(triangle::upper, false, assumeDiagonalOnes, a.View(), matrix_view<T>(x.GetData(), 1, x.GetSize(), 1));
     return x;
 }
 
-vector<real> solve_low_trian_matrix_eq(const matrix<real>& a, const vector<real>& b, bool assumeDiagonalOnes)
+template <typename T>
+vector<T> solve_low_trian_matrix_eq(const matrix<T>& a, const vector<T>& b, bool assumeDiagonalOnes)
 {
-    if(a.GetSizeY() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] std::runtime_error("Wrong matrix-vector sizes in solver");
+    if(a.GetSizeX() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
 
-    vector<real> x(a.GetSizeX());
-    for(size_t i = 0; i < x.GetSize(); i++)
-    {    
-        x[i] = b[i];
-        for(size_t j = 1; j <= i; j++)
-            x[i] -= a.GetElement(i - j, i) * x[i - j]; 
-        if(!assumeDiagonalOnes)
-            x[i] /= a.GetElement(i, i);
-    }
-    
+    NUMERICALS_INSTRUMENT_CALL("solve_low_trian_matrix_eq", b.GetSize());
+    detail::count_triangular_work<T>(b.GetSize(), 1);
+    vector<T> x = b;
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+    trsm<T>(triangle::lower, false, assumeDiagonalOnes, a.View(), matrix_view<T>(x.GetData(), 1, x.GetSize(), 1));
     return x;
 }
 
-vector<real> solve_overdetermined_matrix(const matrix<real>& a, const vector<real>& b, 
-                                         std::function<vector<real>(matrix<real>, vector<real>, PivotingStrategy&&)> algorithm, PivotingStrategy&& strategy)
+template <typename T>
+matrix<T> solve_high_trian_matrix_eq(const matrix<T>& a, matrix<T> b, bool assumeDiagonalOnes, bool transposed)
+{
+    NUMERICALS_INSTRUMENT_CALL("solve_high_trian_matrix_eq", b.GetSizeY());
+    detail::count_triangular_work<T>(b.GetSizeY(), b.GetSizeX());
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+    trsm<T>(triangle::upper, transposed, assumeDiagonalOnes, a.View(), b.View());
+    return b;
+}
+
+template <typename T>
+matrix<T> solve_low_trian_matrix_eq(const matrix<T>& a, matrix<T> b, bool assumeDiagonalOnes, bool transposed)
+{
+    NUMERICALS_INSTRUMENT_CALL("solve_low_trian_matrix_eq", b.GetSizeY());
+    detail::count_triangular_work<T>(b.GetSizeY(), b.GetSizeX());
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+    trsm<T>(triangle::lower, transposed, assumeDiagonalOnes, a.View(), b.View());
+    return b;
+}
+
+template <typename T>
+std::pair<matrix<T>, vector<T>> get_normal_equations(const matrix<T>& a, const vector<T>& b)
+{
+    if(a.GetSizeY() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in normal equations");
+
+    NUMERICALS_INSTRUMENT_CALL("get_normal_equations", a.GetSizeX());
+    NUMERICALS_COUNT_WORK(double(a.GetSizeY()) * double(a.GetSizeX()) * double(a.GetSizeX() + 2),
+                          sizeof(T) * double(a.GetSizeY()) * double(a.GetSizeX() + 1));
+    matrix<T> ata{a.GetSizeX(), a.GetSizeX()};
+    vector<T> atb(a.GetSizeX());
+    gram_upper(a.View(), b.GetData(), ata.View(), atb.GetData());
+    mirror_upper(ata.View());
+    return {std::move(ata), std::move(atb)};
+}
+
+template <typename T>
+vector<T> solve_overdetermined_matrix(const matrix<T>& a, const vector<T>& b)
+{
+    NUMERICALS_INSTRUMENT_CALL("solve_overdetermined_matrix", a.GetSizeX());
+    return solve_matrix_eq_with_qr_decomposition(a, b);
+}
+
+template <typename T>
+vector<T> solve_overdetermined_matrix(const matrix<T>& a, const vector<T>& b, 
+                                      std::type_identity_t<matrix_eq_algorithm<T>> algorithm, PivotingStrategy<T>&& strategy)
+{
+   NUMERICALS_INSTRUMENT_CALL("solve_overdetermined_matrix", a.GetSizeX());
+   auto [A, realB] = get_normal_equations(a, b);
+   return algorithm(std::move(A), std::move(realB), std::move(strategy)); 
+}
+
+template <typename T>
+vector<T> solve_overdetermined_matrix(const matrix<T>& a, const vector<T>& b, 
+                                      matrix_eq_algorithm_ptr<T> algorithm, PivotingStrategy<T>&& strategy)
+{
+   return solve_overdetermined_matrix(a, b, matrix_eq_algorithm<T>(algorithm), std::move(strategy));
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_gauss( matrix<T> a, vector<T> b, PivotingStrategy<T>&& strategy)
 {
-   matrix<real> A = a.Transposed() * a; 
-   vector<real> realB = a.Transposed() * b;
-   return algorithm(A, realB, std::move(strategy)); 
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_gauss", b.GetSize());
+    solve_matrix_eq_gauss_in_place(a, b, std::move(strategy));
+    return b;
 }
 
-vector<real> solve_matrix_eq_gauss( matrix<real> a, vector<real> b, PivotingStrategy&& strategy)
+template <typename T>
+void solve_matrix_eq_gauss_in_place(matrix<T>& a, vector<T>& b, PivotingStrategy<T>&& strategy)
 {
-    if(a.GetSizeY() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] std::runtime_error("Wrong matrix-vector sizes in solver");
-    
-    permutation_stack stack;
+    if(a.GetSizeX() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
+
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_gauss_in_place", b.GetSize());
+    detail::count_gauss_work<T>(b.GetSize(), 1);
     size_t size_y = a.GetSizeX(); 
     for(size_t d = 0; d < size_y; d++)
     {
         strategy.PreIteration(a, b, d);
+        NUMERICALS_INSTRUMENT_PHASE(factorization);
+        NUMERICALS_OBSERVE_PIVOT(a.GetElement(d, d));
+        const auto pivotRow = a.Row(d, d);
         b[d] /= a.GetElement(d, d);
-        a.GetRowSlice(d) = a.GetRow(d) / a.GetElement(d, d);
+        pivotRow /= a.GetElement(d, d);
         for (size_t i = d + 1; i < size_y; i++)
         {   
-            b[i] -= b[d] * a.GetElement(d, i);
-            a.GetRowSlice(i) -= a.GetElement(d, i) * a.GetRow(d);
+            const T multiplier = a.GetElement(d, i);
+            b[i] -= b[d] * multiplier;
+            a.Row(i, d).AddScaled(-multiplier, pivotRow);
         }    
     }
 
-    auto x = solve_high_trian_matrix_eq(a, b);
-    strategy.CleanUp(x); 
-    return x;
+    {
+        NUMERICALS_INSTRUMENT_PHASE(substitution);
+        trsm<T>(triangle::upper, false, true, a.View(), matrix_view<T>(b.GetData(), 1, b.GetSize(), 1));
+    }
+    strategy.CleanUp(b); 
 }
 
-vector<real> solve_matrix_eq_jordan( matrix<real> a, vector<real> b, PivotingStrategy&& strategy)
+namespace detail {
+
+scratch_vector<size_t> identity_order(const size_t size)
 {
-    if(a.GetSizeY() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] std::runtime_error("Wrong matrix-vector sizes in solver");
-    
-    size_t size_y = a.GetSizeX(); 
-    for(size_t d = 0; d < size_y; d++)
-    {
-        strategy.PreIteration(a, b, d);
-        b[d] /= a.GetElement(d, d);
-        a.GetRowSlice(d) = a.GetRow(d) / a.GetElement(d, d);
-        for (size_t i = 0; i < size_y; i++)
-        {   
-            if(i == d) continue;
+    scratch_vector<size_t> order(size);
+    std::iota(order.begin(), order.end(), size_t(0));
+    return order;
+}
 
-            b[i] -= b[d] * a.GetElement(d, i);
-            a.GetRowSlice(i) -= a.GetElement(d, i) * a.GetRow(d);
+}
+
+template <typename T, pivoting_policy<T> Policy>
+vector<T> solve_matrix_eq_gauss(matrix<T> a, vector<T> b, Policy policy)
+{
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_gauss", b.GetSize());
+    SolverWorkspace<T> workspace;
+    solve_matrix_eq_gauss_in_place(a, b, policy, workspace);
+    return b;
+}
+
+template <typename T, pivoting_policy<T> Policy>
+void solve_matrix_eq_gauss_in_place(matrix<T>& a, vector<T>& b, Policy, SolverWorkspace<T>& workspace)
+{
+    if(a.GetSizeX() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
+
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_gauss_in_place", b.GetSize());
+    detail::count_gauss_work<T>(b.GetSize(), 1);
+    const size_t size = b.GetSize();
+    workspace.Prepare(size);
+    const auto rows = workspace.GetRows();
+    const auto cols = workspace.GetCols();
+    for(size_t d = 0; d < size; d++)
+    {
+        Policy::template Select<T>(a.View(), rows, cols, d);
+        NUMERICALS_INSTRUMENT_PHASE(factorization);
+        const size_t pivotIndex = rows[d];
+        const size_t pivotColumn = cols[d];
+        // with permuted columns the eliminated ones are scattered, but they are zero in the pivot row
+        const size_t offset = Policy::permutes_columns ? 0 : d;
+        const auto pivotRow = a.Row(pivotIndex, offset);
+        const T divisor = a.GetElement(pivotColumn, pivotIndex);
+        NUMERICALS_OBSERVE_PIVOT(divisor);
+        b[pivotIndex] /= divisor;
+        pivotRow /= divisor;
+        for(size_t i = d + 1; i < size; i++)
+        {
+            const size_t row = rows[i];
+            const T multiplier = a.GetElement(pivotColumn, row);
+            b[row] -= b[pivotIndex] * multiplier;
+            a.Row(row, offset).AddScaled(-multiplier, pivotRow);
         }
     }
-    
+
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+    const auto x = workspace.GetSolution();
+    for(size_t i = size; i-- > 0;)
+    {
+        T sum = b[rows[i]];
+        for(size_t j = i + 1; j < size; j++)
+            sum -= a.GetElement(cols[j], rows[i]) * x[cols[j]];
+        x[cols[i]] = sum;
+    }
+    std::copy(x.begin(), x.end(), b.GetData());
+}
+
+namespace detail {
+
+// Elements touched per pivot step below which the elimination stays on the calling thread
+constexpr size_t jordan_elements_per_thread = size_t(1) << 16;
+
+// Gauss-Jordan elimination of a against the right-hand sides in the columns of b. Each thread
+// owns a contiguous band of rows for the whole run; per pivot step the first thread asks
+// pivot(d) for the storage (row, column) of the pivot and normalises that row, then every
+// thread eliminates its band against it. Unless columns are permuted, everything left of
+// column d is already zero in the pivot row and is skipped.
+template <typename T, typename Pivot>
+void jordan_eliminate(const matrix_view<T> a, const matrix_view<T> b, size_t threads, Pivot&& pivot,
+                      const bool permutesColumns, std::vector<std::chrono::nanoseconds>* step_times)
+{
+    const size_t size = a.GetSizeY();
+    threads = threads_for(size * (size + b.GetSizeX()) / jordan_elements_per_thread, threads);
+    if(step_times) step_times->assign(size, std::chrono::nanoseconds(0));
+
+    // a single thread needs no barrier, and so no allocation
+    std::optional<std::barrier<>> barrier;
+    if(threads > 1) barrier.emplace(ptrdiff_t(threads));
+    const auto sync = [&] { if(barrier) barrier->arrive_and_wait(); };
+    std::pair<size_t, size_t> current;
+    parallel_for(0, threads, threads, [&](size_t, size_t, const size_t thread)
+    {
+        const size_t first = size * thread / threads;
+        const size_t last = size * (thread + 1) / threads;
+        std::chrono::steady_clock::time_point start;
+        for(size_t d = 0; d < size; d++)
+        {
+            const size_t offset = permutesColumns ? 0 : d;
+            if(thread == 0)
+            {
+                start = std::chrono::steady_clock::now();
+                current = pivot(d);
+                const T divisor = a.GetElement(current.second, current.first);
+                NUMERICALS_OBSERVE_PIVOT(divisor);
+                b.Row(current.first) /= divisor;
+                a.Row(current.first, offset) /= divisor;
+            }
+            sync();
+
+            // only chunk 0 runs on the calling thread, the one with an instrumented call to time into
+            NUMERICALS_INSTRUMENT_PHASE(factorization);
+            const auto [pivotIndex, pivotColumn] = current;
+            const auto pivotRow = a.Row(pivotIndex, offset);
+            const auto pivotB = b.Row(pivotIndex);
+            for(size_t i = first; i < last; i++)
+            {
+                if(i == pivotIndex) continue;
+
+                const T multiplier = a.GetElement(pivotColumn, i);
+                b.Row(i).AddScaled(-multiplier, pivotB);
+                a.Row(i, offset).AddScaled(-multiplier, pivotRow);
+            }
+            sync();
+
+            if(thread == 0 && step_times)
+                (*step_times)[d] = std::chrono::steady_clock::now() - start;
+        }
+    });
+}
+
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_jordan( matrix<T> a, vector<T> b, PivotingStrategy<T>&& strategy)
+{
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_jordan", b.GetSize());
+    solve_matrix_eq_jordan_in_place(a, b, std::move(strategy), get_num_threads());
+    return b;
+}
+
+template <typename T>
+void solve_matrix_eq_jordan_in_place(matrix<T>& a, vector<T>& b, PivotingStrategy<T>&& strategy, const size_t threads)
+{
+    if(a.GetSizeX() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
+
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_jordan_in_place", b.GetSize());
+    detail::count_jordan_work<T>(b.GetSize(), 1);
+    auto pivot = [&](const size_t d)
+    {
+        strategy.PreIteration(a, b, d);
+        return std::pair{d, d};
+    };
+    detail::jordan_eliminate(a.View(), matrix_view<T>(b.GetData(), 1, b.GetSize(), 1), threads, pivot, false, nullptr);
     strategy.CleanUp(b);
-    
+}
+
+template <typename T, pivoting_policy<T> Policy>
+vector<T> solve_matrix_eq_jordan(matrix<T> a, vector<T> b, Policy policy)
+{
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_jordan", b.GetSize());
+    SolverWorkspace<T> workspace;
+    solve_matrix_eq_jordan_in_place(a, b, policy, workspace, get_num_threads());
     return b;
 }
 
-vector<real> solve_tridiagonal_matrix_eq( std::array<vector<real>, 3> a, vector<real> b)
+template <typename T, pivoting_policy<T> Policy>
+void solve_matrix_eq_jordan_in_place(matrix<T>& a, vector<T>& b, Policy, SolverWorkspace<T>& workspace, const size_t threads)
 {
-    if(a[0].GetSize() != b.GetSize() - 1 || a[1].GetSize() != b.GetSize() || a[2].GetSize() != b.GetSize() - 1) [[unlikely]]
-        std::runtime_error("Wrong matrix-vector sizes in tridiagonal solver");
-    
-    //lu on tridiagonal matrix
-    size_t size = b.GetSize();
-    vector<real>& l = a[0];
-    vector<real>& d = a[1];
-    vector<real>& u = a[2];
+    if(a.GetSizeX() != a.GetSizeY() || a.GetSizeX() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
 
-    for(size_t i = 0; i < size - 1; i++)
-    {    
-        l[i] /= d[i];
-        d[i + 1] -= l[i] * u[i];
-    }
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_jordan_in_place", b.GetSize());
+    detail::count_jordan_work<T>(b.GetSize(), 1);
+    workspace.Prepare(b.GetSize());
+    const auto rows = workspace.GetRows();
+    const auto cols = workspace.GetCols();
+    auto pivot = [&](const size_t d)
+    {
+        Policy::template Select<T>(a.View(), rows, cols, d);
+        return std::pair{rows[d], cols[d]};
+    };
+    detail::jordan_eliminate(a.View(), matrix_view<T>(b.GetData(), 1, b.GetSize(), 1), threads,
+                             pivot, Policy::permutes_columns, nullptr);
 
-    vector<real> y = vector<real>(size);
-    y[0] = b[0];
-    for(size_t i = 1; i < size; i++)
-        y[i] = b[i] - l[i - 1] * y[i - 1]; 
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+    const auto x = workspace.GetSolution();
+    for(size_t d = 0; d < b.GetSize(); d++)
+        x[cols[d]] = b[rows[d]];
+    std::copy(x.begin(), x.end(), b.GetData());
+}
 
-    vector<real> x = vector<real>(size);
-    x[size - 1] = y[size - 1] / d[size - 1];
-    for(int i = size - 2; i >= 0; i--)
-        x[i] = (y[i] - u[i] * x[i + 1]) / d[i];
+template <typename T>
+matrix<T> solve_matrix_eq_jordan(matrix<T> a, matrix<T> b, size_t threads, std::vector<std::chrono::nanoseconds>* step_times)
+{
+    if(a.GetSizeX() != a.GetSizeY() || a.GetSizeY() != b.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix sizes in solver");
 
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_jordan", a.GetSizeY());
+    detail::count_jordan_work<T>(a.GetSizeY(), b.GetSizeX());
+    auto rows = detail::identity_order(a.GetSizeY());
+    auto cols = detail::identity_order(a.GetSizeY());
+    auto pivot = [&](const size_t d)
+    {
+        PartialPivotingPolicy::Select<T>(a.View(), rows, cols, d);
+        return std::pair{rows[d], d};
+    };
+    detail::jordan_eliminate(a.View(), b.View(), threads, pivot, false, step_times);
+
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+    matrix<T> x{b.GetSizeX(), b.GetSizeY()};
+    for(size_t d = 0; d < rows.size(); d++)
+        x.Row(d) = b.Row(rows[d]);
     return x;
 }
 
-vector<real> solve_matrix_eq_with_qr_decomposition(const matrix<real>& a, const vector<real>& b)
+template <typename T>
+matrix<T> get_inverse_matrix(const matrix<T>& a, size_t threads)
 {
-    auto [Q, R] = qr_decomposition(a);
-    size_t size = b.GetSize();
-    vector<real> y = vector<real>(size);
-    for(size_t i = 0; i < size; i++)
-        y[i] = Q.GetElement(i, i) / (vector<real>(Q.GetRow(i)) * vector<real>(Q.GetColumn(i)));
-    
-    y =  y * b; 
-    return solve_high_trian_matrix_eq(R, std::move(y));
+    NUMERICALS_INSTRUMENT_CALL("get_inverse_matrix", a.GetSizeY());
+    matrix<T> identity{a.GetSizeX(), a.GetSizeY()};
+    for(size_t i = 0; i < std::min(a.GetSizeX(), a.GetSizeY()); i++)
+        identity.GetElement(i, i) = T(1);
+    return solve_matrix_eq_jordan(a, std::move(identity), threads);
 }
 
-vector<real> solve_matrix_eq_with_lu_decomposition(const matrix<real>& a, const vector<real>& b, PivotingStrategy&& strategy)
+template <typename T>
+vector<T> solve_tridiagonal_matrix_eq( std::array<vector<T>, 3> a, vector<T> b)
 {
+    solve_tridiagonal_matrix_eq_in_place(a[0].View(), a[1].View(), a[2].View(), b.View());
+    return b;
+}
+
+namespace detail {
+
+// Rows handed to one thread at the least by the partitioned tridiagonal solver
+constexpr size_t tridiagonal_rows_per_thread = 1 << 14;
+
+template <typename T>
+void check_tridiagonal(const size_t lower, const size_t diagonal, const size_t upper, const size_t b)
+{
+    if(diagonal != b || lower + 1 != std::max<size_t>(b, 1) || upper + 1 != std::max<size_t>(b, 1)) [[unlikely]]
+        throw std::runtime_error("Wrong matrix-vector sizes in tridiagonal solver");
+}
+
+}
+
+template <typename T>
+void solve_tridiagonal_matrix_eq_in_place(const vector_view<T> lower, const vector_view<T> diagonal,
+                                          const std::type_identity_t<vector_view<const T>> upper, const vector_view<T> b)
+{
+    detail::check_tridiagonal<T>(lower.GetSize(), diagonal.GetSize(), upper.GetSize(), b.GetSize());
+    const size_t size = b.GetSize();
+    if(size == 0) return;
+    NUMERICALS_INSTRUMENT_CALL("solve_tridiagonal_matrix_eq_in_place", size);
+    NUMERICALS_COUNT_WORK(8.0 * double(size), sizeof(T) * 7.0 * double(size));
+
+    // L U with L unit lower bidiagonal and U upper bidiagonal; L y = b on the way down
+    {
+        NUMERICALS_INSTRUMENT_PHASE(factorization);
+        for(size_t i = 1; i < size; i++)
+        {
+            NUMERICALS_OBSERVE_PIVOT(diagonal[i - 1]);
+            lower[i - 1] /= diagonal[i - 1];
+            diagonal[i] -= lower[i - 1] * upper[i - 1];
+            b[i] -= lower[i - 1] * b[i - 1];
+        }
+    }
+
+    NUMERICALS_INSTRUMENT_PHASE(substitution);
+    NUMERICALS_OBSERVE_PIVOT(diagonal[size - 1]);
+    b[size - 1] /= diagonal[size - 1];
+    for(size_t i = size - 1; i-- > 0;)
+        b[i] = (b[i] - upper[i] * b[i + 1]) / diagonal[i];
+}
+
+template <typename T>
+void solve_tridiagonal_matrix_eq_parallel(const std::type_identity_t<vector_view<const T>> lower,
+                                          const std::type_identity_t<vector_view<const T>> diagonal,
+                                          const std::type_identity_t<vector_view<const T>> upper, const vector_view<T> b,
+                                          size_t threads)
+{
+    detail::check_tridiagonal<T>(lower.GetSize(), diagonal.GetSize(), upper.GetSize(), b.GetSize());
+    const size_t size = b.GetSize();
+    if(size == 0) return;
+    threads = threads_for(size / detail::tridiagonal_rows_per_thread, threads);
+    NUMERICALS_INSTRUMENT_CALL("solve_tridiagonal_matrix_eq_parallel", size);
+    NUMERICALS_COUNT_WORK(17.0 * double(size), sizeof(T) * 10.0 * double(size));
+    const auto block_begin = [&](const size_t t) { return t * size / threads; };
+
+    // Block [first, last) solves its rows for b (into b), for the left spike, the response to
+    // x[first - 1] through lower[first - 1] (into left), and for the right spike, the response
+    // to x[last] through upper[last - 1] (into right). Then x = b - left x[first - 1] - right x[last].
+    scratch_vector<T> ratio(size), left(size), right(size);
+    parallel_for(0, threads, threads, [&](const size_t firstBlock, const size_t lastBlock, size_t)
+    {
+        for(size_t t = firstBlock; t < lastBlock; t++)
+        {
+            const size_t first = block_begin(t), last = block_begin(t + 1);
+            for(size_t i = first; i < last; i++)
+            {
+                const T coupling = i > first ? lower[i - 1] : T(0);
+                const T pivot = diagonal[i] - (i > first ? coupling * ratio[i - 1] : T(0));
+                if(pivot == T(0)) [[unlikely]] throw std::runtime_error("Zero pivot in tridiagonal solver");
+                ratio[i] = i + 1 < size ? upper[i] / pivot : T(0);
+                b[i] = (b[i] - (i > first ? coupling * b[i - 1] : T(0))) / pivot;
+                left[i] = (i == first ? (first > 0 ? lower[first - 1] : T(0)) : -coupling * left[i - 1]) / pivot;
+                right[i] = i + 1 == last && last < size ? upper[i] / pivot : T(0);
+            }
+            for(size_t i = last - 1; i-- > first;)
+            {
+                b[i] -= ratio[i] * b[i + 1];
+                left[i] -= ratio[i] * left[i + 1];
+                right[i] -= ratio[i] * right[i + 1];
+            }
+        }
+    });
+    if(threads == 1) return;
+
+    // Interface k joins blocks k and k + 1; its unknowns are the last row of block k and the first
+    // of block k + 1, ordered 2k and 2k + 1. Each is coupled through the spike tips to the row just
+    // past the other end of its own block: 2k to 2k - 2 and 2k + 1 to 2k + 3, which makes the
+    // reduced system a band with two sub-diagonals and two super-diagonals.
+    const size_t interfaces = threads - 1;
+    band_matrix<T> reduced(2 * interfaces, 2, 2);
+    vector<T> tips(2 * interfaces);
+    for(size_t k = 0; k < interfaces; k++)
+    {
+        const size_t lastRow = block_begin(k + 1) - 1, firstRow = lastRow + 1;
+        reduced.GetElement(2 * k, 2 * k) = T(1);
+        if(k > 0) reduced.GetElement(2 * k - 2, 2 * k) = left[lastRow];
+        reduced.GetElement(2 * k + 1, 2 * k) = right[lastRow];
+        tips[2 * k] = b[lastRow];
+
+        reduced.GetElement(2 * k + 1, 2 * k + 1) = T(1);
+        reduced.GetElement(2 * k, 2 * k + 1) = left[firstRow];
+        if(k + 1 < interfaces) reduced.GetElement(2 * k + 3, 2 * k + 1) = right[firstRow];
+        tips[2 * k + 1] = b[firstRow];
+    }
+    const vector<T> interface = solve_banded_matrix_eq(reduced, tips);
+
+    parallel_for(0, threads, threads, [&](const size_t firstBlock, const size_t lastBlock, size_t)
+    {
+        for(size_t t = firstBlock; t < lastBlock; t++)
+        {
+            const T before = t > 0 ? interface[2 * t - 2] : T(0);
+            const T after = t < interfaces ? interface[2 * t + 1] : T(0);
+            for(size_t i = block_begin(t); i < block_begin(t + 1); i++)
+                b[i] -= left[i] * before + right[i] * after;
+        }
+    });
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_qr_decomposition(const matrix<T>& a, const vector<T>& b)
+{
+    if(a.GetSizeY() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
+
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_with_qr_decomposition", a.GetSizeX());
+    return QRFactorization<T>(a).Solve(b);
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_lu_decomposition(const matrix<T>& a, const vector<T>& b, PivotingStrategy<T>&& strategy)
+{
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_with_lu_decomposition", b.GetSize());
+    if(a.GetSizeX() != a.GetSizeY() || a.GetSizeY() != b.GetSize()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in solver");
+
     constexpr bool assume_diagonal_ones = true;
-    matrix<real> lu = lu_decomposition(a, std::move(strategy));
-    vector<real> y = solve_low_trian_matrix_eq(lu, b, assume_diagonal_ones);
+    if(!strategy.ExchangesRows())
+    {
+        matrix<T> lu = lu_decomposition(a);
+        vector<T> y = solve_low_trian_matrix_eq(lu, b, assume_diagonal_ones);
+        return solve_high_trian_matrix_eq(lu, std::move(y));
+    }
+    // the pivoted blocked LU, with its permutation applied to b
+    const auto [lu, permutation] = lu_decomposition_with_pivoting(a);
+    vector<T> pb(b.GetSize());
+    for(size_t i = 0; i < permutation.size(); i++)
+        pb[i] = b[permutation[i]];
+    vector<T> y = solve_low_trian_matrix_eq(lu, pb, assume_diagonal_ones);
     return solve_high_trian_matrix_eq(lu, std::move(y));
 }
 
-vector<real> solve_matrix_eq_with_ldlt_decomposition(const matrix<real>& a, const vector<real>& b)
+template <typename T>
+vector<T> solve_matrix_eq_with_ldlt_decomposition(const matrix<T>& a, const vector<T>& b)
 {
-    constexpr bool assume_diagonal_ones = true;
-    matrix<real> ldlt = ldlt_decomposition(a);
-    vector<real> z = solve_low_trian_matrix_eq(ldlt, b, assume_diagonal_ones);
-    size_t size = z.GetSize();
-    vector<real> y = vector<real>(size);
-    
-    for(size_t i = 0; i < size; i++)
-        y[i] = z[i] / ldlt.GetElement(i, i);
-    
-    return solve_high_trian_matrix_eq(ldlt, y, assume_diagonal_ones);
-}
-vector<real> solve_matrix_eq_with_llt_decomposition(const matrix<real>& a, const vector<real>& b)
-{
-    matrix<real> llt = llt_decomposition(a);
-    vector<real> z = solve_low_trian_matrix_eq(llt, b);
-    return solve_high_trian_matrix_eq(llt, z );
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_with_ldlt_decomposition", b.GetSize());
+    return LDLTFactorization<T>(a).Solve(b);
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_decomposition(const matrix<T>& a, const vector<T>& b)
+{
+    NUMERICALS_INSTRUMENT_CALL("solve_matrix_eq_with_llt_decomposition", b.GetSize());
+    return LLTFactorization<T>(a).Solve(b);
 }
+
+#define NUMERICALS_INSTANTIATE_POLICY_SOLVERS(T, Policy) \
+    template vector<T> solve_matrix_eq_gauss<T, Policy>(matrix<T>, vector<T>, Policy); \
+    template vector<T> solve_matrix_eq_jordan<T, Policy>(matrix<T>, vector<T>, Policy); \
+    template void solve_matrix_eq_gauss_in_place<T, Policy>(matrix<T>&, vector<T>&, Policy, SolverWorkspace<T>&); \
+    template void solve_matrix_eq_jordan_in_place<T, Policy>(matrix<T>&, vector<T>&, Policy, SolverWorkspace<T>&, size_t);
+
+#define NUMERICALS_INSTANTIATE_MATRIX_SOLVER(T) \
+    template vector<T> solve_high_trian_matrix_eq<T>(const matrix<T>&, const vector<T>&, bool); \
+    template vector<T> solve_low_trian_matrix_eq<T>(const matrix<T>&, const vector<T>&, bool); \
+    template matrix<T> solve_high_trian_matrix_eq<T>(const matrix<T>&, matrix<T>, bool, bool); \
+    template matrix<T> solve_low_trian_matrix_eq<T>(const matrix<T>&, matrix<T>, bool, bool); \
+    template std::pair<matrix<T>, vector<T>> get_normal_equations<T>(const matrix<T>&, const vector<T>&); \
+    template vector<T> solve_overdetermined_matrix<T>(const matrix<T>&, const vector<T>&); \
+    template vector<T> solve_overdetermined_matrix<T>(const matrix<T>&, const vector<T>&, std::type_identity_t<matrix_eq_algorithm<T>>, PivotingStrategy<T>&&); \
+    template vector<T> solve_overdetermined_matrix<T>(const matrix<T>&, const vector<T>&, matrix_eq_algorithm_ptr<T>, PivotingStrategy<T>&&); \
+    template vector<T> solve_matrix_eq_gauss<T>(matrix<T>, vector<T>, PivotingStrategy<T>&&); \
+    template vector<T> solve_matrix_eq_jordan<T>(matrix<T>, vector<T>, PivotingStrategy<T>&&); \
+    template void solve_matrix_eq_gauss_in_place<T>(matrix<T>&, vector<T>&, PivotingStrategy<T>&&); \
+    template void solve_matrix_eq_jordan_in_place<T>(matrix<T>&, vector<T>&, PivotingStrategy<T>&&, size_t); \
+    NUMERICALS_INSTANTIATE_POLICY_SOLVERS(T, NoPivotingPolicy) \
+    NUMERICALS_INSTANTIATE_POLICY_SOLVERS(T, PartialPivotingPolicy) \
+    NUMERICALS_INSTANTIATE_POLICY_SOLVERS(T, FullPivotingPolicy) \
+    template matrix<T> solve_matrix_eq_jordan<T>(matrix<T>, matrix<T>, size_t, std::vector<std::chrono::nanoseconds>*); \
+    template matrix<T> get_inverse_matrix<T>(const matrix<T>&, size_t); \
+    template vector<T> solve_tridiagonal_matrix_eq<T>(std::array<vector<T>, 3>, vector<T>); \
+    template void solve_tridiagonal_matrix_eq_in_place<T>(vector_view<T>, vector_view<T>, vector_view<const T>, vector_view<T>); \
+    template void solve_tridiagonal_matrix_eq_parallel<T>(vector_view<const T>, vector_view<const T>, vector_view<const T>, vector_view<T>, size_t); \
+    template vector<T> solve_matrix_eq_with_qr_decomposition<T>(const matrix<T>&, const vector<T>&); \
+    template vector<T> solve_matrix_eq_with_lu_decomposition<T>(const matrix<T>&, const vector<T>&, PivotingStrategy<T>&&); \
+    template vector<T> solve_matrix_eq_with_ldlt_decomposition<T>(const matrix<T>&, const vector<T>&); \
+    template vector<T> solve_matrix_eq_with_llt_decomposition<T>(const matrix<T>&, const vector<T>&);
+
+NUMERICALS_INSTANTIATE_MATRIX_SOLVER(float)
+NUMERICALS_INSTANTIATE_MATRIX_SOLVER(double)
+NUMERICALS_INSTANTIATE_MATRIX_SOLVER(long double)
+#undef NUMERICALS_INSTANTIATE_MATRIX_SOLVER
+#undef NUMERICALS_INSTANTIATE_POLICY_SOLVERS
+
 }
@@ -0,0 +1,301 @@
+#include "PackedSolver.h"
+#include "MatrixDecomposer.h"
+#include "gemm.h"
+#include "gram.h"
+#include "trsm.h"
+
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace numericals {
+
+namespace detail {
+
+template <typename T>
+void check_packed_square(const matrix_view<const T> a)
+{
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Packing a non-square matrix");
+}
+
+template <typename T>
+void check_packed_rhs(const size_t size, const size_t rhsSize)
+{
+    if(rhsSize != size) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in packed solver");
+}
+
+// b = L^-1 b, or L^-T b when transposed, for the lower triangle of l in rectangular full packed
+// form: two triangular solves on the diagonal blocks and a gemm with A21 in between.
+template <typename T>
+void rfp_trsm(const rfp_matrix<T>& l, const bool unitDiagonal, const bool transposed, const matrix_view<T> b)
+{
+    const size_t n1 = l.GetLeadingSize();
+    const size_t n2 = l.GetTrailingSize();
+    const size_t width = b.GetSizeX();
+    const ptrdiff_t ldb = b.GetLeadingDimension();
+    const auto leading = l.GetLeadingBlock();
+    const auto offDiagonal = l.GetOffDiagonalBlock();
+    const auto trailing = l.GetTrailingBlock();
+    const auto b1 = b.Block(0, 0, width, n1);
+    const auto b2 = b.Block(0, n1, width, n2);
+    const ptrdiff_t ldw = offDiagonal.GetLeadingDimension();
+
+    // L11 is held as L11^T in the upper triangle of the leading block
+    if(!transposed)
+    {
+        trsm<T>(triangle::upper, true, unitDiagonal, leading, b1);
+        if(n1 != 0)
+            gemm<T>(n2, width, n1, T(-1), offDiagonal.GetData(), 1, ldw, b1.GetData(), ldb, 1,
+                    T(1), b2.GetData(), ldb, 1);
+        trsm<T>(triangle::lower, false, unitDiagonal, trailing, b2);
+    }
+    else
+    {
+        trsm<T>(triangle::lower, true, unitDiagonal, trailing, b2);
+        if(n1 != 0)
+            gemm<T>(n1, width, n2, T(-1), offDiagonal.GetData(), ldw, 1, b2.GetData(), ldb, 1,
+                    T(1), b1.GetData(), ldb, 1);
+        trsm<T>(triangle::upper, false, unitDiagonal, leading, b1);
+    }
+}
+
+// x = L^-1 b, or L^-T b when transposed, on the packed rows of l
+template <typename T>
+void packed_trsv(const packed_matrix<T>& l, const bool unitDiagonal, const bool transposed, vector<T>& b)
+{
+    const size_t size = l.GetSize();
+    if(!transposed)
+    {
+        for(size_t i = 0; i < size; i++)
+        {
+            const T* row = l.Row(i).GetData();
+            b[i] -= std::inner_product(row, row + i, b.GetData(), T(0));
+            if(!unitDiagonal)
+                b[i] /= row[i];
+        }
+        return;
+    }
+
+    // column oriented: row i of L is column i of L^T
+    for(size_t i = size; i-- > 0;)
+    {
+        const auto row = l.Row(i);
+        if(!unitDiagonal)
+            b[i] /= row[i];
+        b.View().Subview(0, i).AddScaled(-b[i], row.Subview(0, i));
+    }
+}
+
+}
+
+template <typename T>
+packed_matrix<T>::packed_matrix(const matrix_view<const T> a) : packed_matrix(a.GetSizeY())
+{
+    detail::check_packed_square(a);
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x <= y; x++)
+            GetElement(x, y) = a.GetElement(x, y);
+}
+
+template <typename T>
+matrix<T> packed_matrix<T>::GetSymmetric() const
+{
+    matrix<T> result{size, size};
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x < size; x++)
+            result.GetElement(x, y) = GetElement(x, y);
+    return result;
+}
+
+template <typename T>
+matrix<T> packed_matrix<T>::GetLower() const
+{
+    matrix<T> result{size, size};
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x <= y; x++)
+            result.GetElement(x, y) = GetElement(x, y);
+    return result;
+}
+
+template <typename T>
+rfp_matrix<T>::rfp_matrix(const matrix_view<const T> a) : rfp_matrix(a.GetSizeY())
+{
+    detail::check_packed_square(a);
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x <= y; x++)
+            GetElement(x, y) = a.GetElement(x, y);
+}
+
+template <typename T>
+matrix<T> rfp_matrix<T>::GetSymmetric() const
+{
+    matrix<T> result{size, size};
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x < size; x++)
+            result.GetElement(x, y) = GetElement(x, y);
+    return result;
+}
+
+template <typename T>
+matrix<T> rfp_matrix<T>::GetLower() const
+{
+    matrix<T> result{size, size};
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x <= y; x++)
+            result.GetElement(x, y) = GetElement(x, y);
+    return result;
+}
+
+template <typename T>
+void llt_decomposition_in_place(packed_matrix<T>& a)
+{
+    for(size_t i = 0; i < a.GetSize(); i++)
+    {
+        T* rowI = a.Row(i).GetData();
+        for(size_t j = 0; j < i; j++)
+        {
+            const T* rowJ = a.Row(j).GetData();
+            rowI[j] = (rowI[j] - std::inner_product(rowI, rowI + j, rowJ, T(0))) / rowJ[j];
+        }
+
+        const T pivot = rowI[i] - std::inner_product(rowI, rowI + i, rowI, T(0));
+        if(!(pivot > T(0))) [[unlikely]] throw not_positive_definite(i);
+        rowI[i] = std::sqrt(pivot);
+    }
+}
+
+template <typename T>
+void ldlt_decomposition_in_place(packed_matrix<T>& a)
+{
+    for(size_t i = 0; i < a.GetSize(); i++)
+    {
+        // row i first collects t_j = L(i, j) D(j), which are turned into L(i, j) at the end
+        T* rowI = a.Row(i).GetData();
+        for(size_t j = 0; j < i; j++)
+            rowI[j] -= std::inner_product(rowI, rowI + j, a.Row(j).GetData(), T(0));
+
+        T diagonal = rowI[i];
+        for(size_t k = 0; k < i; k++)
+        {
+            const T l = rowI[k] / a.GetElement(k, k);
+            diagonal -= rowI[k] * l;
+            rowI[k] = l;
+        }
+        if(diagonal == T(0)) [[unlikely]] throw std::runtime_error("Zero pivot in ldlt decomposition");
+        rowI[i] = diagonal;
+    }
+}
+
+template <typename T>
+void llt_decomposition_in_place(rfp_matrix<T>& a, const size_t threads)
+{
+    const size_t n1 = a.GetLeadingSize();
+    const size_t n2 = a.GetTrailingSize();
+    const auto leading = a.GetLeadingBlock();
+    const auto offDiagonal = a.GetOffDiagonalBlock();
+    const auto trailing = a.GetTrailingBlock();
+
+    // L11^T in the upper triangle of the leading block, then L21^T = L11^-1 A21^T
+    llt_decomposition_in_place(leading, triangle::upper, threads);
+    constexpr bool transposed = true;
+    trsm<T>(triangle::upper, transposed, false, leading, offDiagonal);
+
+    // A22 -= L21 L21^T, then L22
+    syrk_lower<T>(n2, n1, T(-1), offDiagonal.GetData(), 1, offDiagonal.GetLeadingDimension(),
+                  trailing.GetData(), trailing.GetLeadingDimension(), 1, threads);
+    try
+    {
+        llt_decomposition_in_place(trailing, triangle::lower, threads);
+    }
+    catch(const not_positive_definite& e)
+    {
+        throw not_positive_definite(n1 + e.GetPivot());
+    }
+}
+
+template <typename T>
+vector<T> solve_low_trian_matrix_eq(const packed_matrix<T>& l, vector<T> b, const bool assumeDiagonalOnes, const bool transposed)
+{
+    detail::check_packed_rhs<T>(l.GetSize(), b.GetSize());
+    detail::packed_trsv(l, assumeDiagonalOnes, transposed, b);
+    return b;
+}
+
+template <typename T>
+vector<T> solve_low_trian_matrix_eq(const rfp_matrix<T>& l, vector<T> b, const bool assumeDiagonalOnes, const bool transposed)
+{
+    detail::check_packed_rhs<T>(l.GetSize(), b.GetSize());
+    detail::rfp_trsm(l, assumeDiagonalOnes, transposed, matrix_view<T>(b.GetData(), 1, b.GetSize(), 1));
+    return b;
+}
+
+template <typename T>
+matrix<T> solve_low_trian_matrix_eq(const rfp_matrix<T>& l, matrix<T> b, const bool assumeDiagonalOnes, const bool transposed)
+{
+    detail::check_packed_rhs<T>(l.GetSize(), b.GetSizeY());
+    detail::rfp_trsm(l, assumeDiagonalOnes, transposed, b.View());
+    return b;
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_packed(const packed_matrix<T>& llt, vector<T> b)
+{
+    detail::check_packed_rhs<T>(llt.GetSize(), b.GetSize());
+    constexpr bool transposed = true;
+    detail::packed_trsv(llt, false, false, b);
+    detail::packed_trsv(llt, false, transposed, b);
+    return b;
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_ldlt_packed(const packed_matrix<T>& ldlt, vector<T> b)
+{
+    detail::check_packed_rhs<T>(ldlt.GetSize(), b.GetSize());
+    constexpr bool assume_diagonal_ones = true;
+    constexpr bool transposed = true;
+    detail::packed_trsv(ldlt, assume_diagonal_ones, false, b);
+    for(size_t i = 0; i < b.GetSize(); i++)
+        b[i] /= ldlt.GetElement(i, i);
+    detail::packed_trsv(ldlt, assume_diagonal_ones, transposed, b);
+    return b;
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_packed(const rfp_matrix<T>& llt, vector<T> b)
+{
+    detail::check_packed_rhs<T>(llt.GetSize(), b.GetSize());
+    const matrix_view<T> rhs(b.GetData(), 1, b.GetSize(), 1);
+    detail::rfp_trsm(llt, false, false, rhs);
+    detail::rfp_trsm(llt, false, true, rhs);
+    return b;
+}
+
+template <typename T>
+matrix<T> solve_matrix_eq_with_llt_packed(const rfp_matrix<T>& llt, matrix<T> b)
+{
+    detail::check_packed_rhs<T>(llt.GetSize(), b.GetSizeY());
+    detail::rfp_trsm(llt, false, false, b.View());
+    detail::rfp_trsm(llt, false, true, b.View());
+    return b;
+}
+
+#define NUMERICALS_INSTANTIATE_PACKED_SOLVER(T) \
+    template class packed_matrix<T>; \
+    template class rfp_matrix<T>; \
+    template void llt_decomposition_in_place<T>(packed_matrix<T>&); \
+    template void ldlt_decomposition_in_place<T>(packed_matrix<T>&); \
+    template void llt_decomposition_in_place<T>(rfp_matrix<T>&, size_t); \
+    template vector<T> solve_low_trian_matrix_eq<T>(const packed_matrix<T>&, vector<T>, bool, bool); \
+    template vector<T> solve_low_trian_matrix_eq<T>(const rfp_matrix<T>&, vector<T>, bool, bool); \
+    template matrix<T> solve_low_trian_matrix_eq<T>(const rfp_matrix<T>&, matrix<T>, bool, bool); \
+    template vector<T> solve_matrix_eq_with_llt_packed<T>(const packed_matrix<T>&, vector<T>); \
+    template vector<T> solve_matrix_eq_with_ldlt_packed<T>(const packed_matrix<T>&, vector<T>); \
+    template vector<T> solve_matrix_eq_with_llt_packed<T>(const rfp_matrix<T>&, vector<T>); \
+    template matrix<T> solve_matrix_eq_with_llt_packed<T>(const rfp_matrix<T>&, matrix<T>);
+
+NUMERICALS_INSTANTIATE_PACKED_SOLVER(float)
+NUMERICALS_INSTANTIATE_PACKED_SOLVER(double)
+NUMERICALS_INSTANTIATE_PACKED_SOLVER(long double)
+#undef NUMERICALS_INSTANTIATE_PACKED_SOLVER
+
+}
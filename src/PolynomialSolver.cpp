@@ -6,107 +6,118 @@
 #include "vector.h"
 #include "MatrixSolver.h"
 
-real find_derivative(MFunc func, real x, real delta)
+template <typename T>
+T find_derivative(scalar_arg<MFuncOf<T>> func, scalar_arg<T> x, scalar_arg<T> delta)
 {
     return (func(x + delta) - func(x - delta))/(2 * delta);
 }
 
-real solve_polynomial(std::span<real> coefficients, const real x)
+template <typename T>
+T solve_polynomial(scalar_arg<std::span<T>> coefficients, const scalar_arg<T> x)
 {
-    real result{0.0};
+    T result{0.0};
     for (size_t i = 0; i < coefficients.size(); i++)
-        result += pow(x, i) * coefficients[i];
+        result += std::pow(x, i) * coefficients[i];
     
     return result;
 }
 
-real solve_polynomial_horner(std::span<real> coefficients, const real x)
+template <typename T>
+T solve_polynomial_horner(scalar_arg<std::span<T>> coefficients, const scalar_arg<T> x)
 {
-    real result{0.0};
+    T result{0.0};
     for(const auto& a : std::ranges::views::reverse(coefficients))
         result = result * x + a;
     return result;
 }
 
-std::vector<real> get_chebyshev_polynomial_zeros(size_t n, real a, real b)
+template <typename T>
+std::vector<T> get_chebyshev_polynomial_zeros(size_t n, scalar_arg<T> a, scalar_arg<T> b)
 {
-    std::vector<real> result(n);
+    std::vector<T> result(n);
    
     for(size_t i = 0; i < n; i++)
-        result[i] = ((a - b) * cos((2*i + 1.0) / (2*(n-1) + 2.0) * M_PI) + (a + b))*0.5f;
+        result[i] = ((a - b) * std::cos((2*i + 1.0) / (2*(n-1) + 2.0) * M_PI) + (a + b))*0.5f;
     return result;
 }
 
-real find_function_zero_with_bisection(MFunc func, real a, real b)
+template <typename T>
+T find_function_zero_with_bisection(scalar_arg<MFuncOf<T>> func, scalar_arg<T> a, scalar_arg<T> b)
 {
-    if(fabs(a - b) < 0.00001)
+    if(std::fabs(a - b) < 0.00001)
         return (a + b)/2;
     else
     {
         auto x = (a + b)/2;
         if(func(x) * func(a) > 0)
-            return find_function_zero_with_bisection(func, x, b);
+            return find_function_zero_with_bisection<T>(func, x, b);
         else
-            return find_function_zero_with_bisection(func, a, x);
+            return find_function_zero_with_bisection<T>(func, a, x);
     }
 }
 
-real find_function_zero_with_falsi(MFunc func, real a, real b)
+template <typename T>
+T find_function_zero_with_falsi(scalar_arg<MFuncOf<T>> func, scalar_arg<T> a, scalar_arg<T> b)
 {
-    if(fabs(func(a)) < 0.00001)
+    if(std::fabs(func(a)) < 0.00001)
         return a;
-    return find_function_zero_with_falsi(func, a - func(a) / (func(b) - func(a)) * (b - a), b);
+    return find_function_zero_with_falsi<T>(func, a - func(a) / (func(b) - func(a)) * (b - a), b);
 }
 
-real find_function_zero_with_secant(MFunc func, real a, real b)
+template <typename T>
+T find_function_zero_with_secant(scalar_arg<MFuncOf<T>> func, scalar_arg<T> a, scalar_arg<T> b)
 {
-    if(fabs(func(a)) < 0.00001)
+    if(std::fabs(func(a)) < 0.00001)
         return a;
-    return find_function_zero_with_secant(func, a - func(a) / (func(a) - func(b)) * (a - b), a);  
+    return find_function_zero_with_secant<T>(func, a - func(a) / (func(a) - func(b)) * (a - b), a);  
 }
 
-real find_function_zero_with_newton_raphson(MFunc func, real a, real b)
+template <typename T>
+T find_function_zero_with_newton_raphson(scalar_arg<MFuncOf<T>> func, scalar_arg<T> a, scalar_arg<T> b)
 {
-    real x;
-    if((find_derivative(func, a-1e-6, 1e-6) - find_derivative(func, a+1e-6, 1e-6))/2e-6 * a > 0)
+    T x;
+    if((find_derivative<T>(func, a-1e-6, 1e-6) - find_derivative<T>(func, a+1e-6, 1e-6))/2e-6 * a > 0)
         x = a;
     else
         x = b;
 
-    while (fabs(func(x)) > 1e-6 )
-        x -= func(x)/find_derivative(func, x, 1e6);
+    while (std::fabs(func(x)) > 1e-6 )
+        x -= func(x)/find_derivative<T>(func, x, 1e6);
 
     return x;
 }
 
 
-vector<real> get_polynomial_approximation(std::span<real> input, std::span<real> output, size_t n, std::vector<std::function<real(real)>> base)
+template <typename T>
+vector<T> get_polynomial_approximation(scalar_arg<std::span<T>> input, scalar_arg<std::span<T>> output, size_t n, std::vector<std::function<T(T)>> base)
 {
     size_t m = input.size();
-    vector<real> polynomial(m);
-    matrix<real> d(n + 1, m);
+    vector<T> polynomial(m);
+    matrix<T> d(n + 1, m);
     for(size_t y = 0; y < m; y++)
         for(size_t x = 0; x <= n; x++)
             if(base.empty())
-                d.GetElement(x, y) = pow(input[y], x);
+                d.GetElement(x, y) = std::pow(input[y], x);
             else
                 d.GetElement(x, y) = base[x](input[y]);
 
-    polynomial = numericals::solve_matrix_eq_jordan(d.Transposed() * d, d.Transposed() * vector<real>(output));
+    auto [normal, rhs] = numericals::get_normal_equations(d, vector<T>(output));
+    polynomial = numericals::solve_matrix_eq_jordan(std::move(normal), std::move(rhs));
 
     return polynomial;
 }
 
-MFunc get_lagrange_interpolation(std::span<real> input, std::span<real> output)
+template <typename T>
+MFuncOf<T> get_lagrange_interpolation(scalar_arg<std::span<T>> input, scalar_arg<std::span<T>> output)
 {
     size_t m = input.size();
 
-    return [m, input, output](real x)
+    return [m, input, output](T x)
     {
-        real sum = 0.0;
+        T sum = 0.0;
         for(size_t i = 0; i < m; i++)
         {
-            real mult = 1.0;
+            T mult = 1.0;
             for(size_t j = 0; j < m; j++)
                 if(i != j)
                     mult *= (x - input[j])/(input[i] - input[j]);
@@ -117,9 +128,10 @@ MFunc get_lagrange_interpolation(std::span<real> input, std::span<real> output)
     };
 }
 
-MFunc get_newton_interpolation(std::span<real> input, std::span<real> output)
+template <typename T>
+MFuncOf<T> get_newton_interpolation(scalar_arg<std::span<T>> input, scalar_arg<std::span<T>> output)
 {
-    std::vector<std::vector<real>> coeff; // [a[], f[], f'[], f''[],...]
+    std::vector<std::vector<T>> coeff; // [a[], f[], f'[], f''[],...]
 
     size_t n = input.size();
     coeff.push_back({});
@@ -132,16 +144,16 @@ MFunc get_newton_interpolation(std::span<real> input, std::span<real> output)
 
     for(size_t i = 2; i <= n; i++)
     {   
-        coeff.push_back(std::vector<real>(n - i + 1));
+        coeff.push_back(std::vector<T>(n - i + 1));
         for(size_t j = 0; j < n - i + 1; j++)
             coeff[i][j] = (coeff[i - 1][j + 1] - coeff[i - 1][j]) / (coeff[0][i - 1 + j] - coeff[0][j]);
     }
-    return [coeff = std::move(coeff), n](real x)
+    return [coeff = std::move(coeff), n](T x)
     {
-        real sum = 0.0;
+        T sum = 0.0;
         for(size_t i = 0; i < n; i++)
         {
-            real mul = coeff[i + 1][0];
+            T mul = coeff[i + 1][0];
             for(size_t j = 0; j < i; j++)
                 mul *= (x - coeff[0][j]);
            
@@ -150,3 +162,21 @@ MFunc get_newton_interpolation(std::span<real> input, std::span<real> output)
         return sum;
     };
 }
+
+#define NUMERICALS_INSTANTIATE_POLYNOMIAL_SOLVER(T) \
+    template T find_derivative<T>(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>); \
+    template T solve_polynomial<T>(scalar_arg<std::span<T>>, const scalar_arg<T>); \
+    template T solve_polynomial_horner<T>(scalar_arg<std::span<T>>, const scalar_arg<T>); \
+    template std::vector<T> get_chebyshev_polynomial_zeros<T>(size_t, scalar_arg<T>, scalar_arg<T>); \
+    template T find_function_zero_with_bisection<T>(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>); \
+    template T find_function_zero_with_falsi<T>(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>); \
+    template T find_function_zero_with_secant<T>(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>); \
+    template T find_function_zero_with_newton_raphson<T>(scalar_arg<MFuncOf<T>>, scalar_arg<T>, scalar_arg<T>); \
+    template vector<T> get_polynomial_approximation<T>(scalar_arg<std::span<T>>, scalar_arg<std::span<T>>, size_t, std::vector<std::function<T(T)>>); \
+    template MFuncOf<T> get_lagrange_interpolation<T>(scalar_arg<std::span<T>>, scalar_arg<std::span<T>>); \
+    template MFuncOf<T> get_newton_interpolation<T>(scalar_arg<std::span<T>>, scalar_arg<std::span<T>>);
+
+NUMERICALS_INSTANTIATE_POLYNOMIAL_SOLVER(float)
+NUMERICALS_INSTANTIATE_POLYNOMIAL_SOLVER(double)
+NUMERICALS_INSTANTIATE_POLYNOMIAL_SOLVER(long double)
+#undef NUMERICALS_INSTANTIATE_POLYNOMIAL_SOLVER
@@ -0,0 +1,548 @@
+#include "SparseSolver.h"
+#include "MatrixDecomposer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace numericals {
+
+namespace detail {
+
+constexpr size_t no_index = size_t(-1);
+
+template <typename T>
+void check_sparse_square(const csc_matrix<T>& a)
+{
+    if(a.GetSizeX() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Sparse factorization of a non-square matrix");
+}
+
+template <typename T>
+std::vector<size_t> fill_order(const csc_matrix<T>& a, const fill_ordering ordering)
+{
+    if(ordering == fill_ordering::approximate_minimum_degree) return approximate_minimum_degree_ordering(a);
+
+    std::vector<size_t> order(a.GetSizeX());
+    std::iota(order.begin(), order.end(), size_t(0));
+    return order;
+}
+
+// Columns of a sparse factor under construction: row indices and values appended column by
+// column, offsets[j + 1] set once column j is complete.
+template <typename T>
+struct growing_factor
+{
+    std::vector<size_t> offsets;
+    std::vector<size_t> indices;
+    std::vector<T> values;
+
+    void Append(const size_t row, const T value)
+    {
+        indices.push_back(row);
+        values.push_back(value);
+    }
+
+    // columns come out in topological order; compressed matrices keep their rows ascending
+    void SortColumns()
+    {
+        std::vector<std::pair<size_t, T>> column;
+        for(size_t j = 0; j + 1 < offsets.size(); j++)
+        {
+            column.clear();
+            for(size_t p = offsets[j]; p < offsets[j + 1]; p++)
+                column.emplace_back(indices[p], values[p]);
+            std::sort(column.begin(), column.end(), [](const auto& l, const auto& r) { return l.first < r.first; });
+            for(size_t p = offsets[j]; p < offsets[j + 1]; p++)
+                std::tie(indices[p], values[p]) = column[p - offsets[j]];
+        }
+    }
+};
+
+// Rows reachable in the graph of the first columns of l from the pattern of column k of b,
+// left in topological order in xi[top, n). Column j of l stands for row pinv^-1(j); rows not
+// yet pivotal (pinv no_index) have no edges. marks and stack are size n scratch space.
+template <typename T>
+size_t sparse_reach(const growing_factor<T>& l, const csc_matrix<T>& b, const size_t k, const std::vector<size_t>& pinv,
+                    std::vector<size_t>& xi, std::vector<size_t>& stack, std::vector<size_t>& positions, std::vector<char>& marks)
+{
+    const size_t n = pinv.size();
+    size_t top = n;
+    const auto& bOffsets = b.GetOffsets();
+    const auto& bIndices = b.GetIndices();
+    for(size_t p = bOffsets[k]; p < bOffsets[k + 1]; p++)
+    {
+        if(marks[bIndices[p]]) continue;
+
+        // iterative depth-first search from the row
+        size_t head = 0;
+        stack[0] = bIndices[p];
+        while(head != no_index)
+        {
+            const size_t j = stack[head];
+            const size_t column = pinv[j];
+            if(!marks[j])
+            {
+                marks[j] = 1;
+                positions[head] = column == no_index ? 0 : l.offsets[column] + 1;
+            }
+
+            bool done = true;
+            const size_t end = column == no_index ? 0 : l.offsets[column + 1];
+            for(size_t q = positions[head]; q < end; q++)
+            {
+                const size_t i = l.indices[q];
+                if(marks[i]) continue;
+                positions[head] = q + 1;
+                stack[++head] = i;
+                done = false;
+                break;
+            }
+            if(done)
+            {
+                head--;
+                xi[--top] = j;
+            }
+        }
+    }
+    for(size_t p = top; p < n; p++)
+        marks[xi[p]] = 0;
+    return top;
+}
+
+// Pattern of row k of L from the elimination tree: every path from an entry of the upper
+// column k of c up towards k. Left in s[top, n); marks is cleared again on return.
+template <typename T>
+size_t elimination_reach(const csc_matrix<T>& c, const size_t k, const std::vector<size_t>& parent,
+                         std::vector<size_t>& s, std::vector<char>& marks)
+{
+    const size_t n = parent.size();
+    size_t top = n;
+    marks[k] = 1;
+    const auto& offsets = c.GetOffsets();
+    const auto& indices = c.GetIndices();
+    for(size_t p = offsets[k]; p < offsets[k + 1]; p++)
+    {
+        size_t i = indices[p];
+        if(i > k) continue;
+        size_t length = 0;
+        for(; !marks[i]; i = parent[i])
+        {
+            s[length++] = i;
+            marks[i] = 1;
+        }
+        while(length > 0)
+            s[--top] = s[--length];
+    }
+    for(size_t p = top; p < n; p++)
+        marks[s[p]] = 0;
+    marks[k] = 0;
+    return top;
+}
+
+// Upper triangle of P A P^T for the upper triangle of a, with order[k] the k-th row and column
+template <typename T>
+csc_matrix<T> symmetric_permute(const csc_matrix<T>& a, const std::vector<size_t>& order)
+{
+    const size_t n = a.GetSizeX();
+    std::vector<size_t> pinv(n);
+    for(size_t k = 0; k < n; k++)
+        pinv[order[k]] = k;
+
+    std::vector<triplet<T>> entries;
+    entries.reserve(a.GetNonZeroCount());
+    const auto& offsets = a.GetOffsets();
+    const auto& indices = a.GetIndices();
+    const auto& values = a.GetValues();
+    for(size_t j = 0; j < n; j++)
+        for(size_t p = offsets[j]; p < offsets[j + 1]; p++)
+        {
+            const size_t i = indices[p];
+            if(i > j) continue;
+            const size_t x = std::max(pinv[i], pinv[j]);
+            const size_t y = std::min(pinv[i], pinv[j]);
+            entries.push_back({x, y, values[p]});
+        }
+    return csc_matrix<T>(n, n, std::span<const triplet<T>>(entries));
+}
+
+// Elimination tree of the upper triangle of c: parent[j] is the first row below j in column j of L
+template <typename T>
+std::vector<size_t> elimination_tree(const csc_matrix<T>& c)
+{
+    const size_t n = c.GetSizeX();
+    std::vector<size_t> parent(n, no_index), ancestor(n, no_index);
+    const auto& offsets = c.GetOffsets();
+    const auto& indices = c.GetIndices();
+    for(size_t k = 0; k < n; k++)
+        for(size_t p = offsets[k]; p < offsets[k + 1]; p++)
+        {
+            // climb from i to the root of its subtree with path compression, then hang it under k
+            for(size_t i = indices[p]; i != no_index && i < k;)
+            {
+                const size_t next = ancestor[i];
+                ancestor[i] = k;
+                if(next == no_index) parent[i] = k;
+                i = next;
+            }
+        }
+    return parent;
+}
+
+}
+
+template <typename T>
+std::vector<size_t> approximate_minimum_degree_ordering(const csc_matrix<T>& a)
+{
+    detail::check_sparse_square(a);
+    const size_t n = a.GetSizeX();
+
+    // quotient graph: every variable keeps its remaining original neighbours and the elements
+    // (eliminated nodes) it belongs to; an element keeps the variables it connects
+    std::vector<std::vector<size_t>> variables(n);
+    std::vector<std::vector<size_t>> elements(n);
+    const auto& offsets = a.GetOffsets();
+    const auto& indices = a.GetIndices();
+    for(size_t j = 0; j < n; j++)
+        for(size_t p = offsets[j]; p < offsets[j + 1]; p++)
+            if(indices[p] != j)
+            {
+                variables[j].push_back(indices[p]);
+                variables[indices[p]].push_back(j);
+            }
+    std::set<std::pair<size_t, size_t>> byDegree;
+    std::vector<size_t> degree(n);
+    for(size_t i = 0; i < n; i++)
+    {
+        auto& neighbours = variables[i];
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        degree[i] = neighbours.size();
+        byDegree.emplace(degree[i], i);
+    }
+
+    std::vector<size_t> order;
+    order.reserve(n);
+    std::vector<char> eliminated(n, 0), absorbed(n, 0);
+    std::vector<size_t> marks(n, 0), outside(n, detail::no_index), touched, pattern;
+    size_t stamp = 0;
+    while(!byDegree.empty())
+    {
+        const size_t node = byDegree.begin()->second;
+        byDegree.erase(byDegree.begin());
+        order.push_back(node);
+        eliminated[node] = 1;
+
+        // the new element: the node's variables and those of the elements it absorbs
+        stamp++;
+        marks[node] = stamp;
+        pattern.clear();
+        const auto add = [&](const size_t j)
+        {
+            if(eliminated[j] || marks[j] == stamp) return;
+            marks[j] = stamp;
+            pattern.push_back(j);
+        };
+        for(const size_t j : variables[node])
+            add(j);
+        for(const size_t e : elements[node])
+        {
+            if(absorbed[e]) continue;
+            for(const size_t j : variables[e])
+                add(j);
+            absorbed[e] = 1;
+            std::vector<size_t>().swap(variables[e]);
+        }
+        std::vector<size_t>().swap(elements[node]);
+
+        // |Le \ Lnode| for the other elements next to the pattern
+        touched.clear();
+        for(const size_t i : pattern)
+            for(const size_t e : elements[i])
+            {
+                if(absorbed[e]) continue;
+                if(outside[e] == detail::no_index)
+                {
+                    outside[e] = variables[e].size();
+                    touched.push_back(e);
+                }
+                outside[e]--;
+            }
+
+        // approximate external degrees: what is left of the variable's own neighbours, the new
+        // element and the parts of its other elements outside of it
+        const size_t remaining = n - order.size();
+        for(const size_t i : pattern)
+        {
+            auto& neighbours = variables[i];
+            std::erase_if(neighbours, [&](const size_t j) { return eliminated[j] || marks[j] == stamp; });
+            auto& adjacent = elements[i];
+            std::erase_if(adjacent, [&](const size_t e) { return absorbed[e] != 0; });
+
+            size_t estimate = neighbours.size() + pattern.size() - 1;
+            for(const size_t e : adjacent)
+                estimate += outside[e];
+            adjacent.push_back(node);
+
+            byDegree.erase({degree[i], i});
+            degree[i] = std::min(estimate, remaining - 1);
+            byDegree.emplace(degree[i], i);
+        }
+        for(const size_t e : touched)
+            outside[e] = detail::no_index;
+        variables[node] = pattern;
+    }
+    return order;
+}
+
+template <typename T>
+SparseLUFactorization<T>::SparseLUFactorization(const csc_matrix<T>& a, const fill_ordering ordering)
+    : size(a.GetSizeX()), lower(0, 0), upper(0, 0)
+{
+    detail::check_sparse_square(a);
+    columnOrder = detail::fill_order(a, ordering);
+
+    using detail::no_index;
+    detail::growing_factor<T> l, u;
+    l.offsets.assign(size + 1, 0);
+    u.offsets.assign(size + 1, 0);
+    rowPermutation.assign(size, no_index);
+    std::vector<T> x(size, T(0));
+    std::vector<size_t> xi(size), stack(size), positions(size);
+    std::vector<char> marks(size, 0);
+    const auto& aOffsets = a.GetOffsets();
+    const auto& aIndices = a.GetIndices();
+    const auto& aValues = a.GetValues();
+
+    for(size_t k = 0; k < size; k++)
+    {
+        l.offsets[k] = l.indices.size();
+        u.offsets[k] = u.indices.size();
+        const size_t column = columnOrder[k];
+
+        // x = L^-1 A(:, column) over the reach of the column's pattern
+        const size_t top = detail::sparse_reach(l, a, column, rowPermutation, xi, stack, positions, marks);
+        for(size_t p = top; p < size; p++)
+            x[xi[p]] = T(0);
+        for(size_t p = aOffsets[column]; p < aOffsets[column + 1]; p++)
+            x[aIndices[p]] = aValues[p];
+        for(size_t p = top; p < size; p++)
+        {
+            const size_t j = xi[p];
+            const size_t pivotColumn = rowPermutation[j];
+            if(pivotColumn == no_index) continue;
+            for(size_t q = l.offsets[pivotColumn] + 1; q < l.offsets[pivotColumn + 1]; q++)
+                x[l.indices[q]] -= l.values[q] * x[j];
+        }
+
+        // U takes the pivotal rows, the largest of the others becomes the pivot
+        size_t pivot = no_index;
+        T largest = T(-1);
+        for(size_t p = top; p < size; p++)
+        {
+            const size_t i = xi[p];
+            if(rowPermutation[i] == no_index)
+            {
+                if(std::abs(x[i]) > largest)
+                {
+                    largest = std::abs(x[i]);
+                    pivot = i;
+                }
+            }
+            else
+                u.Append(rowPermutation[i], x[i]);
+        }
+        if(pivot == no_index || largest <= T(0)) [[unlikely]] throw std::runtime_error("Singular matrix in sparse lu decomposition");
+        if(rowPermutation[column] == no_index && std::abs(x[column]) >= lu_pivot_threshold * largest)
+            pivot = column;
+
+        const T diagonal = x[pivot];
+        u.Append(k, diagonal);
+        rowPermutation[pivot] = k;
+        l.Append(pivot, T(1));
+        for(size_t p = top; p < size; p++)
+        {
+            const size_t i = xi[p];
+            if(rowPermutation[i] == no_index)
+                l.Append(i, x[i] / diagonal);
+            x[i] = T(0);
+        }
+    }
+    l.offsets[size] = l.indices.size();
+    u.offsets[size] = u.indices.size();
+
+    // L was built with the rows of a; renumber them to pivot order
+    for(size_t& i : l.indices)
+        i = rowPermutation[i];
+    l.SortColumns();
+    u.SortColumns();
+    lower = csc_matrix<T>(size, size, std::move(l.offsets), std::move(l.indices), std::move(l.values));
+    upper = csc_matrix<T>(size, size, std::move(u.offsets), std::move(u.indices), std::move(u.values));
+}
+
+template <typename T>
+void SparseLUFactorization<T>::SolveInPlace(const matrix_view<T> b) const
+{
+    if(b.GetSizeY() != size) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+
+    const auto& lOffsets = lower.GetOffsets();
+    const auto& lIndices = lower.GetIndices();
+    const auto& lValues = lower.GetValues();
+    const auto& uOffsets = upper.GetOffsets();
+    const auto& uIndices = upper.GetIndices();
+    const auto& uValues = upper.GetValues();
+    std::vector<T> x(size);
+    for(size_t c = 0; c < b.GetSizeX(); c++)
+    {
+        const auto column = b.Column(c);
+        for(size_t i = 0; i < size; i++)
+            x[rowPermutation[i]] = column[i];
+
+        // L has its unit diagonal first in every column, U its diagonal last
+        for(size_t j = 0; j < size; j++)
+            for(size_t p = lOffsets[j] + 1; p < lOffsets[j + 1]; p++)
+                x[lIndices[p]] -= lValues[p] * x[j];
+        for(size_t j = size; j-- > 0;)
+        {
+            x[j] /= uValues[uOffsets[j + 1] - 1];
+            for(size_t p = uOffsets[j]; p + 1 < uOffsets[j + 1]; p++)
+                x[uIndices[p]] -= uValues[p] * x[j];
+        }
+
+        for(size_t k = 0; k < size; k++)
+            column[columnOrder[k]] = x[k];
+    }
+}
+
+template <typename T>
+SparseLLTFactorization<T>::SparseLLTFactorization(const csc_matrix<T>& a, const fill_ordering ordering)
+    : size(a.GetSizeX()), lower(0, 0)
+{
+    detail::check_sparse_square(a);
+    order = detail::fill_order(a, ordering);
+    const csc_matrix<T> c = detail::symmetric_permute(a, order);
+    const std::vector<size_t> parent = detail::elimination_tree(c);
+
+    // column counts of L from the row patterns, so L is filled in place
+    std::vector<size_t> s(size);
+    std::vector<char> marks(size, 0);
+    std::vector<size_t> offsets(size + 1, 0);
+    for(size_t k = 0; k < size; k++)
+    {
+        for(size_t p = detail::elimination_reach(c, k, parent, s, marks); p < size; p++)
+            offsets[s[p] + 1]++;
+        offsets[k + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<size_t> indices(offsets[size]);
+    std::vector<T> values(offsets[size]);
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    std::vector<T> x(size, T(0));
+    const auto& cOffsets = c.GetOffsets();
+    const auto& cIndices = c.GetIndices();
+    const auto& cValues = c.GetValues();
+
+    // up-looking: row k of L from a triangular solve with the rows above it
+    for(size_t k = 0; k < size; k++)
+    {
+        const size_t top = detail::elimination_reach(c, k, parent, s, marks);
+        for(size_t p = cOffsets[k]; p < cOffsets[k + 1]; p++)
+            if(cIndices[p] <= k)
+                x[cIndices[p]] = cValues[p];
+        T diagonal = x[k];
+        x[k] = T(0);
+        for(size_t p = top; p < size; p++)
+        {
+            const size_t i = s[p];
+            const T lki = x[i] / values[offsets[i]];
+            x[i] = T(0);
+            for(size_t q = offsets[i] + 1; q < next[i]; q++)
+                x[indices[q]] -= values[q] * lki;
+            diagonal -= lki * lki;
+            indices[next[i]] = k;
+            values[next[i]++] = lki;
+        }
+        if(!(diagonal > T(0))) [[unlikely]] throw not_positive_definite(order[k]);
+        indices[next[k]] = k;
+        values[next[k]++] = std::sqrt(diagonal);
+    }
+    lower = csc_matrix<T>(size, size, std::move(offsets), std::move(indices), std::move(values));
+}
+
+template <typename T>
+void SparseLLTFactorization<T>::SolveInPlace(const matrix_view<T> b) const
+{
+    if(b.GetSizeY() != size) [[unlikely]] throw std::runtime_error("Wrong right-hand side size in solver");
+
+    const auto& offsets = lower.GetOffsets();
+    const auto& indices = lower.GetIndices();
+    const auto& values = lower.GetValues();
+    std::vector<T> x(size);
+    for(size_t c = 0; c < b.GetSizeX(); c++)
+    {
+        const auto column = b.Column(c);
+        for(size_t k = 0; k < size; k++)
+            x[k] = column[order[k]];
+
+        // the diagonal leads every column of L
+        for(size_t j = 0; j < size; j++)
+        {
+            x[j] /= values[offsets[j]];
+            for(size_t p = offsets[j] + 1; p < offsets[j + 1]; p++)
+                x[indices[p]] -= values[p] * x[j];
+        }
+        for(size_t j = size; j-- > 0;)
+        {
+            for(size_t p = offsets[j] + 1; p < offsets[j + 1]; p++)
+                x[j] -= values[p] * x[indices[p]];
+            x[j] /= values[offsets[j]];
+        }
+
+        for(size_t k = 0; k < size; k++)
+            column[order[k]] = x[k];
+    }
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_lu_decomposition(const csr_matrix<T>& a, const vector<T>& b)
+{
+    return SparseLUFactorization<T>(csc_matrix<T>(a)).Solve(b);
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_lu_decomposition(const csc_matrix<T>& a, const vector<T>& b)
+{
+    return SparseLUFactorization<T>(a).Solve(b);
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_decomposition(const csr_matrix<T>& a, const vector<T>& b)
+{
+    return SparseLLTFactorization<T>(csc_matrix<T>(a)).Solve(b);
+}
+
+template <typename T>
+vector<T> solve_matrix_eq_with_llt_decomposition(const csc_matrix<T>& a, const vector<T>& b)
+{
+    return SparseLLTFactorization<T>(a).Solve(b);
+}
+
+#define NUMERICALS_INSTANTIATE_SPARSE_SOLVER(T) \
+    template std::vector<size_t> approximate_minimum_degree_ordering<T>(const csc_matrix<T>&); \
+    template class SparseLUFactorization<T>; \
+    template class SparseLLTFactorization<T>; \
+    template vector<T> solve_matrix_eq_with_lu_decomposition<T>(const csr_matrix<T>&, const vector<T>&); \
+    template vector<T> solve_matrix_eq_with_lu_decomposition<T>(const csc_matrix<T>&, const vector<T>&); \
+    template vector<T> solve_matrix_eq_with_llt_decomposition<T>(const csr_matrix<T>&, const vector<T>&); \
+    template vector<T> solve_matrix_eq_with_llt_decomposition<T>(const csc_matrix<T>&, const vector<T>&);
+
+NUMERICALS_INSTANTIATE_SPARSE_SOLVER(float)
+NUMERICALS_INSTANTIATE_SPARSE_SOLVER(double)
+NUMERICALS_INSTANTIATE_SPARSE_SOLVER(long double)
+#undef NUMERICALS_INSTANTIATE_SPARSE_SOLVER
+
+}
@@ -0,0 +1,77 @@
+#include "instrumentation.h"
+
+#include <algorithm>
+
+namespace numericals {
+
+const char* to_string(const solver_phase phase)
+{
+    switch(phase)
+    {
+        case solver_phase::factorization: return "factorization";
+        case solver_phase::pivot_search: return "pivot_search";
+        case solver_phase::swaps: return "swaps";
+        case solver_phase::substitution: return "substitution";
+        default: return "unknown";
+    }
+}
+
+namespace {
+
+// Adds the time and counters of from into into
+void accumulate(call_statistics& into, const call_statistics& from)
+{
+    for(size_t p = 0; p < into.phase_time.size(); p++)
+        into.phase_time[p] += from.phase_time[p];
+    into.flops += from.flops;
+    into.bytes += from.bytes;
+    into.pivot_swaps += from.pivot_swaps;
+    into.min_pivot = std::min(into.min_pivot, from.min_pivot);
+}
+
+}
+
+namespace detail {
+
+instrumented_call::~instrumented_call()
+{
+    sink.open.pop_back();
+    call_statistics& call = sink.calls[index];
+    call.time = std::chrono::steady_clock::now() - start;
+    call.allocations = heap_allocation_count - allocations;
+    if(!sink.open.empty())
+        accumulate(sink.calls[sink.open.back()], call);
+}
+
+}
+
+call_statistics instrumentation_sink::Summarize(const std::string_view function) const
+{
+    call_statistics total;
+    for(const auto& call : calls)
+        if(function == call.function)
+        {
+            total.function = call.function;
+            total.size = std::max(total.size, call.size);
+            total.time += call.time;
+            total.allocations += call.allocations;
+            accumulate(total, call);
+        }
+    return total;
+}
+
+void instrumentation_sink::Dump(std::FILE* file) const
+{
+    for(const auto& call : calls)
+    {
+        std::fprintf(file, "%*s%s n=%zu time=%.3es", int(2 * call.depth), "", call.function, call.size,
+                     std::chrono::duration<double>(call.time).count());
+        for(size_t p = 0; p < call.phase_time.size(); p++)
+            if(call.phase_time[p].count() != 0)
+                std::fprintf(file, " %s=%.3es", to_string(solver_phase(p)), std::chrono::duration<double>(call.phase_time[p]).count());
+        std::fprintf(file, " flops=%.4g bytes=%.4g swaps=%zu allocations=%zu min_pivot=%.3e\n",
+                     call.flops, call.bytes, call.pivot_swaps, call.allocations, call.min_pivot);
+    }
+}
+
+}
@@ -0,0 +1,103 @@
+#include "memory_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <new>
+
+namespace {
+constexpr size_t chunk_alignment = 64;
+}
+
+memory_arena::~memory_arena()
+{
+    for(const auto& c : chunks)
+        ::operator delete(c.data, std::align_val_t(chunk_alignment));
+}
+
+void* memory_arena::AllocateFromChunks(const size_t bytes, const size_t alignment, const size_t phase)
+{
+    const size_t startChunk = current, startOffset = offset;
+    for(; current < chunks.size(); current++, offset = 0)
+    {
+        const auto base = reinterpret_cast<std::uintptr_t>(chunks[current].data);
+        const size_t aligned = ((base + offset - phase + alignment - 1) & ~std::uintptr_t(alignment - 1)) + phase - base;
+        if(aligned + bytes <= chunks[current].size)
+        {
+            used += aligned - offset + bytes;
+            offset = aligned + bytes;
+            stats.allocations++;
+            stats.peak_bytes = std::max(stats.peak_bytes, used);
+            return chunks[current].data + aligned;
+        }
+    }
+    // nothing fitted: keep the cursor where it was, smaller requests may still fit there and
+    // only AddChunk moves it on
+    current = startChunk;
+    offset = startOffset;
+    return nullptr;
+}
+
+void* memory_arena::AddChunk(const size_t bytes, const size_t alignment, const size_t phase)
+{
+    const size_t size = std::max(chunk_size, bytes + alignment);
+    std::byte* data = static_cast<std::byte*>(::operator new(size, std::align_val_t(chunk_alignment)));
+    chunks.push_back({data, size});
+    current = chunks.size() - 1;
+    offset = 0;
+    return AllocateFromChunks(bytes, alignment, phase);
+}
+
+void* memory_arena::Allocate(const size_t bytes, const size_t alignment, const size_t phase)
+{
+    if(void* p = AllocateFromChunks(bytes, alignment, phase)) return p;
+    return AddChunk(bytes, alignment, phase);
+}
+
+void* memory_arena::TryAllocate(const size_t bytes, const size_t alignment, const size_t phase)
+{
+    if(void* p = AllocateFromChunks(bytes, alignment, phase)) return p;
+    if(GetCapacity() + std::max(chunk_size, bytes + alignment) > capacity_limit)
+    {
+        stats.heap_fallbacks++;
+        return nullptr;
+    }
+    return AddChunk(bytes, alignment, phase);
+}
+
+void memory_arena::Release()
+{
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+void memory_arena::Rewind(const mark m)
+{
+    current = m.chunk;
+    offset = m.offset;
+    used = m.used;
+}
+
+bool memory_arena::Owns(const void* p) const
+{
+    const std::less<const void*> before;
+    for(const auto& c : chunks)
+        if(!before(p, c.data) && before(p, c.data + c.size))
+            return true;
+    return false;
+}
+
+size_t memory_arena::GetCapacity() const
+{
+    size_t capacity = 0;
+    for(const auto& c : chunks)
+        capacity += c.size;
+    return capacity;
+}
+
+memory_arena& memory_arena::ThreadDefault()
+{
+    thread_local memory_arena arena;
+    return arena;
+}
@@ -0,0 +1,188 @@
+#include "sparse_matrix.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace numericals {
+
+namespace detail {
+
+// Stored entries handed to one thread at the least by the sparse products
+constexpr size_t sparse_entries_per_thread = 1 << 15;
+
+// Compresses (outer, inner, value) entries by a counting sort on the outer index, then sorts
+// each outer slice by inner index and sums repeated positions.
+template <typename T>
+void compress(const size_t outerSize, const std::vector<std::pair<size_t, size_t>>& positions, std::span<const T> entryValues,
+              std::vector<size_t>& offsets, std::vector<size_t>& indices, std::vector<T>& values)
+{
+    std::vector<size_t> counts(outerSize + 1, 0);
+    for(const auto& [outer, inner] : positions)
+        counts[outer + 1]++;
+    std::partial_sum(counts.begin(), counts.end(), counts.begin());
+
+    std::vector<std::pair<size_t, T>> slots(positions.size());
+    std::vector<size_t> next(counts.begin(), counts.end() - 1);
+    for(size_t e = 0; e < positions.size(); e++)
+        slots[next[positions[e].first]++] = {positions[e].second, entryValues[e]};
+
+    offsets.assign(outerSize + 1, 0);
+    indices.clear();
+    values.clear();
+    indices.reserve(slots.size());
+    values.reserve(slots.size());
+    for(size_t o = 0; o < outerSize; o++)
+    {
+        const auto first = slots.begin() + ptrdiff_t(counts[o]);
+        const auto last = slots.begin() + ptrdiff_t(counts[o + 1]);
+        std::sort(first, last, [](const auto& l, const auto& r) { return l.first < r.first; });
+        for(auto it = first; it != last; ++it)
+        {
+            if(indices.size() > offsets[o] && indices.back() == it->first)
+                values.back() += it->second;
+            else
+            {
+                indices.push_back(it->first);
+                values.push_back(it->second);
+            }
+        }
+        offsets[o + 1] = indices.size();
+    }
+}
+
+}
+
+template <typename T, sparse_layout Layout>
+compressed_matrix<T, Layout>::compressed_matrix(const size_t size_x, const size_t size_y, const std::span<const triplet<T>> entries)
+    : size_x(size_x), size_y(size_y)
+{
+    std::vector<std::pair<size_t, size_t>> positions(entries.size());
+    std::vector<T> entryValues(entries.size());
+    for(size_t e = 0; e < entries.size(); e++)
+    {
+        const auto& [x, y, value] = entries[e];
+        if(x >= size_x || y >= size_y) [[unlikely]] throw std::runtime_error("Sparse matrix entry out of range");
+        positions[e] = Layout == sparse_layout::rows ? std::pair{y, x} : std::pair{x, y};
+        entryValues[e] = value;
+    }
+    detail::compress<T>(OuterSize(), positions, entryValues, offsets, indices, values);
+}
+
+template <typename T, sparse_layout Layout>
+compressed_matrix<T, Layout>::compressed_matrix(const size_t size_x, const size_t size_y, std::vector<size_t> offsets,
+                                                std::vector<size_t> indices, std::vector<T> values)
+    : size_x(size_x), size_y(size_y), offsets(std::move(offsets)), indices(std::move(indices)), values(std::move(values))
+{
+    if(this->offsets.size() != OuterSize() + 1 || this->indices.size() != this->values.size() || this->offsets.back() != this->values.size())
+        [[unlikely]] throw std::runtime_error("Inconsistent compressed sparse arrays");
+}
+
+template <typename T, sparse_layout Layout>
+template <sparse_layout Other> requires (Other != Layout)
+compressed_matrix<T, Layout>::compressed_matrix(const compressed_matrix<T, Other>& other)
+    : size_x(other.GetSizeX()), size_y(other.GetSizeY()), offsets(OuterSize() + 1, 0),
+      indices(other.GetNonZeroCount()), values(other.GetNonZeroCount())
+{
+    // a transposition of the compressed arrays: counting sort on the other's inner index keeps
+    // the new inner indices ascending
+    const auto& otherOffsets = other.GetOffsets();
+    const auto& otherIndices = other.GetIndices();
+    const auto& otherValues = other.GetValues();
+    for(const size_t i : otherIndices)
+        offsets[i + 1]++;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for(size_t o = 0; o + 1 < otherOffsets.size(); o++)
+        for(size_t p = otherOffsets[o]; p < otherOffsets[o + 1]; p++)
+        {
+            const size_t slot = next[otherIndices[p]]++;
+            indices[slot] = o;
+            values[slot] = otherValues[p];
+        }
+}
+
+template <typename T, sparse_layout Layout>
+T compressed_matrix<T, Layout>::GetElement(const size_t x, const size_t y) const
+{
+    const size_t outer = Layout == sparse_layout::rows ? y : x;
+    const size_t inner = Layout == sparse_layout::rows ? x : y;
+    const auto first = indices.begin() + ptrdiff_t(offsets[outer]);
+    const auto last = indices.begin() + ptrdiff_t(offsets[outer + 1]);
+    const auto it = std::lower_bound(first, last, inner);
+    return it != last && *it == inner ? values[size_t(it - indices.begin())] : T(0);
+}
+
+template <typename T, sparse_layout Layout>
+matrix<T> compressed_matrix<T, Layout>::ToDense() const
+{
+    matrix<T> result{size_x, size_y};
+    for(size_t o = 0; o < OuterSize(); o++)
+        for(size_t p = offsets[o]; p < offsets[o + 1]; p++)
+        {
+            if constexpr(Layout == sparse_layout::rows) result.GetElement(indices[p], o) = values[p];
+            else result.GetElement(o, indices[p]) = values[p];
+        }
+    return result;
+}
+
+template <typename T>
+void multiply(const csr_matrix<T>& a, const vector_view<const T> x, const vector_view<T> y, size_t threads)
+{
+    if(x.GetSize() != a.GetSizeX() || y.GetSize() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in sparse product");
+
+    const auto& offsets = a.GetOffsets();
+    const size_t* indices = a.GetIndices().data();
+    const T* values = a.GetValues().data();
+    const size_t entries = a.GetNonZeroCount();
+    threads = threads_for(entries / detail::sparse_entries_per_thread, threads);
+
+    // chunk t starts at the first row holding its share t * entries / threads of the entries
+    const auto chunk_begin = [&](const size_t t)
+    {
+        const size_t entry = t * entries / threads;
+        return size_t(std::lower_bound(offsets.begin(), offsets.end() - 1, entry) - offsets.begin());
+    };
+    parallel_for(0, threads, threads, [&](const size_t first, const size_t last, size_t)
+    {
+        const size_t rowEnd = last == threads ? a.GetSizeY() : chunk_begin(last);
+        for(size_t r = chunk_begin(first); r < rowEnd; r++)
+        {
+            T sum = T(0);
+            for(size_t p = offsets[r]; p < offsets[r + 1]; p++)
+                sum += values[p] * x[indices[p]];
+            y[r] = sum;
+        }
+    });
+}
+
+template <typename T>
+void multiply(const csc_matrix<T>& a, const vector_view<const T> x, const vector_view<T> y)
+{
+    if(x.GetSize() != a.GetSizeX() || y.GetSize() != a.GetSizeY()) [[unlikely]] throw std::runtime_error("Wrong matrix-vector sizes in sparse product");
+
+    const auto& offsets = a.GetOffsets();
+    const auto& indices = a.GetIndices();
+    const auto& values = a.GetValues();
+    y = T(0);
+    for(size_t c = 0; c < a.GetSizeX(); c++)
+        for(size_t p = offsets[c]; p < offsets[c + 1]; p++)
+            y[indices[p]] += values[p] * x[c];
+}
+
+#define NUMERICALS_INSTANTIATE_SPARSE_MATRIX(T) \
+    template class compressed_matrix<T, sparse_layout::rows>; \
+    template class compressed_matrix<T, sparse_layout::columns>; \
+    template compressed_matrix<T, sparse_layout::rows>::compressed_matrix(const compressed_matrix<T, sparse_layout::columns>&); \
+    template compressed_matrix<T, sparse_layout::columns>::compressed_matrix(const compressed_matrix<T, sparse_layout::rows>&); \
+    template void multiply<T>(const csr_matrix<T>&, vector_view<const T>, vector_view<T>, size_t); \
+    template void multiply<T>(const csc_matrix<T>&, vector_view<const T>, vector_view<T>);
+
+NUMERICALS_INSTANTIATE_SPARSE_MATRIX(float)
+NUMERICALS_INSTANTIATE_SPARSE_MATRIX(double)
+NUMERICALS_INSTANTIATE_SPARSE_MATRIX(long double)
+#undef NUMERICALS_INSTANTIATE_SPARSE_MATRIX
+
+}
@@ -0,0 +1,49 @@
+#include "allocation_counter.h"
+#include <cstdlib>
+#include <algorithm>
+#include <new>
+
+namespace {
+
+thread_local size_t allocations = 0;
+
+void* allocate(const size_t size, const size_t alignment = alignof(std::max_align_t))
+{
+    allocations++;
+    void* p = nullptr;
+    if(posix_memalign(&p, std::max(alignment, sizeof(void*)), size ? size : 1) != 0) [[unlikely]]
+        throw std::bad_alloc();
+    return p;
+}
+
+void* try_allocate(const size_t size, const size_t alignment = alignof(std::max_align_t)) noexcept
+{
+    try { return allocate(size, alignment); }
+    catch(const std::bad_alloc&) { return nullptr; }
+}
+
+}
+
+size_t global_allocation_count() { return allocations; }
+
+void* operator new(const size_t size) { return allocate(size); }
+void* operator new[](const size_t size) { return allocate(size); }
+void* operator new(const size_t size, const std::align_val_t alignment) { return allocate(size, size_t(alignment)); }
+void* operator new[](const size_t size, const std::align_val_t alignment) { return allocate(size, size_t(alignment)); }
+void* operator new(const size_t size, const std::nothrow_t&) noexcept { return try_allocate(size); }
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept { return try_allocate(size); }
+void* operator new(const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept { return try_allocate(size, size_t(alignment)); }
+void* operator new[](const size_t size, const std::align_val_t alignment, const std::nothrow_t&) noexcept { return try_allocate(size, size_t(alignment)); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+
+// Calls of the global operator new (every overload, aligned ones included) made by the calling
+// thread since it started. The test binary replaces operator new and delete to keep it, so
+// compared around a call it catches any heap allocation: aligned_allocator, std containers,
+// threads alike.
+size_t global_allocation_count();
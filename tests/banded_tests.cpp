@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "BandedSolver.h"
+#include "MatrixSolver.h"
+#include "test_matrices.h"
+#include <utility>
+
+using namespace numericals;
+
+namespace {
+
+// diagonally dominant unless weak, with distinct entries on every diagonal
+band_matrix<double> make_band(const size_t size, const size_t lower, const size_t upper, const bool weak = false)
+{
+    band_matrix<double> a(size, lower, upper);
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = a.GetFirstColumn(y); x < a.GetLastColumn(y); x++)
+            a.GetElement(x, y) = x == y ? (weak ? 0.1 : double(lower + upper) + 2.0) : double(int((x * 5 + y * 3) % 7) - 3) / 3.0;
+    return a;
+}
+
+}
+
+TEST(Banded, StorageAndProduct)
+{
+    const band_matrix<double> a = make_band(7, 2, 1);
+    EXPECT_EQ(a.GetStorageSize(), 7u * 4u);
+    const matrix<double> dense = a.ToDense();
+    EXPECT_EQ(dense.GetElement(3, 0), 0.0);
+    EXPECT_EQ(dense.GetElement(0, 3), 0.0);
+    EXPECT_EQ(a.GetElement(6, 0), 0.0);
+
+    const band_matrix<double> back(dense.View(), 2, 1);
+    const vector<double> x = expected_solution(7);
+    const vector<double> banded = back * x;
+    const vector<double> full = dense * x;
+    for(size_t i = 0; i < 7; i++)
+        EXPECT_DOUBLE_EQ(banded[i], full[i]);
+}
+
+TEST(Banded, PentadiagonalLU)
+{
+    for(const band_pivoting pivoting : {band_pivoting::none, band_pivoting::partial})
+    {
+        const band_matrix<double> a = make_band(200, 2, 2);
+        const vector<double> expected = expected_solution(200);
+        const vector<double> x = solve_banded_matrix_eq(a, a * expected, pivoting);
+        for(size_t i = 0; i < x.GetSize(); i++)
+            EXPECT_NEAR(x[i], expected[i], 1e-10);
+    }
+}
+
+TEST(Banded, PivotingAndReuse)
+{
+    // a small diagonal needs row exchanges, which widen U to lower + upper super-diagonals
+    const band_matrix<double> a = make_band(50, 3, 1, true);
+    const BandedLUFactorization<double> lu(a);
+    EXPECT_EQ(lu.GetFactors().GetUpperBandwidth(), 4u);
+    size_t exchanges = 0;
+    for(size_t k = 0; k < lu.GetSwaps().size(); k++)
+        exchanges += lu.GetSwaps()[k] != k;
+    EXPECT_GT(exchanges, 0u);
+
+    matrix<double> expected{3, 50};
+    for(size_t y = 0; y < 50; y++)
+        for(size_t c = 0; c < 3; c++)
+            expected.GetElement(c, y) = double(int((y + 4 * c) % 9) - 4);
+    matrix<double> b{3, 50};
+    for(size_t c = 0; c < 3; c++)
+        multiply(a, std::as_const(expected).Column(c), b.Column(c));
+
+    const matrix<double> x = lu.Solve(b);
+    for(size_t y = 0; y < 50; y++)
+        for(size_t c = 0; c < 3; c++)
+            EXPECT_NEAR(x.GetElement(c, y), expected.GetElement(c, y), 1e-9);
+
+    band_matrix<double> singular(4, 1, 1);
+    EXPECT_THROW(BandedLUFactorization<double>{singular}, std::runtime_error);
+}
+
+TEST(Banded, MatchesTridiagonalSolver)
+{
+    vector<double> a1{1.0, 6.0, 2.0};
+    vector<double> a2{1.0, 4.0, 6.0, 2.0};
+    vector<double> a3{2.0, 4.0, 8.0};
+    const vector<double> b{14.0, 0.0, 14.0, 14.0};
+
+    band_matrix<double> a(4, 1, 1);
+    for(size_t i = 0; i < 4; i++)
+    {
+        a.GetElement(i, i) = a2[i];
+        if(i > 0) a.GetElement(i - 1, i) = a1[i - 1];
+        if(i + 1 < 4) a.GetElement(i + 1, i) = a3[i];
+    }
+    const vector<double> tridiagonal = solve_tridiagonal_matrix_eq<double>({a1, a2, a3}, b);
+    const vector<double> banded = solve_banded_matrix_eq(a, b, band_pivoting::none);
+    for(size_t i = 0; i < 4; i++)
+        EXPECT_NEAR(banded[i], tridiagonal[i], 1e-12);
+}
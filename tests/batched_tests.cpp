@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "BatchedSolver.h"
+#include "MatrixSolver.h"
+
+using namespace numericals;
+
+namespace {
+
+// symmetric positive definite for every system, with a zero leading element in every third one
+matrix<double> system_matrix(const size_t size, const size_t system)
+{
+    matrix<double> a{size, size};
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x < size; x++)
+            a.GetElement(x, y) = x == y ? double(size + system % 5) : 1.0 / double(1 + x + y + system % 3);
+    if(system % 3 == 0)
+        a.GetElement(0, 0) = 0.0;
+    return a;
+}
+
+vector<double> system_rhs(const size_t size, const size_t system)
+{
+    vector<double> b(size);
+    for(size_t i = 0; i < size; i++)
+        b[i] = double((i + system) % 7) - 3.0;
+    return b;
+}
+
+}
+
+TEST(Batched, GaussMatchesPerSystemSolve)
+{
+    const size_t size = 6, count = 37;
+    batched_matrix<double> a(size, count);
+    batched_vector<double> b(size, count);
+    for(size_t s = 0; s < count; s++)
+    {
+        a.Set(s, system_matrix(size, s).View());
+        b.Set(s, system_rhs(size, s).View());
+    }
+    EXPECT_EQ(a.Get(4).GetElement(2, 3), system_matrix(size, 4).GetElement(2, 3));
+
+    EXPECT_TRUE(solve_matrix_eq_gauss_batched(a, b, 2).Succeeded());
+    for(size_t s = 0; s < count; s++)
+    {
+        vector<double> expected = solve_matrix_eq_gauss(system_matrix(size, s), system_rhs(size, s), PartialPivotingStragegy<double>());
+        for(size_t i = 0; i < size; i++)
+            EXPECT_NEAR(b.GetElement(s, i), expected[i], 1e-12);
+    }
+}
+
+TEST(Batched, FactorOnceSolveLUAndLLT)
+{
+    const size_t size = 5, count = 20;
+    batched_matrix<double> lu(size, count);
+    batched_matrix<double> llt(size, count);
+    batched_vector<double> b1(size, count);
+    batched_vector<double> b2(size, count);
+    for(size_t s = 0; s < count; s++)
+    {
+        matrix<double> a = system_matrix(size, s);
+        a.GetElement(0, 0) = double(size);
+        lu.Set(s, a.View());
+        llt.Set(s, a.View());
+        b1.Set(s, system_rhs(size, s).View());
+        b2.Set(s, system_rhs(size, s).View());
+    }
+
+    EXPECT_TRUE(lu_decomposition_batched(lu).Succeeded());
+    EXPECT_TRUE(llt_decomposition_batched(llt).Succeeded());
+    solve_matrix_eq_with_lu_batched(lu, b1);
+    solve_matrix_eq_with_llt_batched(llt, b2);
+
+    for(size_t s = 0; s < count; s++)
+    {
+        matrix<double> a = system_matrix(size, s);
+        a.GetElement(0, 0) = double(size);
+        const vector<double> residual1 = a * b1.Get(s);
+        const vector<double> residual2 = a * b2.Get(s);
+        const vector<double> rhs = system_rhs(size, s);
+        for(size_t i = 0; i < size; i++)
+        {
+            EXPECT_NEAR(residual1[i], rhs[i], 1e-12);
+            EXPECT_NEAR(residual2[i], rhs[i], 1e-12);
+        }
+        EXPECT_NEAR(llt.GetElement(s, 0, 0), std::sqrt(double(size)), 1e-12);
+    }
+}
+
+TEST(Batched, FlagsFailedSystems)
+{
+    const size_t size = 4, count = 37;
+    batched_matrix<double> gauss(size, count), lu(size, count), llt(size, count);
+    batched_vector<double> b(size, count);
+    for(size_t s = 0; s < count; s++)
+    {
+        matrix<double> a = system_matrix(size, s);
+        // a repeated row in system 5, and in system 31 a leading minor that is not positive
+        if(s == 5) a.Row(2) = a.Row(1);
+        if(s == 31) a.GetElement(1, 1) = 0.0;
+        gauss.Set(s, a.View());
+        lu.Set(s, a.View());
+        llt.Set(s, a.View());
+        b.Set(s, system_rhs(size, s).View());
+    }
+
+    const batch_status solved = solve_matrix_eq_gauss_batched(gauss, b);
+    const batch_status factored = lu_decomposition_batched(lu);
+    const batch_status cholesky = llt_decomposition_batched(llt);
+    ASSERT_EQ(solved.failed.size(), count);
+    EXPECT_EQ(solved.GetFailedCount(), 1u);
+    EXPECT_TRUE(solved.failed[5]);
+    // every third system has a zero leading element, which only the Gauss pivoting gets past
+    for(size_t s = 0; s < count; s++)
+    {
+        EXPECT_EQ(bool(factored.failed[s]), s % 3 == 0 || s == 5) << s;
+        EXPECT_EQ(bool(cholesky.failed[s]), s % 3 == 0 || s == 5 || s == 31) << s;
+    }
+    EXPECT_FALSE(cholesky.Succeeded());
+}
+
+TEST(Batched, TridiagonalMatchesPerSystemSolve)
+{
+    const size_t size = 40, count = 21;
+    batched_vector<double> lower(size - 1, count), diagonal(size, count), upper(size - 1, count), b(size, count);
+    for(size_t s = 0; s < count; s++)
+        for(size_t i = 0; i < size; i++)
+        {
+            diagonal.GetElement(s, i) = 3.0 + double((i + s) % 4);
+            b.GetElement(s, i) = double((i * 3 + s) % 7) - 3.0;
+            if(i + 1 < size)
+            {
+                lower.GetElement(s, i) = -1.0 + double(s % 3) * 0.25;
+                upper.GetElement(s, i) = 1.0 - double(i % 5) * 0.3;
+            }
+        }
+    std::vector<std::array<vector<double>, 3>> systems;
+    std::vector<vector<double>> rhs;
+    for(size_t s = 0; s < count; s++)
+    {
+        systems.push_back({lower.Get(s), diagonal.Get(s), upper.Get(s)});
+        rhs.push_back(b.Get(s));
+    }
+
+    solve_tridiagonal_matrix_eq_batched(lower, diagonal, upper, b, 2);
+    for(size_t s = 0; s < count; s++)
+    {
+        const vector<double> expected = solve_tridiagonal_matrix_eq(systems[s], rhs[s]);
+        for(size_t i = 0; i < size; i++)
+            EXPECT_NEAR(b.GetElement(s, i), expected[i], 1e-12);
+    }
+}
@@ -0,0 +1,85 @@
+#include "matrix.h"
+#include "vector.h"
+#include <gtest/gtest.h>
+#include <utility>
+
+TEST(Expressions, TransposedProducts)
+{
+    matrix<double> a{2, 3, {1.0, 2.0,
+                            3.0, 4.0,
+                            5.0, 6.0}};
+    vector<double> b{1.0, 0.0, 2.0};
+
+    matrix<double> gram = transpose(a) * a;
+    ASSERT_EQ(gram.GetSizeX(), 2);
+    ASSERT_EQ(gram.GetSizeY(), 2);
+    EXPECT_EQ(gram.GetElement(0, 0), 35.0);
+    EXPECT_EQ(gram.GetElement(1, 0), 44.0);
+    EXPECT_EQ(gram.GetElement(0, 1), 44.0);
+    EXPECT_EQ(gram.GetElement(1, 1), 56.0);
+
+    vector<double> rhs = transpose(a) * b;
+    ASSERT_EQ(rhs.GetSize(), 2);
+    EXPECT_EQ(rhs[0], 11.0);
+    EXPECT_EQ(rhs[1], 14.0);
+
+    vector<double> scaled = transpose(a) * (2.0 * b);
+    EXPECT_EQ(scaled[0], 22.0);
+    EXPECT_EQ(scaled[1], 28.0);
+}
+
+TEST(Expressions, TransposedProductOfOverlappingViews)
+{
+    // both operands start at the same element with swapped strides, but are not x^T x
+    matrix<double> x{3, 5};
+    for(size_t y = 0; y < 5; y++)
+        for(size_t c = 0; c < 3; c++)
+            x.GetElement(c, y) = double(c + 3 * y);
+
+    for(const auto& [left, right] : {std::pair<size_t, size_t>{2, 3}, {3, 2}})
+    {
+        matrix<double> product = transpose(as_expression(x.Block(0, 0, left, 5))) * x.Block(0, 0, right, 5);
+        ASSERT_EQ(product.GetSizeX(), right);
+        ASSERT_EQ(product.GetSizeY(), left);
+        for(size_t y = 0; y < left; y++)
+            for(size_t c = 0; c < right; c++)
+            {
+                double expected = 0.0;
+                for(size_t i = 0; i < 5; i++)
+                    expected += x.GetElement(y, i) * x.GetElement(c, i);
+                EXPECT_EQ(product.GetElement(c, y), expected);
+            }
+    }
+}
+
+TEST(Expressions, FusedElementwiseChain)
+{
+    matrix<double> a{2, 2, {1.0, 2.0,
+                            3.0, 4.0}};
+    matrix<double> b{2, 2, {1.0, 1.0,
+                            1.0, 1.0}};
+
+    matrix<double> c = 2.0 * a - transpose(a) + b / 2.0;
+    EXPECT_EQ(c.GetElement(0, 0), 1.5);
+    EXPECT_EQ(c.GetElement(1, 0), 1.5);
+    EXPECT_EQ(c.GetElement(0, 1), 4.5);
+    EXPECT_EQ(c.GetElement(1, 1), 4.5);
+
+    // a product nested in an element-wise expression is evaluated once
+    matrix<double> d = transpose(a) * b + b;
+    EXPECT_EQ(d.GetElement(0, 0), 5.0);
+    EXPECT_EQ(d.GetElement(1, 1), 7.0);
+}
+
+TEST(Expressions, AliasedAssignment)
+{
+    matrix<double> a{2, 2, {1.0, 2.0,
+                            3.0, 4.0}};
+    a = transpose(a);
+    EXPECT_EQ(a.GetElement(1, 0), 3.0);
+    EXPECT_EQ(a.GetElement(0, 1), 2.0);
+
+    vector<double> v{1.0, 2.0};
+    v = v + v;
+    EXPECT_EQ(v[1], 4.0);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "Factorization.h"
+#include "MatrixSolver.h"
+#include "test_matrices.h"
+
+using namespace numericals;
+
+namespace {
+
+void expect_solves(const Factorization<double>& factorization, const matrix<double>& a)
+{
+    const size_t n = a.GetSizeX();
+    const vector<double> expected = expected_solution(n);
+    vector<double> b = a * expected;
+
+    vector<double> x = factorization.Solve(b);
+    for(size_t i = 0; i < n; i++)
+        EXPECT_NEAR(x[i], expected[i], 1e-9);
+
+    factorization.SolveInPlace(b);
+    for(size_t i = 0; i < n; i++)
+        EXPECT_NEAR(b[i], expected[i], 1e-9);
+
+    matrix<double> expectedX{3, n};
+    for(size_t y = 0; y < n; y++)
+        for(size_t x = 0; x < 3; x++)
+            expectedX.GetElement(x, y) = double((x + 1) * (y % 5)) - 2.0;
+    matrix<double> X = factorization.Solve(matrix<double>(a * expectedX));
+    for(size_t y = 0; y < n; y++)
+        for(size_t x = 0; x < 3; x++)
+            EXPECT_NEAR(X.GetElement(x, y), expectedX.GetElement(x, y), 1e-9);
+}
+
+}
+
+TEST(Factorization, LU)
+{
+    const matrix<double> a = dense_test_matrix(90, 90, 0.5);
+    LUFactorization<double> lu(a);
+    expect_solves(lu, a);
+
+    // a zero column past the first block leaves no pivot
+    matrix<double> singular = a;
+    for(size_t y = 0; y < 90; y++)
+        singular.GetElement(70, y) = 0.0;
+    EXPECT_THROW(LUFactorization<double>{singular}, std::runtime_error);
+}
+
+TEST(Factorization, LDLT)
+{
+    matrix<double> a{3, 3, {  1.0, 0.0, 3.0,
+                              0.0, 6.0, 6.0,
+                              3.0, 6.0, 5.0 }};
+    LDLTFactorization<double> ldlt(a);
+    expect_solves(ldlt, a);
+
+    // symmetric and nonsingular, but with no LDL^T factorization
+    EXPECT_THROW(LDLTFactorization<double>(matrix<double>{2, 2, {0.0, 1.0, 1.0, 0.0}}), std::runtime_error);
+    EXPECT_EQ(LDLTFactorization<double>(matrix<double>{0, 0}).GetSizeX(), 0u);
+}
+
+TEST(Factorization, LLT)
+{
+    const matrix<double> a = spd_test_matrix(40);
+    LLTFactorization<double> llt(a);
+    expect_solves(llt, a);
+}
+
+TEST(Factorization, QR)
+{
+    const matrix<double> a = dense_test_matrix(60, 60, 0.5);
+    QRFactorization<double> qr(a);
+    expect_solves(qr, a);
+}
+
+TEST(Factorization, QRLeastSquares)
+{
+    matrix<double> a{2, 4, {1.0, 0.0,
+                            1.0, 1.0,
+                            1.0, 2.0,
+                            1.0, 3.0}};
+    vector<double> b{1.0, 3.0, 2.0, 5.0};
+
+    vector<double> x = QRFactorization<double>(a).Solve(b);
+    ASSERT_EQ(x.GetSize(), 2);
+    EXPECT_NEAR(x[0], 1.1, 1e-12);
+    EXPECT_NEAR(x[1], 1.1, 1e-12);
+
+    EXPECT_THROW(QRFactorization<double>(transpose(a)), std::runtime_error);
+}
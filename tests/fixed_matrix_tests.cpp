@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "MatrixSolver.h"
+#include "MatrixDecomposer.h"
+#include "fixed_matrix.h"
+
+using namespace numericals;
+
+template <typename T, size_t N>
+void expect_fixed_vector_equals(const fixed_vector<T, N>& v1, const fixed_vector<T, N>& v2)
+{
+    for(size_t i = 0; i < N; i++)
+        EXPECT_NEAR(v1[i], v2[i], 10e-5);
+}
+
+TEST(FixedMatrix, Products)
+{
+    constexpr fixed_matrix<int, 2, 3> a{1, 2, 3,
+                                        4, 5, 6};
+    constexpr fixed_matrix<int, 3, 2> b{1, 0,
+                                        0, 1,
+                                        1, 1};
+    constexpr fixed_matrix<int, 2, 2> product = a * b;
+    static_assert(product == fixed_matrix<int, 2, 2>{4, 5, 10, 11});
+    static_assert(a * fixed_vector<int, 3>{1, 1, 1} == fixed_vector<int, 2>{6, 15});
+    static_assert(sizeof(fixed_matrix<float, 4, 4>) == 16 * sizeof(float));
+}
+
+TEST(FixedMatrix, LU_Decomposition)
+{
+    constexpr fixed_matrix<real, 3, 3> lu = lu_decomposition(fixed_matrix<real, 3, 3>{1.0, 2.0, 3.0,
+                                                                                    4.0, 5.0, 6.0,
+                                                                                    7.0, 8.0, 9.0});
+    static_assert(lu == fixed_matrix<real, 3, 3>{1.0, 2.0, 3.0,
+                                                 4.0, -3.0, -6.0,
+                                                 7.0, 2.0, 0.0});
+}
+
+TEST(FixedMatrix, SolveLU_Matrix)
+{
+    fixed_matrix<real, 3, 3> A{1.0, 0.0, 3.0,
+                               0.0, 6.0, 6.0,
+                               3.0, 6.0, 5.0};
+    fixed_vector<real, 3> b{1.0, 0.0, 13.0};
+    expect_fixed_vector_equals(solve_matrix_eq_with_lu_decomposition(A, b), {4.0, 1.0, -1.0});
+}
+
+TEST(FixedMatrix, LU_DecompositionWithPivoting)
+{
+    constexpr auto pivoted = lu_decomposition_with_pivoting(fixed_matrix<double, 3, 3>{1.0, 2.0, 3.0,
+                                                                                        4.0, 5.0, 6.0,
+                                                                                        7.0, 8.0, 10.0});
+    static_assert(pivoted.second == std::array<size_t, 3>{2, 0, 1});
+    const fixed_matrix<double, 3, 3> expected{7.0, 8.0, 10.0,
+                                              1.0 / 7.0, 6.0 / 7.0, 11.0 / 7.0,
+                                              4.0 / 7.0, 0.5, -0.5};
+    for(size_t y = 0; y < 3; y++)
+        for(size_t x = 0; x < 3; x++)
+            EXPECT_NEAR(pivoted.first.GetElement(x, y), expected.GetElement(x, y), 1e-12);
+
+    const fixed_matrix<double, 3, 3> singular{1.0, 2.0, 3.0,
+                                              2.0, 4.0, 6.0,
+                                              0.0, 0.0, 0.0};
+    EXPECT_THROW(lu_decomposition_with_pivoting(singular), std::runtime_error);
+}
+
+TEST(FixedMatrix, SolveLU_ZeroLeadingPivot)
+{
+    // a quarter turn has no usable leading pivot without row exchanges
+    const fixed_matrix<double, 2, 2> rotation{0.0, -1.0,
+                                              1.0, 0.0};
+    const fixed_vector<double, 2> b{1.0, 2.0};
+    expect_fixed_vector_equals(solve_matrix_eq_with_lu_decomposition(rotation, b), {2.0, -1.0});
+    EXPECT_THROW(lu_decomposition(rotation), std::runtime_error);
+}
+
+TEST(FixedMatrix, SolveLLT_Matrix)
+{
+    fixed_matrix<double, 3, 3> A{4.0, 12.0, -16.0,
+                                 12.0, 37.0, -43.0,
+                                 -16.0, -43.0, 98.0};
+    const auto llt = llt_decomposition(A);
+    EXPECT_NEAR(llt.GetElement(0, 2), -8.0, 10e-9);
+    EXPECT_NEAR(llt.GetElement(2, 1), 5.0, 10e-9);
+    EXPECT_NEAR(llt.GetElement(2, 2), 3.0, 10e-9);
+
+    fixed_vector<double, 3> b{72.0, 0.0, 288.0};
+    expect_fixed_vector_equals(solve_matrix_eq_with_llt_decomposition(A, b), {4162.0, -1136.0, 184.0});
+}
+
+TEST(FixedMatrix, LLT_NotPositiveDefinite)
+{
+    fixed_matrix<double, 3, 3> A{4.0, 2.0, 0.0,
+                                 2.0, 1.0, 3.0,
+                                 0.0, 3.0, 5.0};
+    try
+    {
+        llt_decomposition(A);
+        FAIL() << "non positive definite matrix was factored";
+    }
+    catch(const not_positive_definite& e)
+    {
+        EXPECT_EQ(e.GetPivot(), 1u);
+    }
+}
+
+TEST(FixedMatrix, MatchesDynamicSolver)
+{
+    fixed_matrix<double, 4, 4> fixedA;
+    matrix<double> A{4, 4};
+    for(size_t y = 0; y < 4; y++)
+        for(size_t x = 0; x < 4; x++)
+            A.GetElement(x, y) = fixedA.GetElement(x, y) = x == y ? 10.0 : double(x + 2 * y) / 7.0;
+    fixed_vector<double, 4> fixedB{1.0, -2.0, 3.0, 0.5};
+    vector<double> b{1.0, -2.0, 3.0, 0.5};
+
+    const auto fixedX = solve_matrix_eq_with_lu_decomposition(fixedA, fixedB);
+    const auto x = solve_matrix_eq_with_lu_decomposition(A, b);
+    for(size_t i = 0; i < 4; i++)
+        EXPECT_NEAR(fixedX[i], x[i], 10e-12);
+
+    const auto residual = fixedA * fixedX;
+    expect_fixed_vector_equals(residual, fixedB);
+}
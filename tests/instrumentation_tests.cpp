@@ -0,0 +1,114 @@
+#include "MatrixDecomposer.h"
+#include "MatrixSolver.h"
+#include "instrumentation.h"
+#include <cstdio>
+#include <gtest/gtest.h>
+
+using namespace numericals;
+
+namespace {
+
+// first of the recorded calls of function, nullptr if there is none
+const call_statistics* find_call(const char* function)
+{
+    for(const auto& call : instrumentation_sink::ThreadLocal().GetCalls())
+        if(std::string_view(call.function) == function)
+            return &call;
+    return nullptr;
+}
+
+}
+
+#ifdef NUMERICALS_INSTRUMENTATION
+
+TEST(Instrumentation, RecordsPivotingOfGauss)
+{
+    auto& sink = instrumentation_sink::ThreadLocal();
+    sink.Clear();
+    matrix<double> a{2, 2, {1.0, 2.0,
+                            3.0, 4.0}};
+    const vector<double> x = solve_matrix_eq_gauss(a, vector<double>{5.0, 11.0}, PartialPivotingPolicy());
+    EXPECT_NEAR(x[0], 1.0, 1e-12);
+    EXPECT_NEAR(x[1], 2.0, 1e-12);
+
+    const call_statistics* outer = find_call("solve_matrix_eq_gauss");
+    const call_statistics* inner = find_call("solve_matrix_eq_gauss_in_place");
+    ASSERT_NE(outer, nullptr);
+    ASSERT_NE(inner, nullptr);
+    EXPECT_EQ(outer->depth, 0);
+    EXPECT_EQ(inner->depth, 1);
+    EXPECT_EQ(inner->size, 2);
+
+    // 3 is taken as the first pivot, which leaves 2 - 4 / 3 for the second
+    EXPECT_EQ(inner->pivot_swaps, 1);
+    EXPECT_NEAR(inner->min_pivot, 2.0 / 3.0, 1e-12);
+    EXPECT_GT(inner->flops, 0.0);
+    EXPECT_GT(inner->bytes, 0.0);
+
+    // the nested call is added into the outer one, and its phases are part of its time
+    EXPECT_EQ(outer->pivot_swaps, inner->pivot_swaps);
+    EXPECT_EQ(outer->flops, inner->flops);
+    EXPECT_EQ(outer->min_pivot, inner->min_pivot);
+    std::chrono::nanoseconds phases{0};
+    for(const auto time : inner->phase_time)
+        phases += time;
+    EXPECT_LE(phases, inner->time);
+    EXPECT_LE(inner->time, outer->time);
+}
+
+TEST(Instrumentation, CountsAllocationsAndNestedCalls)
+{
+    auto& sink = instrumentation_sink::ThreadLocal();
+    sink.Clear();
+    const size_t n = 48;
+    matrix<double> a{n, n};
+    vector<double> b(n);
+    for(size_t y = 0; y < n; y++)
+    {
+        for(size_t x = 0; x < n; x++)
+            a.GetElement(x, y) = 1.0 / double(x + y + 1) + (x == y ? double(n) : 0.0);
+        b[y] = double(y);
+    }
+    solve_matrix_eq_with_lu_decomposition(a, b);
+
+    const call_statistics* solve = find_call("solve_matrix_eq_with_lu_decomposition");
+    const call_statistics* lu = find_call("lu_decomposition");
+    ASSERT_NE(solve, nullptr);
+    ASSERT_NE(lu, nullptr);
+    const call_statistics low = sink.Summarize("solve_low_trian_matrix_eq");
+    const call_statistics high = sink.Summarize("solve_high_trian_matrix_eq");
+    EXPECT_EQ(std::string_view(low.function), "solve_low_trian_matrix_eq");
+    EXPECT_DOUBLE_EQ(solve->flops, lu->flops + low.flops + high.flops);
+    EXPECT_GT(lu->GetPhaseTime(solver_phase::factorization).count(), 0);
+    EXPECT_GT(low.GetPhaseTime(solver_phase::substitution).count(), 0);
+    EXPECT_EQ(lu->pivot_swaps, 0);
+    EXPECT_GT(lu->min_pivot, 0.0);
+
+    // the copy of a and both solutions at least, nested allocations included
+    EXPECT_GE(solve->allocations, 3);
+    EXPECT_LE(lu->allocations, solve->allocations);
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    sink.Dump(file);
+    EXPECT_GT(std::ftell(file), 0);
+    std::fclose(file);
+
+    sink.Clear();
+    EXPECT_TRUE(sink.GetCalls().empty());
+}
+
+#else
+
+TEST(Instrumentation, DisabledRecordsNothing)
+{
+    instrumentation_sink::ThreadLocal().Clear();
+    matrix<double> a{2, 2, {1.0, 2.0,
+                            3.0, 4.0}};
+    solve_matrix_eq_gauss(a, vector<double>{5.0, 11.0}, PartialPivotingPolicy());
+    lu_decomposition_with_pivoting(a);
+    EXPECT_EQ(find_call("solve_matrix_eq_gauss"), nullptr);
+    EXPECT_TRUE(instrumentation_sink::ThreadLocal().GetCalls().empty());
+}
+
+#endif
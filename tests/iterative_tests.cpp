@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include "IterativeSolver.h"
+#include "MatrixDecomposer.h"
+#include "sparse_matrix.h"
+#include "test_matrices.h"
+#include <cmath>
+
+using namespace numericals;
+
+namespace {
+
+void expect_solution(const vector<double>& x, const vector<double>& expected, const double tolerance)
+{
+    for(size_t i = 0; i < x.GetSize(); i++)
+        EXPECT_NEAR(x[i], expected[i], tolerance);
+}
+
+}
+
+TEST(Iterative, ConjugateGradients)
+{
+    const csr_matrix<double> a = grid_matrix(30, 0.0);
+    const vector<double> expected = expected_solution(a.GetSizeX());
+    const vector<double> b = a * expected;
+    iterative_controls<double> controls;
+    controls.tolerance = 1e-10;
+
+    vector<double> plain(b.GetSize());
+    const auto plainReport = solve_matrix_eq_cg(as_operator(a), b, plain, IdentityPreconditioner<double>(), controls);
+    EXPECT_TRUE(plainReport.converged);
+    expect_solution(plain, expected, 1e-7);
+
+    vector<double> jacobi(b.GetSize());
+    EXPECT_TRUE(solve_matrix_eq_cg(as_operator(a), b, jacobi, JacobiPreconditioner<double>(a), controls).converged);
+    expect_solution(jacobi, expected, 1e-7);
+
+    vector<double> ic(b.GetSize());
+    const auto icReport = solve_matrix_eq_cg(as_operator(a), b, ic, IncompleteCholeskyPreconditioner<double>(a), controls);
+    EXPECT_TRUE(icReport.converged);
+    EXPECT_LT(icReport.iterations, plainReport.iterations);
+    expect_solution(ic, expected, 1e-7);
+}
+
+TEST(Iterative, UnsymmetricSolvers)
+{
+    const csr_matrix<double> a = grid_matrix(30, 0.4);
+    const vector<double> expected = expected_solution(a.GetSizeX());
+    const vector<double> b = a * expected;
+    const ILU0Preconditioner<double> ilu(a);
+    iterative_controls<double> controls;
+    controls.tolerance = 1e-10;
+    controls.restart = 20;
+
+    vector<double> bicgstab(b.GetSize());
+    EXPECT_TRUE(solve_matrix_eq_bicgstab(as_operator(a), b, bicgstab, ilu, controls).converged);
+    expect_solution(bicgstab, expected, 1e-7);
+
+    vector<double> gmres(b.GetSize());
+    const auto plainReport = solve_matrix_eq_gmres(as_operator(a), b, gmres, IdentityPreconditioner<double>(), controls);
+    EXPECT_TRUE(plainReport.converged);
+    expect_solution(gmres, expected, 1e-7);
+
+    gmres.View() = 0.0;
+    const auto iluReport = solve_matrix_eq_gmres(as_operator(a), b, gmres, ilu, controls);
+    EXPECT_TRUE(iluReport.converged);
+    EXPECT_LT(iluReport.iterations, plainReport.iterations);
+    EXPECT_LE(iluReport.residual, 1e-10);
+    expect_solution(gmres, expected, 1e-7);
+}
+
+TEST(Iterative, DenseOperatorAndMonitor)
+{
+    const matrix<double> a = grid_matrix(6, 0.2).ToDense();
+    const vector<double> expected = expected_solution(a.GetSizeX());
+    const vector<double> b = a * expected;
+
+    std::vector<double> residuals;
+    iterative_controls<double> controls;
+    controls.tolerance = 1e-12;
+    controls.monitor = [&](const size_t iteration, const double residual)
+    {
+        EXPECT_EQ(iteration, residuals.size() + 1);
+        residuals.push_back(residual);
+    };
+    vector<double> x(b.GetSize());
+    const auto report = solve_matrix_eq_gmres(as_operator(a), b, x, JacobiPreconditioner<double>(a), controls);
+    EXPECT_TRUE(report.converged);
+    EXPECT_EQ(residuals.size(), report.iterations);
+    EXPECT_LE(residuals.back(), 1e-12);
+    expect_solution(x, expected, 1e-9);
+
+    // a converged initial guess takes no iterations, a capped run reports failure
+    EXPECT_EQ(solve_matrix_eq_bicgstab(as_operator(a), b, x, IdentityPreconditioner<double>(), controls).iterations, 0u);
+    x.View() = 0.0;
+    iterative_controls<double> capped;
+    capped.tolerance = 1e-12;
+    capped.max_iterations = 2;
+    const auto cappedReport = solve_matrix_eq_cg(as_operator(a), b, x, IdentityPreconditioner<double>(), capped);
+    EXPECT_FALSE(cappedReport.converged);
+    EXPECT_EQ(cappedReport.iterations, 2u);
+    // iterations, not products with A, are capped
+    x.View() = 0.0;
+    const auto cappedBicgstab = solve_matrix_eq_bicgstab(as_operator(a), b, x, IdentityPreconditioner<double>(), capped);
+    EXPECT_FALSE(cappedBicgstab.converged);
+    EXPECT_EQ(cappedBicgstab.iterations, 2u);
+}
+
+TEST(Iterative, ConjugateGradientsBreakdown)
+{
+    // p^T A p is zero for the first direction of the indefinite diag(1, -1) and negative for diag(1, -3)
+    for(const double second : {-1.0, -3.0})
+    {
+        const matrix<double> a{2, 2, {1.0, 0.0,
+                                      0.0, second}};
+        const vector<double> b{1.0, 1.0};
+        vector<double> x(2);
+        const auto report = solve_matrix_eq_cg(as_operator(a), b, x);
+        EXPECT_FALSE(report.converged);
+        EXPECT_EQ(report.iterations, 0u);
+        EXPECT_TRUE(std::isfinite(report.residual));
+        EXPECT_EQ(x[0], 0.0);
+        EXPECT_EQ(x[1], 0.0);
+    }
+}
+
+TEST(Iterative, GmresBreakdown)
+{
+    // A b is zero for the nilpotent matrix; diag(1, 0) runs out of directions on the second one
+    const matrix<double> nilpotent{2, 2, {0.0, 1.0,
+                                          0.0, 0.0}};
+    const matrix<double> singular{2, 2, {1.0, 0.0,
+                                         0.0, 0.0}};
+    for(const auto& [a, b] : {std::pair{nilpotent, vector<double>{1.0, 0.0}},
+                              std::pair{singular, vector<double>{1.0, 1.0}}})
+    {
+        vector<double> x(2);
+        const auto report = solve_matrix_eq_gmres(as_operator(a), b, x);
+        EXPECT_FALSE(report.converged);
+        EXPECT_LT(report.iterations, 2u);
+        EXPECT_TRUE(std::isfinite(report.residual));
+        EXPECT_TRUE(std::isfinite(x[0]));
+        EXPECT_TRUE(std::isfinite(x[1]));
+    }
+}
+
+TEST(Iterative, IncompleteCholeskyBreakdown)
+{
+    const std::vector<triplet<double>> entries{{0, 0, 1.0}, {1, 0, 2.0}, {0, 1, 2.0}, {1, 1, 1.0}};
+    const csr_matrix<double> a(2, 2, std::span<const triplet<double>>(entries));
+    EXPECT_THROW(IncompleteCholeskyPreconditioner<double>{a}, not_positive_definite);
+}
@@ -19,3 +19,134 @@ TEST(Matrices, create)
     EXPECT_EQ(mat.GetColumn(1)[0], col2[0]);
     EXPECT_EQ(mat.GetColumn(1)[1], col2[1]);
 }
+
+template <typename T>
+void expect_product_matches_reference(const size_t m, const size_t n, const size_t k)
+{
+    matrix<T> a{k, m};
+    matrix<T> b{n, k};
+    for(size_t i = 0; i < m * k; i++) a.GetElement(i) = T(int(i * 7 % 13) - 6) / 4;
+    for(size_t i = 0; i < k * n; i++) b.GetElement(i) = T(int(i * 5 % 11) - 5) / 2;
+
+    auto c = a * b;
+    ASSERT_EQ(c.GetSizeX(), n);
+    ASSERT_EQ(c.GetSizeY(), m);
+    for(size_t y = 0; y < m; y++)
+        for(size_t x = 0; x < n; x++)
+        {
+            double expected = 0.0;
+            for(size_t i = 0; i < k; i++)
+                expected += double(a.GetElement(i, y)) * double(b.GetElement(x, i));
+            EXPECT_NEAR(c.GetElement(x, y), expected, 1e-3);
+        }
+}
+
+TEST(Matrices, Multiply)
+{
+    matrix<double> a{3, 2, {1.0, 2.0, 3.0,
+                            4.0, 5.0, 6.0}};
+    matrix<double> b{2, 3, {7.0, 8.0,
+                            9.0, 10.0,
+                            11.0, 12.0}};
+    auto c = a * b;
+    EXPECT_EQ(c.GetElement(0, 0), 58.0);
+    EXPECT_EQ(c.GetElement(1, 0), 64.0);
+    EXPECT_EQ(c.GetElement(0, 1), 139.0);
+    EXPECT_EQ(c.GetElement(1, 1), 154.0);
+}
+
+TEST(Matrices, MultiplyAcrossBlockEdges)
+{
+    expect_product_matches_reference<float>(1, 1, 1);
+    expect_product_matches_reference<float>(13, 37, 300);
+    expect_product_matches_reference<double>(7, 9, 5);
+    expect_product_matches_reference<double>(150, 75, 290);
+    expect_product_matches_reference<int>(5, 6, 7);
+}
+
+TEST(Matrices, GemmStridedOperands)
+{
+    // C = 2 * A^T * B + C, A read through swapped strides
+    matrix<double> a{2, 3, {1.0, 2.0,
+                            3.0, 4.0,
+                            5.0, 6.0}};
+    matrix<double> b{2, 3, {1.0, 0.0,
+                            0.0, 1.0,
+                            1.0, 1.0}};
+    matrix<double> c{2, 2, {1.0, 1.0, 1.0, 1.0}};
+    numericals::gemm<double>(2, 2, 3, 2.0, a.GetData(), 1, 2, b.GetData(), 2, 1, 1.0, c.GetData(), 2, 1);
+    EXPECT_EQ(c.GetElement(0, 0), 13.0);
+    EXPECT_EQ(c.GetElement(1, 0), 17.0);
+    EXPECT_EQ(c.GetElement(0, 1), 17.0);
+    EXPECT_EQ(c.GetElement(1, 1), 21.0);
+}
+
+template <typename T>
+void expect_micro_kernels_agree()
+{
+    constexpr size_t mr = numericals::gemm_blocking<T>::mr;
+    constexpr size_t nr = numericals::gemm_blocking<T>::nr;
+    constexpr size_t kc = 37;
+    std::vector<T, aligned_allocator<T>> a(mr * kc), b(nr * kc);
+    for(size_t i = 0; i < a.size(); i++) a[i] = T(int(i % 11) - 5) / T(4);
+    for(size_t i = 0; i < b.size(); i++) b[i] = T(int(i % 7) - 3) / T(2);
+
+    // the generic template against the dispatched overload (the AVX2/FMA kernel where available)
+    alignas(64) T generic[mr * nr];
+    alignas(64) T dispatched[mr * nr];
+    numericals::detail::micro_kernel<T>(kc, a.data(), b.data(), generic);
+    numericals::detail::micro_kernel(kc, a.data(), b.data(), dispatched);
+    for(size_t i = 0; i < mr * nr; i++)
+        EXPECT_EQ(dispatched[i], generic[i]);
+}
+
+TEST(Matrices, GemmMicroKernelsAgree)
+{
+    expect_micro_kernels_agree<float>();
+    expect_micro_kernels_agree<double>();
+}
+
+template <typename T>
+void expect_transposed(const size_t size_x, const size_t size_y)
+{
+    matrix<T> a{size_x, size_y};
+    for(size_t i = 0; i < size_x * size_y; i++) a.GetElement(i) = T(i);
+
+    auto t = a.Transposed();
+    ASSERT_EQ(t.GetSizeX(), size_y);
+    ASSERT_EQ(t.GetSizeY(), size_x);
+    for(size_t y = 0; y < size_y; y++)
+        for(size_t x = 0; x < size_x; x++)
+            EXPECT_EQ(t.GetElement(y, x), a.GetElement(x, y));
+
+    a.TransposeInPlace();
+    ASSERT_EQ(a.GetSizeX(), size_y);
+    for(size_t i = 0; i < size_x * size_y; i++)
+        EXPECT_EQ(a.GetElement(i), t.GetElement(i));
+}
+
+template <typename T>
+void expect_transpose_micro_kernels_agree()
+{
+    constexpr size_t micro = numericals::transpose_blocking<T>::micro;
+    constexpr ptrdiff_t lds = micro + 3;
+    std::vector<T> src(micro * lds);
+    for(size_t i = 0; i < src.size(); i++) src[i] = T(i);
+
+    std::vector<T> generic(micro * micro), dispatched(micro * micro);
+    numericals::detail::transpose_micro<T>(src.data(), lds, generic.data(), micro);
+    numericals::detail::transpose_micro(src.data(), lds, dispatched.data(), micro);
+    EXPECT_EQ(dispatched, generic);
+}
+
+TEST(Matrices, Transpose)
+{
+    expect_transpose_micro_kernels_agree<float>();
+    expect_transpose_micro_kernels_agree<double>();
+    expect_transposed<float>(1, 1);
+    expect_transposed<float>(37, 101);
+    expect_transposed<float>(67, 67);
+    expect_transposed<double>(70, 70);
+    expect_transposed<double>(129, 3);
+    expect_transposed<int>(9, 9);
+}
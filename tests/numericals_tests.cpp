@@ -4,6 +4,10 @@
 #include "PivotingStrategy.h"
 #include "vector.h"
 #include "MatrixDecomposer.h"
+#include "Factorization.h"
+#include "allocation_counter.h"
+#include "gram.h"
+#include "test_matrices.h"
 
 using namespace numericals;
 
@@ -45,6 +49,40 @@ TEST(MatrixEquationSolver, SolveLowTriangular)
     expect_valarray_equals<real>(x, std::valarray<real>{1.0, 0.0, 1.0});
 }
 
+TEST(MatrixEquationSolver, TriangularMultipleRightHandSides)
+{
+    const size_t n = 150, rhs = 20;
+    matrix<double> a{n, n};
+    for(size_t y = 0; y < n; y++)
+        for(size_t x = 0; x < n; x++)
+            a.GetElement(x, y) = x == y ? 2.0 + double(x % 3) : double((x * 13 + y * 7) % 17) / 17.0 - 0.5;
+    matrix<double> expected{rhs, n};
+    for(size_t y = 0; y < n; y++)
+        for(size_t x = 0; x < rhs; x++)
+            expected.GetElement(x, y) = double((x + 3 * y) % 11) - 5.0;
+
+    for(const bool lower : {true, false})
+        for(const bool transposed : {false, true})
+            for(const bool unit : {false, true})
+            {
+                // the triangle that is actually applied, after transposition
+                matrix<double> t{n, n};
+                for(size_t y = 0; y < n; y++)
+                    for(size_t x = 0; x < n; x++)
+                    {
+                        const size_t row = transposed ? x : y;
+                        const size_t col = transposed ? y : x;
+                        const bool inside = lower ? col <= row : col >= row;
+                        t.GetElement(x, y) = !inside ? 0.0 : (unit && x == y ? 1.0 : a.GetElement(col, row));
+                    }
+                matrix<double> b = t * expected;
+                matrix<double> x = lower ? solve_low_trian_matrix_eq(a, b, unit, transposed)
+                                         : solve_high_trian_matrix_eq(a, b, unit, transposed);
+                for(size_t i = 0; i < n * rhs; i++)
+                    EXPECT_NEAR(x.GetElement(i), expected.GetElement(i), 1e-9) << lower << transposed << unit;
+            }
+}
+
 TEST(MatrixEquationSolver, SolveGauss)
 {
     matrix<real> A{3, 3, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 9.0, 8.0, 8.0}};
@@ -67,6 +105,38 @@ TEST(MatrixEquationSolver, SolveJordan)
     expect_valarray_equals<real>(x, std::valarray<real>{2.0, 0.0, 4.0});
 }
 
+TEST(MatrixEquationSolver, JordanMultipleRightHandSides)
+{
+    matrix<double> A{3, 3, {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 9.0, 8.0, 8.0}};
+    matrix<double> B{2, 3, {14.0, 1.0,
+                          32.0, 4.0,
+                          50.0, 9.0}};
+
+    std::vector<std::chrono::nanoseconds> stepTimes;
+    matrix<double> X = solve_matrix_eq_jordan(A, B, 1, &stepTimes);
+
+    expect_matrix_equals(X, matrix<double>{2, 3, {2.0, 1.0,
+                                                0.0, 0.0,
+                                                4.0, 0.0}});
+    EXPECT_EQ(stepTimes.size(), 3);
+}
+
+TEST(MatrixEquationSolver, ParallelInverse)
+{
+    const size_t n = 300;
+    const matrix<double> A = dense_test_matrix(n, n, 0.5);
+
+    // 0 threads stands for one per hardware thread
+    for(const size_t threads : {size_t(4), size_t(0)})
+    {
+        matrix<double> inverse = get_inverse_matrix(A, threads);
+        matrix<double> identity = A * inverse;
+        for(size_t y = 0; y < n; y++)
+            for(size_t x = 0; x < n; x++)
+                EXPECT_NEAR(identity.GetElement(x, y), x == y ? 1.0 : 0.0, 1e-9);
+    }
+}
+
 TEST(MatrixEquationSolver, PartialSelection)
 {
     matrix<real> A{3, 3, {  1.0, 9.0, 2.0,
@@ -97,6 +167,166 @@ TEST(MatrixEquationSolver, FullSelection)
     expect_valarray_equals<real>(x2, solution);
 }
 
+TEST(MatrixEquationSolver, PivotingPolicies)
+{
+    matrix<real> A{3, 3, {  8.0, 8.0, 8.0,
+                            4.0, 5.0, 7.0,
+                            1.0, 2.0, 3.0 }};
+    vector<real> b {8.0, 1.0, 0.0};
+    vector<real> solution {0.0, 3.0, -2.0};
+
+    expect_valarray_equals<real>(solve_matrix_eq_gauss(A, b, PartialPivotingPolicy()), solution);
+    expect_valarray_equals<real>(solve_matrix_eq_jordan(A, b, PartialPivotingPolicy()), solution);
+    expect_valarray_equals<real>(solve_matrix_eq_gauss(A, b, FullPivotingPolicy()), solution);
+    expect_valarray_equals<real>(solve_matrix_eq_jordan(A, b, FullPivotingPolicy()), solution);
+    expect_valarray_equals<real>(solve_matrix_eq_gauss(A, b, NoPivotingPolicy()), solution);
+}
+
+TEST(MatrixEquationSolver, PivotingPoliciesNeedPivots)
+{
+    // a zero leading element and a large negative entry that only an absolute search picks
+    matrix<double> A{4, 4, {  0.0, 1.0, 2.0, 1.0,
+                              1.0, 3.0, 1.0, 0.0,
+                             -9.0, 1.0, 0.0, 2.0,
+                              2.0, 0.0, 1.0, 5.0 }};
+    vector<double> solution {1.0, -2.0, 3.0, 0.5};
+    vector<double> b = A * solution;
+
+    for(const auto& x : {solve_matrix_eq_gauss(A, b, PartialPivotingPolicy()),
+                         solve_matrix_eq_jordan(A, b, PartialPivotingPolicy()),
+                         solve_matrix_eq_gauss(A, b, FullPivotingPolicy()),
+                         solve_matrix_eq_jordan(A, b, FullPivotingPolicy())})
+        for(size_t i = 0; i < 4; i++)
+            EXPECT_NEAR(x[i], solution[i], 1e-12);
+}
+
+TEST(MatrixEquationSolver, InPlaceSolversWithWorkspaceDoNotAllocate)
+{
+    matrix<double> A{4, 4, {  0.0, 1.0, 2.0, 1.0,
+                              1.0, 3.0, 1.0, 0.0,
+                             -9.0, 1.0, 0.0, 2.0,
+                              2.0, 0.0, 1.0, 5.0 }};
+    vector<double> solution {1.0, -2.0, 3.0, 0.5};
+    const vector<double> b = A * solution;
+
+    SolverWorkspace<double> workspace(4);
+    matrix<double> a{4, 4};
+    vector<double> x(4);
+    const auto reset = [&]
+    {
+        for(size_t i = 0; i < 16; i++) a.GetElement(i) = A.GetElement(i);
+        for(size_t i = 0; i < 4; i++) x[i] = b[i];
+    };
+    const auto expect_solution = [&]
+    {
+        for(size_t i = 0; i < 4; i++)
+            EXPECT_NEAR(x[i], solution[i], 1e-12);
+    };
+
+    const size_t allocations = global_allocation_count();
+    const size_t libraryAllocations = heap_allocation_count;
+    for(int repeat = 0; repeat < 3; repeat++)
+    {
+        reset();
+        solve_matrix_eq_gauss_in_place(a, x, PartialPivotingPolicy(), workspace);
+        expect_solution();
+        reset();
+        solve_matrix_eq_jordan_in_place(a, x, FullPivotingPolicy(), workspace);
+        expect_solution();
+        reset();
+        solve_matrix_eq_gauss_in_place(a, x, PartialPivotingStragegy<double>());
+        expect_solution();
+        reset();
+        solve_matrix_eq_jordan_in_place(a, x, PartialPivotingStragegy<double>());
+        expect_solution();
+    }
+    EXPECT_EQ(global_allocation_count(), allocations);
+    EXPECT_EQ(heap_allocation_count, libraryAllocations);
+    EXPECT_EQ(workspace.GetCapacity(), 4u);
+
+    // full pivoting pushes its column swaps on a stack, whose buffer the library counter sees too
+    const size_t beforeFullPivoting = global_allocation_count();
+    const size_t libraryBeforeFullPivoting = heap_allocation_count;
+    reset();
+    solve_matrix_eq_gauss_in_place(a, x, FullPivotingStragegy<double>());
+    expect_solution();
+    EXPECT_GT(global_allocation_count(), beforeFullPivoting);
+    EXPECT_EQ(global_allocation_count() - beforeFullPivoting, heap_allocation_count - libraryBeforeFullPivoting);
+
+    // above the size the Jordan elimination would split between threads, with threads to
+    // spare: the in-place forms still start none unless asked to
+    constexpr size_t size = 400;
+    const matrix<double> big = dense_test_matrix(size, size, 0.5);
+    const vector<double> bigSolution = expected_solution(size);
+    const vector<double> bigRhs = big * bigSolution;
+    SolverWorkspace<double> bigWorkspace(size);
+    matrix<double> bigA = big;
+    vector<double> bigX = bigRhs;
+    numericals::set_num_threads(4);
+    const size_t beforeLarge = global_allocation_count();
+    for(int repeat = 0; repeat < 2; repeat++)
+    {
+        std::copy_n(big.GetData(), size * size, bigA.GetData());
+        bigX.View() = bigRhs.View();
+        solve_matrix_eq_jordan_in_place(bigA, bigX, PartialPivotingPolicy(), bigWorkspace);
+        std::copy_n(big.GetData(), size * size, bigA.GetData());
+        bigX.View() = bigRhs.View();
+        solve_matrix_eq_jordan_in_place(bigA, bigX, PartialPivotingStragegy<double>());
+    }
+    EXPECT_EQ(global_allocation_count(), beforeLarge);
+    numericals::set_num_threads(0);
+    for(size_t i = 0; i < size; i++)
+        EXPECT_NEAR(bigX[i], bigSolution[i], 1e-9);
+
+    // a larger system grows the workspace once
+    matrix<double> larger{5, 5};
+    vector<double> y(5);
+    for(size_t i = 0; i < 5; i++)
+    {
+        larger.GetElement(i, i) = 2.0;
+        y[i] = 4.0;
+    }
+    solve_matrix_eq_gauss_in_place(larger, y, NoPivotingPolicy(), workspace);
+    EXPECT_EQ(workspace.GetCapacity(), 5u);
+    EXPECT_NEAR(y[4], 2.0, 1e-15);
+}
+
+TEST(MatrixEquationSolver, DecompositionsAllocateOnlyThroughAlignedAllocator)
+{
+    constexpr size_t size = 48;
+    matrix<double> A{size, size};
+    vector<double> b(size);
+    for(size_t y = 0; y < size; y++)
+    {
+        for(size_t x = 0; x < size; x++)
+            A.GetElement(x, y) = 1.0 / double(x + y + 1);
+        A.GetElement(y, y) += double(size);
+        b[y] = double(y % 5) - 2.0;
+    }
+
+    // everything the decompositions and their solves allocate, results included, is seen by
+    // heap_allocation_count
+    const size_t allocations = global_allocation_count();
+    const size_t libraryAllocations = heap_allocation_count;
+    {
+        auto [lu, permutation] = lu_decomposition_with_pivoting(A);
+        matrix<double> qr = A;
+        const auto tau = qr_decomposition_in_place(qr.View());
+        const vector<double> x = LUFactorization<double>(A).Solve(b);
+        const vector<double> y = QRFactorization<double>(A).Solve(b);
+        const vector<double> z = LLTFactorization<double>(A).Solve(b);
+        const vector<double> w = LDLTFactorization<double>(A).Solve(b);
+        for(size_t i = 0; i < size; i++)
+        {
+            EXPECT_NEAR(x[i], y[i], 1e-10);
+            EXPECT_NEAR(x[i], z[i], 1e-10);
+            EXPECT_NEAR(x[i], w[i], 1e-10);
+        }
+    }
+    EXPECT_GT(heap_allocation_count, libraryAllocations);
+    EXPECT_EQ(global_allocation_count() - allocations, heap_allocation_count - libraryAllocations);
+}
+
 TEST(MatrixEquationSolver, LU_Decomposition)
 {
     matrix<real> A{3, 3, {  1.0, 2.0, 3.0,
@@ -110,6 +340,44 @@ TEST(MatrixEquationSolver, LU_Decomposition)
     expect_matrix_equals(A, expected_lu); 
 }
 
+TEST(MatrixEquationSolver, LU_DecompositionWithPivoting)
+{
+    matrix<real> A{3, 3, {  1.0, 2.0, 3.0,
+                            4.0, 5.0, 6.0,
+                            7.0, 8.0, 10.0 }};
+    matrix<real> expected_lu{3, 3, {7.0, 8.0, 10.0,
+                                    1.0 / 7.0, 6.0 / 7.0, 11.0 / 7.0,
+                                    4.0 / 7.0, 0.5, -0.5 }};
+    auto [lu, permutation] = lu_decomposition_with_pivoting(A);
+
+    expect_matrix_equals(lu, expected_lu);
+    EXPECT_EQ(permutation, (scratch_vector<size_t>{2, 0, 1}));
+
+    matrix<real> singular{3, 3, {  1.0, 2.0, 3.0,
+                                   2.0, 4.0, 6.0,
+                                   7.0, 8.0, 10.0 }};
+    EXPECT_THROW(lu_decomposition_with_pivoting(singular), std::runtime_error);
+    EXPECT_THROW(solve_matrix_eq_with_lu_decomposition(singular, vector<real>{1.0, 2.0, 3.0}, PartialPivotingStragegy<real>()),
+                 std::runtime_error);
+}
+
+TEST(MatrixEquationSolver, BlockedLU_Reconstructs)
+{
+    const size_t n = 150;
+    const matrix<double> A = dense_test_matrix(n, n, 0.5);
+
+    auto [lu, permutation] = lu_decomposition_with_pivoting(A);
+    for(size_t y = 0; y < n; y++)
+        for(size_t x = 0; x < n; x++)
+        {
+            EXPECT_LE(std::abs(x < y ? lu.GetElement(x, y) : 0.0), 1.0);
+            double sum = 0.0;
+            for(size_t k = 0; k <= std::min(x, y); k++)
+                sum += (k == y ? 1.0 : lu.GetElement(k, y)) * lu.GetElement(x, k);
+            EXPECT_NEAR(sum, A.GetElement(x, permutation[y]), 1e-9);
+        }
+}
+
 TEST(MatrixEquationSolver, LDLT_Decomposition)
 {
     matrix<real> A{3, 3, {  1.0, 0.0, 3.0,
@@ -121,6 +389,7 @@ TEST(MatrixEquationSolver, LDLT_Decomposition)
     A = ldlt_decomposition(A);
 
     expect_matrix_equals(A, expected_lu); 
+    EXPECT_THROW(ldlt_decomposition(matrix<real>{3, 2}), std::runtime_error);
 }
 
 TEST(MatrixEquationSolver, LLT_Decomposition)
@@ -137,25 +406,118 @@ TEST(MatrixEquationSolver, LLT_Decomposition)
     expect_matrix_equals(A, expected_lu); 
 }
 
+TEST(MatrixEquationSolver, BlockedLLTInPlaceTouchesOnlyTheLowerTriangle)
+{
+    constexpr size_t size = 300;
+    const matrix<double> a = spd_test_matrix(size);
+
+    // 0 threads stands for one per hardware thread
+    for(const size_t threads : {size_t(3), size_t(0)})
+    {
+        matrix<double> l = a;
+        for(size_t y = 0; y < size; y++)
+            for(size_t x = y + 1; x < size; x++)
+                l.GetElement(x, y) = -7.0;
+        llt_decomposition_in_place(l.View(), triangle::lower, threads);
+
+        for(size_t y = 0; y < size; y++)
+            for(size_t x = 0; x < size; x++)
+            {
+                if(x > y)
+                {
+                    EXPECT_EQ(l.GetElement(x, y), -7.0);
+                    continue;
+                }
+                double sum = 0.0;
+                for(size_t k = 0; k <= x; k++)
+                    sum += l.GetElement(k, y) * l.GetElement(k, x);
+                EXPECT_NEAR(sum, a.GetElement(x, y), 1e-9 * size);
+            }
+    }
+}
+
+TEST(MatrixEquationSolver, LLTReportsTheFailingPivot)
+{
+    constexpr size_t size = 150;
+    matrix<double> a{size, size};
+    for(size_t i = 0; i < size; i++)
+        a.GetElement(i, i) = 2.0;
+    a.GetElement(100, 100) = -1.0;
+
+    try
+    {
+        llt_decomposition_in_place(a.View());
+        FAIL() << "non positive definite matrix was factored";
+    }
+    catch(const not_positive_definite& e)
+    {
+        EXPECT_EQ(e.GetPivot(), 100u);
+    }
+    EXPECT_THROW(llt_decomposition(matrix<double>{2, 2, {1.0, 2.0, 2.0, 1.0}}), not_positive_definite);
+}
+
 TEST(MatrixEquationSolver, QR_Decomposition)
 {
- //   matrix<real> A{3, 4, {  1.0, -1.0, 1.0,
- //                           1.0, 0.0, 0.0,
- //                           1.0, 1.0, 1.0,
- //                           1.0, 2.0, 4.0}};
- //   
- //   matrix<real> expected_q{3, 3, { 0.5, real(-3.0/sqrt(5.0)), 0.5,
- //                                   0.5, real(-1.0/sqrt(5.0)), -0.5,
- //                                   0.5, real(1.0/sqrt(5.0)), -0.5,
- //                                   0.5, real(3.0/sqrt(5.0)), 0.5}};
- //
- //   matrix<real> expected_r{3, 3, {2.0, 1.0, 3.0,
- //                                   0.0, real(sqrt(5.0)), real(sqrt(5.0)),
- //                                   0.0, 0.0, 2.0 }};
- //   auto[Q, R] = qr_decomposition(A);
-
- //   expect_matrix_equals(Q, expected_q); 
- //   expect_matrix_equals(R, expected_r); 
+    matrix<real> A{3, 4, {  1.0, -1.0, 1.0,
+                            1.0, 0.0, 0.0,
+                            1.0, 1.0, 1.0,
+                            1.0, 2.0, 4.0}};
+
+    matrix<real> expected_q{3, 4, { 0.5, real(-1.5/sqrt(5.0)), 0.5,
+                                    0.5, real(-0.5/sqrt(5.0)), -0.5,
+                                    0.5, real(0.5/sqrt(5.0)), -0.5,
+                                    0.5, real(1.5/sqrt(5.0)), 0.5}};
+
+    matrix<real> expected_r{3, 3, {2.0, 1.0, 3.0,
+                                    0.0, real(sqrt(5.0)), real(sqrt(5.0)),
+                                    0.0, 0.0, 2.0 }};
+    auto[Q, R] = qr_decomposition(A);
+
+    expect_matrix_equals(Q, expected_q);
+    expect_matrix_equals(R, expected_r);
+}
+
+TEST(MatrixEquationSolver, BlockedQR_FullAndEconomy)
+{
+    constexpr size_t rows = 150, cols = 100;
+    const matrix<double> a = dense_test_matrix(rows, cols);
+
+    for(const qr_mode mode : {qr_mode::economy, qr_mode::full})
+    {
+        const auto [q, r] = qr_decomposition(a, mode);
+        const size_t k = mode == qr_mode::full ? rows : cols;
+        ASSERT_EQ(q.GetSizeX(), k);
+        ASSERT_EQ(r.GetSizeY(), k);
+
+        const matrix<double> qtq = transpose(q) * q;
+        const matrix<double> qr = q * r;
+        for(size_t y = 0; y < k; y++)
+            for(size_t x = 0; x < k; x++)
+                EXPECT_NEAR(qtq.GetElement(x, y), x == y ? 1.0 : 0.0, 1e-12);
+        for(size_t y = 0; y < rows; y++)
+            for(size_t x = 0; x < cols; x++)
+            {
+                EXPECT_NEAR(qr.GetElement(x, y), a.GetElement(x, y), 1e-12);
+                if(y > x && y < k)
+                {
+                    EXPECT_EQ(r.GetElement(x, y), 0.0);
+                }
+            }
+    }
+}
+
+TEST(MatrixEquationSolver, solveOverdeterminedMatrixWithQR)
+{
+    matrix<double> A{3, 4, {  1.0, 0.0, 0.0,
+                              0.0, 2.0, 0.0,
+                              2.0, 0.0, 1.0,
+                              0.0, 0.0, 1.0}};
+    vector<double> b{1.0, 2.0, 3.0, 0.0};
+    const vector<double> x = solve_overdetermined_matrix(A, b);
+    const vector<double> expected = solve_overdetermined_matrix(A, b, solve_matrix_eq_jordan);
+    ASSERT_EQ(x.GetSize(), 3);
+    for(size_t i = 0; i < 3; i++)
+        EXPECT_NEAR(x[i], expected[i], 1e-12);
 }
 
 TEST(MatrixEquationSolver, solveOverdeterminedMatrix)
@@ -194,6 +556,48 @@ TEST(MatrixEquationSolver, SolveLU_Matrix)
     expect_valarray_equals((std::valarray<real>)x, (std::valarray<real>)expected); 
 }
 
+TEST(MatrixEquationSolver, SolveLU_ZeroLeadingPivot)
+{
+    matrix<real> A{2, 2, {  0.0, 1.0,
+                            1.0, 0.0 }};
+    vector<real> b{1.0, 2.0};
+    vector<real> x = solve_matrix_eq_with_lu_decomposition(A, b, PartialPivotingStragegy<real>());
+    expect_valarray_equals((std::valarray<real>)x, std::valarray<real>{2.0, 1.0});
+
+    matrix<real> B{3, 3, {  0.0, 2.0, 1.0,
+                            1.0, 1.0, 1.0,
+                            4.0, 0.0, 3.0 }};
+    vector<real> expected{1.0, -1.0, 2.0};
+    x = solve_matrix_eq_with_lu_decomposition(B, B * expected, PartialPivotingStragegy<real>());
+    expect_valarray_equals((std::valarray<real>)x, (std::valarray<real>)expected);
+
+    // full pivoting and a caller's own row-exchanging strategy get row exchanges as well
+    x = solve_matrix_eq_with_lu_decomposition(B, B * expected, FullPivotingStragegy<real>());
+    expect_valarray_equals((std::valarray<real>)x, (std::valarray<real>)expected);
+    struct RowExchanges : PivotingStrategy<real>
+    {
+        void PreIteration(matrix<real>&, vector<real>&, size_t) override {}
+        void CleanUp(vector<real>&) override {}
+        bool ExchangesRows() const override { return true; }
+    };
+    x = solve_matrix_eq_with_lu_decomposition(B, B * expected, RowExchanges());
+    expect_valarray_equals((std::valarray<real>)x, (std::valarray<real>)expected);
+
+    // row exchanges come back through the permutation, unpivoted the factors meet the zero pivot
+    scratch_vector<size_t> permutation;
+    const matrix<real> pivoted = lu_decomposition(A, PartialPivotingStragegy<real>(), permutation);
+    EXPECT_EQ(permutation, (scratch_vector<size_t>{1, 0}));
+    expect_matrix_equals(pivoted, matrix<real>{2, 2, {1.0, 0.0,
+                                                      0.0, 1.0}});
+    lu_decomposition(B, FullPivotingStragegy<real>(), permutation);
+    EXPECT_EQ(permutation[0], 2u);
+    lu_decomposition(matrix<real>{2, 2, {2.0, 1.0, 1.0, 2.0}}, NoPivotingStragegy<real>(), permutation);
+    EXPECT_EQ(permutation, (scratch_vector<size_t>{0, 1}));
+    EXPECT_THROW(lu_decomposition(A, NoPivotingStragegy<real>(), permutation), std::runtime_error);
+    EXPECT_THROW(lu_decomposition(A), std::runtime_error);
+    EXPECT_THROW(solve_matrix_eq_with_lu_decomposition(A, b), std::runtime_error);
+}
+
 TEST(MatrixEquationSolver, SolveQR_Matrix)
 {
     // matrix<real> A{3, 4, {  1.0, 0.0, 0.0,
@@ -230,3 +634,157 @@ TEST(MatrixEquationSolver, SolveTridiagonalMatrix)
     expect_valarray_equals((std::valarray<real>)result, (std::valarray<real>)expected); 
 }
 
+TEST(MatrixEquationSolver, TridiagonalInPlaceAndParallel)
+{
+    // sizes spanning one and several blocks of the partitioned solver
+    for(const size_t size : {size_t(1), size_t(1000), size_t(100003)})
+    {
+        vector<double> lower(size - 1), diagonal(size), upper(size - 1), expected(size);
+        for(size_t i = 0; i < size; i++)
+        {
+            diagonal[i] = 4.0 + double(i % 3);
+            expected[i] = double(i % 11) - 5.0;
+            if(i + 1 < size)
+            {
+                lower[i] = -1.0 - double(i % 2);
+                upper[i] = 1.5 - double(i % 4);
+            }
+        }
+        vector<double> b(size);
+        for(size_t i = 0; i < size; i++)
+            b[i] = diagonal[i] * expected[i] + (i > 0 ? lower[i - 1] * expected[i - 1] : 0.0)
+                   + (i + 1 < size ? upper[i] * expected[i + 1] : 0.0);
+
+        // 0 threads stands for one per hardware thread
+        for(const size_t threads : {size_t(1), size_t(4), size_t(7), size_t(0)})
+        {
+            vector<double> x = b;
+            solve_tridiagonal_matrix_eq_parallel<double>(lower.View(), diagonal.View(), upper.View(), x.View(), threads);
+            for(size_t i = 0; i < size; i++)
+                EXPECT_NEAR(x[i], expected[i], 1e-10);
+        }
+
+        vector<double> x = b;
+        solve_tridiagonal_matrix_eq_in_place<double>(lower.View(), diagonal.View(), upper.View(), x.View());
+        for(size_t i = 0; i < size; i++)
+            EXPECT_NEAR(x[i], expected[i], 1e-10);
+    }
+
+    // an empty system is solved trivially by every partition count
+    vector<double> none(0);
+    for(const size_t threads : {size_t(1), size_t(4)})
+        solve_tridiagonal_matrix_eq_parallel<double>(none.View(), none.View(), none.View(), none.View(), threads);
+    solve_tridiagonal_matrix_eq_in_place<double>(none.View(), none.View(), none.View(), none.View());
+    EXPECT_EQ(none.GetSize(), 0u);
+
+    vector<double> shortLower(2), diagonal(2), upper(1), b(2);
+    EXPECT_THROW(solve_tridiagonal_matrix_eq_in_place<double>(shortLower.View(), diagonal.View(), upper.View(), b.View()), std::runtime_error);
+}
+
+TEST(MatrixEquationSolver, TridiagonalParallelWeaklyDominant)
+{
+    // the spikes barely decay over a block, so the far coupling of every interface counts
+    const size_t size = 70000;
+    vector<double> lower(size - 1), diagonal(size), upper(size - 1);
+    for(size_t i = 0; i < size; i++)
+    {
+        diagonal[i] = 2.0 + 1e-9;
+        if(i + 1 < size) lower[i] = upper[i] = -1.0;
+    }
+    const vector<double> b = expected_solution(size);
+    const vector<double> expected = solve_tridiagonal_matrix_eq<double>({lower, diagonal, upper}, b);
+    double scale = 0.0;
+    for(size_t i = 0; i < size; i++)
+        scale = std::max(scale, std::abs(expected[i]));
+
+    for(const size_t threads : {size_t(3), size_t(4)})
+    {
+        vector<double> x = b;
+        solve_tridiagonal_matrix_eq_parallel<double>(lower.View(), diagonal.View(), upper.View(), x.View(), threads);
+        for(size_t i = 0; i < size; i++)
+            EXPECT_NEAR(x[i] / scale, expected[i] / scale, 1e-9);
+    }
+}
+
+
+void expect_normal_equations_match_product(const size_t rows, const size_t cols, const size_t threads)
+{
+    using T = real;
+    matrix<T> a{cols, rows};
+    vector<T> b(rows);
+    for(size_t i = 0; i < rows * cols; i++) a.GetElement(i) = T(int(i * 7 % 17) - 8) / 8;
+    for(size_t i = 0; i < rows; i++) b[i] = T(int(i % 5) - 2);
+
+    numericals::set_num_threads(threads);
+    auto [ata, atb] = get_normal_equations(a, b);
+    numericals::set_num_threads(0);
+
+    for(size_t y = 0; y < cols; y++)
+    {
+        double expectedRhs = 0;
+        for(size_t r = 0; r < rows; r++)
+            expectedRhs += a.GetElement(y, r) * b[r];
+        EXPECT_NEAR(atb[y], expectedRhs, 1e-6 * rows);
+        for(size_t x = 0; x < cols; x++)
+        {
+            double expected = 0;
+            for(size_t r = 0; r < rows; r++)
+                expected += a.GetElement(x, r) * a.GetElement(y, r);
+            EXPECT_NEAR(ata.GetElement(x, y), expected, 1e-6 * rows);
+        }
+    }
+}
+
+TEST(MatrixEquationSolver, NormalEquations)
+{
+    expect_normal_equations_match_product(4, 3, 1);
+    expect_normal_equations_match_product(20000, 7, 3);
+    expect_normal_equations_match_product(300, 150, 2);
+
+    // 0 threads stands for one per hardware thread, as in set_num_threads
+    matrix<double> a{4, 10000};
+    for(size_t i = 0; i < a.GetSizeX() * a.GetSizeY(); i++) a.GetElement(i) = double(int(i * 7 % 17) - 8) / 8;
+    matrix<double> serial{4, 4}, automatic{4, 4};
+    gram_upper<double>(a.View(), nullptr, serial.View(), nullptr, 1);
+    gram_upper<double>(a.View(), nullptr, automatic.View(), nullptr, 0);
+    for(size_t y = 0; y < 4; y++)
+        for(size_t x = y; x < 4; x++)
+            EXPECT_NEAR(automatic.GetElement(x, y), serial.GetElement(x, y), 1e-9);
+
+    // the wide path leaves everything below the diagonal alone, diagonal tiles included
+    constexpr size_t wide = 200;
+    const matrix<double> w = dense_test_matrix(50, wide);
+    const vector<double> rhs = expected_solution(50);
+    matrix<double> c{wide, wide};
+    vector<double> atb(wide);
+    for(size_t i = 0; i < wide * wide; i++) c.GetElement(i) = -7.0;
+    gram_upper<double>(w.View(), rhs.GetData(), c.View(), atb.GetData(), 3);
+    for(size_t y = 0; y < wide; y++)
+    {
+        double expectedRhs = 0.0;
+        for(size_t r = 0; r < 50; r++)
+            expectedRhs += w.GetElement(y, r) * rhs[r];
+        EXPECT_NEAR(atb[y], expectedRhs, 1e-9);
+        for(size_t x = 0; x < y; x++)
+            EXPECT_EQ(c.GetElement(x, y), -7.0);
+    }
+}
+
+TEST(MatrixEquationSolver, ScalarTypes)
+{
+    matrix<double> A{3, 3, {  1.0, 9.0, 2.0,
+                              2.0, 5.0, 7.0,
+                              3.0, 8.0, 3.0}};
+    vector<double> b {1.0, 2.0, 3.0};
+    auto x1 = solve_matrix_eq_gauss(A, b, PartialPivotingStragegy<double>());
+    EXPECT_DOUBLE_EQ(x1[0], 1.0);
+    EXPECT_NEAR(x1[1], 0.0, 1e-15);
+
+    matrix<long double> B{3, 3, {  4.0, 12.0, -16.0,
+                                  12.0, 37.0, -43.0,
+                                 -16.0, -43.0, 98.0 }};
+    vector<long double> c{72.0, 0.0, 288.0};
+    auto x2 = solve_matrix_eq_with_llt_decomposition(B, c);
+    EXPECT_NEAR(double(x2[0]), 4162.0, 1e-9);
+    EXPECT_NEAR(double(x2[2]), 184.0, 1e-9);
+}
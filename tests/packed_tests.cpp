@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "MatrixDecomposer.h"
+#include "PackedSolver.h"
+#include "test_matrices.h"
+#include <functional>
+
+using namespace numericals;
+
+TEST(Packed, LayoutsRoundTrip)
+{
+    for(const size_t size : {0, 1, 2, 5, 8})
+    {
+        matrix<double> a = spd_test_matrix(size);
+        const packed_matrix<double> packed(a.View());
+        const rfp_matrix<double> rfp(a.View());
+        EXPECT_EQ(packed.GetStorageSize(), size * (size + 1) / 2);
+        EXPECT_EQ(rfp.GetStorageSize(), size * (size + 1) / 2);
+
+        const matrix<double> fromPacked = packed.GetSymmetric();
+        const matrix<double> fromRfp = rfp.GetSymmetric();
+        for(size_t y = 0; y < size; y++)
+            for(size_t x = 0; x < size; x++)
+            {
+                EXPECT_EQ(fromPacked.GetElement(x, y), a.GetElement(x, y));
+                EXPECT_EQ(fromRfp.GetElement(x, y), a.GetElement(x, y));
+            }
+    }
+}
+
+TEST(Packed, LLTAndLDLT)
+{
+    constexpr size_t size = 50;
+    const matrix<double> a = spd_test_matrix(size);
+    const vector<double> expected = expected_solution(size);
+    const vector<double> b = a * expected;
+
+    packed_matrix<double> llt(a.View());
+    llt_decomposition_in_place(llt);
+    matrix<double> dense = a;
+    llt_decomposition_in_place(dense.View());
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x <= y; x++)
+            EXPECT_NEAR(llt.GetElement(x, y), dense.GetElement(x, y), 1e-12);
+
+    const vector<double> x = solve_matrix_eq_with_llt_packed(llt, b);
+    for(size_t i = 0; i < size; i++)
+        EXPECT_NEAR(x[i], expected[i], 1e-9);
+
+    matrix<double> indefinite{3, 3, {  1.0, 0.0, 3.0,
+                                       0.0, 6.0, 6.0,
+                                       3.0, 6.0, 5.0 }};
+    packed_matrix<double> ldlt(indefinite.View());
+    ldlt_decomposition_in_place(ldlt);
+    const matrix<double> factors = ldlt.GetLower();
+    const matrix<double> expectedFactors{3, 3, {  1.0, 0.0, 0.0,
+                                                  0.0, 6.0, 0.0,
+                                                  3.0, 1.0, -10.0 }};
+    for(size_t y = 0; y < 3; y++)
+        for(size_t x = 0; x < 3; x++)
+            EXPECT_NEAR(factors.GetElement(x, y), expectedFactors.GetElement(x, y), 1e-12);
+
+    const vector<double> y = solve_matrix_eq_with_ldlt_packed(ldlt, vector<double>{4.0, 12.0, 14.0});
+    EXPECT_NEAR(y[0], 1.0, 1e-12);
+    EXPECT_NEAR(y[1], 1.0, 1e-12);
+    EXPECT_NEAR(y[2], 1.0, 1e-12);
+}
+
+TEST(Packed, RectangularFullPackedLLT)
+{
+    for(const size_t size : {129, 200})
+    {
+        const matrix<double> a = spd_test_matrix(size);
+        rfp_matrix<double> llt(a.View());
+        llt_decomposition_in_place(llt, 2);
+
+        matrix<double> dense = a;
+        llt_decomposition_in_place(dense.View());
+        for(size_t y = 0; y < size; y++)
+            for(size_t x = 0; x <= y; x++)
+                EXPECT_NEAR(llt.GetElement(x, y), dense.GetElement(x, y), 1e-10);
+
+        matrix<double> expected{3, size};
+        for(size_t y = 0; y < size; y++)
+            for(size_t x = 0; x < 3; x++)
+                expected.GetElement(x, y) = double((x + 1) * (y % 5)) - 2.0;
+        const matrix<double> x = solve_matrix_eq_with_llt_packed(llt, matrix<double>(a * expected));
+        for(size_t y = 0; y < size; y++)
+            for(size_t c = 0; c < 3; c++)
+                EXPECT_NEAR(x.GetElement(c, y), expected.GetElement(c, y), 1e-9);
+
+        const vector<double> v = solve_matrix_eq_with_llt_packed(llt, vector<double>(a * expected_solution(size)));
+        for(size_t i = 0; i < size; i++)
+            EXPECT_NEAR(v[i], double(i % 7) - 3.0, 1e-9);
+    }
+}
+
+TEST(Packed, TriangularSolves)
+{
+    constexpr size_t size = 9;
+    matrix<double> l{size, size};
+    for(size_t y = 0; y < size; y++)
+        for(size_t x = 0; x <= y; x++)
+            l.GetElement(x, y) = x == y ? 2.0 + double(y) : double((x + 2 * y) % 5) - 2.0;
+    const vector<double> expected = expected_solution(size);
+
+    const packed_matrix<double> packed(l.View());
+    const rfp_matrix<double> rfp(l.View());
+    const vector<double> lower = l * expected;
+    const vector<double> upper = transpose(l) * expected;
+    const vector<double> fromPacked = solve_low_trian_matrix_eq(packed, lower);
+    const vector<double> fromRfp = solve_low_trian_matrix_eq(rfp, lower);
+    const vector<double> fromPackedT = solve_low_trian_matrix_eq(packed, upper, false, true);
+    const vector<double> fromRfpT = solve_low_trian_matrix_eq(rfp, upper, false, true);
+    for(size_t i = 0; i < size; i++)
+    {
+        EXPECT_NEAR(fromPacked[i], expected[i], 1e-12);
+        EXPECT_NEAR(fromRfp[i], expected[i], 1e-12);
+        EXPECT_NEAR(fromPackedT[i], expected[i], 1e-12);
+        EXPECT_NEAR(fromRfpT[i], expected[i], 1e-12);
+    }
+}
+
+TEST(Packed, ReportsTheFailingPivot)
+{
+    constexpr size_t size = 150;
+    matrix<double> a{size, size};
+    for(size_t i = 0; i < size; i++)
+        a.GetElement(i, i) = 2.0;
+    a.GetElement(120, 120) = -1.0;
+
+    rfp_matrix<double> rfp(a.View());
+    packed_matrix<double> packed(a.View());
+    for(const auto& factor : std::initializer_list<std::function<void()>>{
+            [&] { llt_decomposition_in_place(rfp); }, [&] { llt_decomposition_in_place(packed); }})
+    {
+        try
+        {
+            factor();
+            FAIL() << "non positive definite matrix was factored";
+        }
+        catch(const not_positive_definite& e)
+        {
+            EXPECT_EQ(e.GetPivot(), 120u);
+        }
+    }
+}
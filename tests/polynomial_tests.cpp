@@ -121,3 +121,10 @@ TEST(Interpolation, NewtonInterpolation)
     EXPECT_NEAR(func(1), 4.0, abs_error);
 }
 
+
+TEST(Functions, FindZeroInDouble)
+{
+    auto func = [](double x){return x * x - 2.0;};
+    EXPECT_NEAR(std::sqrt(2.0), find_function_zero_with_secant<double>(func, 1.0, 2.0), 1e-5);
+    EXPECT_NEAR(std::sqrt(2.0), find_function_zero_with_bisection<double>(func, 1.0, 2.0), 1e-5);
+}
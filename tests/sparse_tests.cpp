@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "MatrixDecomposer.h"
+#include "MatrixSolver.h"
+#include "sparse_matrix.h"
+#include "test_matrices.h"
+
+using namespace numericals;
+
+TEST(Sparse, AssemblyAndConversion)
+{
+    const std::vector<triplet<double>> entries{{2, 0, 1.0}, {0, 0, 2.0}, {2, 0, 3.0}, {1, 2, -1.0}, {0, 1, 5.0}};
+    const csr_matrix<double> a(3, 3, std::span<const triplet<double>>(entries));
+    EXPECT_EQ(a.GetNonZeroCount(), 4);
+    EXPECT_EQ(a.GetElement(2, 0), 4.0);
+    EXPECT_EQ(a.GetElement(1, 1), 0.0);
+
+    const csc_matrix<double> c(a);
+    const csr_matrix<double> back(c);
+    const matrix<double> dense = a.ToDense();
+    const matrix<double> denseC = c.ToDense();
+    for(size_t y = 0; y < 3; y++)
+        for(size_t x = 0; x < 3; x++)
+        {
+            EXPECT_EQ(denseC.GetElement(x, y), dense.GetElement(x, y));
+            EXPECT_EQ(back.GetElement(x, y), dense.GetElement(x, y));
+        }
+    EXPECT_EQ(back.GetIndices(), a.GetIndices());
+
+    const std::vector<triplet<double>> outside{{3, 0, 1.0}};
+    EXPECT_THROW(csr_matrix<double>(3, 3, std::span<const triplet<double>>(outside)), std::runtime_error);
+}
+
+TEST(Sparse, MultiThreadedProduct)
+{
+    const csr_matrix<double> a = grid_matrix(200, 0.25);
+    const vector<double> x = expected_solution(a.GetSizeX());
+    const vector<double> byColumns = csc_matrix<double>(a) * x;
+    // 0 threads stands for one per hardware thread
+    for(const size_t threads : {size_t(3), size_t(0)})
+    {
+        vector<double> threaded(a.GetSizeY());
+        multiply(a, x.View(), threaded.View(), threads);
+        for(size_t i = 0; i < a.GetSizeY(); i++)
+            EXPECT_NEAR(threaded[i], byColumns[i], 1e-12);
+    }
+}
+
+TEST(Sparse, LU)
+{
+    const csr_matrix<double> a = grid_matrix(30, 0.4);
+    const vector<double> expected = expected_solution(a.GetSizeX());
+    const vector<double> b = a * expected;
+
+    const vector<double> x = solve_matrix_eq_with_lu_decomposition(a, b);
+    for(size_t i = 0; i < x.GetSize(); i++)
+        EXPECT_NEAR(x[i], expected[i], 1e-10);
+
+    const SparseLUFactorization<double> natural(csc_matrix<double>(a), fill_ordering::natural);
+    const SparseLUFactorization<double> ordered{csc_matrix<double>(a)};
+    EXPECT_LT(ordered.GetNonZeroCount(), natural.GetNonZeroCount());
+
+    // needs row exchanges
+    const std::vector<triplet<double>> entries{{1, 0, 2.0}, {0, 1, 1.0}, {1, 1, 1.0}, {2, 2, 3.0}};
+    const csr_matrix<double> permuted(3, 3, std::span<const triplet<double>>(entries));
+    const vector<double> y = solve_matrix_eq_with_lu_decomposition(permuted, vector<double>{2.0, 3.0, 6.0});
+    EXPECT_NEAR(y[0], 2.0, 1e-12);
+    EXPECT_NEAR(y[1], 1.0, 1e-12);
+    EXPECT_NEAR(y[2], 2.0, 1e-12);
+}
+
+TEST(Sparse, LLT)
+{
+    const csr_matrix<double> a = grid_matrix(40, 0.0);
+    const vector<double> expected = expected_solution(a.GetSizeX());
+    const vector<double> b = a * expected;
+
+    const vector<double> x = solve_matrix_eq_with_llt_decomposition(a, b);
+    for(size_t i = 0; i < x.GetSize(); i++)
+        EXPECT_NEAR(x[i], expected[i], 1e-10);
+
+    const SparseLLTFactorization<double> natural(csc_matrix<double>(a), fill_ordering::natural);
+    const SparseLLTFactorization<double> ordered{csc_matrix<double>(a)};
+    EXPECT_LT(ordered.GetNonZeroCount(), natural.GetNonZeroCount());
+
+    // the factor matches the dense one in natural order
+    const csr_matrix<double> small = grid_matrix(4, 0.0);
+    const SparseLLTFactorization<double> sparse(csc_matrix<double>(small), fill_ordering::natural);
+    matrix<double> dense = small.ToDense();
+    llt_decomposition_in_place(dense.View());
+    const matrix<double> l = sparse.GetLower().ToDense();
+    for(size_t y = 0; y < 16; y++)
+        for(size_t c = 0; c <= y; c++)
+            EXPECT_NEAR(l.GetElement(c, y), dense.GetElement(c, y), 1e-12);
+}
+
+TEST(Sparse, LLTReportsTheFailingPivot)
+{
+    std::vector<triplet<double>> entries;
+    for(size_t i = 0; i < 10; i++)
+        entries.push_back({i, i, i == 6 ? -1.0 : 2.0});
+    const csc_matrix<double> a(10, 10, std::span<const triplet<double>>(entries));
+    try
+    {
+        SparseLLTFactorization<double> llt(a);
+        FAIL() << "non positive definite matrix was factored";
+    }
+    catch(const not_positive_definite& e)
+    {
+        EXPECT_EQ(e.GetPivot(), 6u);
+    }
+}
@@ -0,0 +1,222 @@
+#include "MatrixSolver.h"
+#include "matrix.h"
+#include "memory_arena.h"
+#include "storage.h"
+#include <cstdint>
+#include <optional>
+#include <gtest/gtest.h>
+
+TEST(Storage, DefaultIsCacheLineAligned)
+{
+    matrix<float> mat{7, 5};
+    vector<double> vec(13);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mat.GetData()) % 64, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(vec.GetData()) % 64, 0);
+    EXPECT_TRUE(mat.IsContiguous());
+}
+
+TEST(Storage, PaddedRows)
+{
+    matrix<double, padded_storage<double>> a{3, 2, {1.0, 2.0, 3.0,
+                                                    4.0, 5.0, 6.0}};
+    ASSERT_EQ(a.GetLeadingDimension(), 8);
+    EXPECT_FALSE(a.IsContiguous());
+    for(size_t y = 0; y < a.GetSizeY(); y++)
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.Row(y).GetData()) % 64, 0);
+    EXPECT_EQ(a.GetElement(2, 1), 6.0);
+    EXPECT_EQ(a.GetElement(4), 5.0);
+
+    matrix<double> b{2, 3, {1.0, 0.0,
+                            0.0, 1.0,
+                            1.0, 1.0}};
+    matrix<double> product = a * b;
+    EXPECT_EQ(product.GetElement(0, 0), 4.0);
+    EXPECT_EQ(product.GetElement(1, 1), 11.0);
+
+    matrix<double> transposed = a.Transposed();
+    EXPECT_EQ(transposed.GetElement(1, 2), 6.0);
+
+    matrix<double> copy(a);
+    EXPECT_EQ(copy.GetLeadingDimension(), 3);
+    EXPECT_EQ(copy.GetElement(1, 1), 5.0);
+}
+
+TEST(Storage, ArenaBacked)
+{
+    memory_arena arena(4096);
+    {
+        matrix<float, arena_storage<float>> a{4, 4, arena_allocator<float>(arena)};
+        vector<float, arena_storage<float>> v(4, arena_allocator<float>(arena));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.GetData()) % 64, 0);
+        EXPECT_GE(arena.GetUsedBytes(), 20 * sizeof(float));
+        for(size_t i = 0; i < 4; i++)
+        {
+            a.GetElement(i, i) = 2.0f;
+            v[i] = float(i);
+        }
+        vector<float> result = a * v;
+        EXPECT_EQ(result[3], 6.0f);
+    }
+    arena.Release();
+    EXPECT_EQ(arena.GetUsedBytes(), 0);
+    EXPECT_GE(arena.GetCapacity(), 4096);
+}
+
+TEST(Storage, ArenaScopeBacksDefaultStorage)
+{
+    memory_arena arena(1 << 16);
+    matrix<double> outside{3, 3};
+    const size_t heapAllocations = heap_allocation_count;
+    {
+        arena_scope scope(arena);
+        EXPECT_EQ(memory_arena::GetBound(), &arena);
+
+        matrix<double> a{8, 8};
+        vector<double> v(8);
+        EXPECT_TRUE(arena.Owns(a.GetData()));
+        EXPECT_TRUE(arena.Owns(v.GetData()));
+        EXPECT_FALSE(arena.Owns(outside.GetData()));
+        for(size_t i = 0; i < 8; i++)
+        {
+            a.GetElement(i, i) = 4.0;
+            if(i > 0) a.GetElement(i - 1, i) = 1.0;
+            v[i] = double(i);
+        }
+
+        // every temporary of a decomposition lands in the arena
+        const vector<double> x = numericals::solve_matrix_eq_with_lu_decomposition(a, a * v);
+        for(size_t i = 0; i < 8; i++)
+            EXPECT_NEAR(x[i], v[i], 1e-12);
+        EXPECT_EQ(heap_allocation_count, heapAllocations);
+
+        const size_t nestedStart = arena.GetUsedBytes();
+        {
+            memory_arena inner(4096);
+            arena_scope nested(inner);
+            vector<double> w(16);
+            EXPECT_TRUE(inner.Owns(w.GetData()));
+        }
+        EXPECT_EQ(memory_arena::GetBound(), &arena);
+        EXPECT_EQ(arena.GetUsedBytes(), nestedStart);
+    }
+    EXPECT_EQ(memory_arena::GetBound(), nullptr);
+    EXPECT_EQ(arena.GetUsedBytes(), 0u);
+    EXPECT_GE(arena.GetStatistics().peak_bytes, 64 * sizeof(double));
+    EXPECT_GE(arena.GetStatistics().allocations, 4u);
+    EXPECT_EQ(arena.GetStatistics().heap_fallbacks, 0u);
+}
+
+TEST(Storage, ArenaScopeReleasesOuterArenaMemoryInNestedScope)
+{
+    memory_arena outer(4096), inner(4096);
+    const size_t heapAllocations = heap_allocation_count;
+    {
+        arena_scope outerScope(outer);
+        vector<double> x(8), y(8);
+        ASSERT_TRUE(outer.Owns(x.GetData()));
+        {
+            arena_scope innerScope(inner);
+            // releases the outer arena's block while the inner arena is the bound one
+            x = vector<double>(32);
+            EXPECT_TRUE(inner.Owns(x.GetData()));
+            EXPECT_TRUE(outer.Owns(y.GetData()));
+            // and hands x back an outer block before the inner scope ends
+            x = std::move(y);
+        }
+        EXPECT_TRUE(outer.Owns(x.GetData()));
+        x[7] = 1.0;
+    }
+    EXPECT_EQ(memory_arena::GetBound(), nullptr);
+    EXPECT_EQ(heap_allocation_count, heapAllocations);
+}
+
+TEST(Storage, ArenaMemoryMayBeReleasedAfterItsScope)
+{
+    const size_t heapAllocations = heap_allocation_count;
+    std::optional<vector<double>> late, orphan;
+    {
+        memory_arena arena(4096);
+        {
+            arena_scope scope(arena);
+            late.emplace(16);
+            orphan.emplace(16);
+            ASSERT_TRUE(arena.Owns(late->GetData()));
+        }
+        EXPECT_EQ(memory_arena::GetBound(), nullptr);
+        // handed back to the arena, not to operator delete
+        late.reset();
+    }
+    // and so is memory whose arena is already gone
+    orphan.reset();
+    EXPECT_EQ(heap_allocation_count, heapAllocations);
+
+    vector<double> heap(16);
+    EXPECT_EQ(heap_allocation_count, heapAllocations + 1);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(heap.GetData()) % 64, 0u);
+}
+
+TEST(Storage, ArenaBlocksAreMarkedWithoutExtraBytes)
+{
+    memory_arena arena(4096);
+    arena_scope scope(arena);
+    vector<double> first(8);
+    const size_t afterFirst = arena.GetUsedBytes();
+    vector<double> second(8);
+    // both start at an odd multiple of 64, so a 64 byte block is followed by a 64 byte gap,
+    // which counts as used
+    const auto distance = reinterpret_cast<std::uintptr_t>(second.GetData()) - reinterpret_cast<std::uintptr_t>(first.GetData());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first.GetData()) % 128, 64u);
+    EXPECT_EQ(distance, 128u);
+    EXPECT_EQ(arena.GetUsedBytes() - afterFirst, 128u);
+    EXPECT_LE(afterFirst, 128u);
+}
+
+TEST(Storage, ArenaScopeFallsBackToTheHeap)
+{
+    memory_arena arena(4096, 4096);
+    const size_t heapAllocations = heap_allocation_count;
+    {
+        arena_scope scope(arena);
+        vector<double> small(64);
+        vector<double> large(4096);
+        EXPECT_TRUE(arena.Owns(small.GetData()));
+        EXPECT_FALSE(arena.Owns(large.GetData()));
+    }
+    EXPECT_EQ(heap_allocation_count, heapAllocations + 1);
+    EXPECT_EQ(arena.GetStatistics().heap_fallbacks, 1u);
+    EXPECT_EQ(arena.GetCapacity(), 4096u);
+
+    arena.ResetStatistics();
+    EXPECT_EQ(arena.GetStatistics().allocations, 0u);
+
+    // a refused request leaves the room of the chunk to the smaller ones after it
+    memory_arena limited(1 << 20, 1 << 20);
+    {
+        arena_scope scope(limited);
+        vector<double> first(128);
+        vector<double> huge(size_t(1) << 19);
+        vector<double> second(128);
+        EXPECT_TRUE(limited.Owns(first.GetData()));
+        EXPECT_FALSE(limited.Owns(huge.GetData()));
+        EXPECT_TRUE(limited.Owns(second.GetData()));
+    }
+    EXPECT_EQ(limited.GetStatistics().heap_fallbacks, 1u);
+}
+
+TEST(Storage, ExternalBufferIsNotCopied)
+{
+    double buffer[] = {1.0, 2.0, -1.0,
+                       3.0, 4.0, -1.0};
+    matrix<double, external_storage<double>> a{2, 2, buffer, size_t(3)};
+    EXPECT_EQ(a.GetData(), buffer);
+    EXPECT_EQ(a.GetElement(0, 1), 3.0);
+
+    a.GetElement(1, 1) = 8.0;
+    EXPECT_EQ(buffer[4], 8.0);
+    EXPECT_EQ(buffer[2], -1.0);
+
+    auto alias = a;
+    EXPECT_EQ(alias.GetData(), buffer);
+
+    EXPECT_THROW((matrix<double, external_storage<double>>{4, 2, buffer, size_t(3)}), std::runtime_error);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "matrix.h"
+#include "sparse_matrix.h"
+#include "vector.h"
+#include <span>
+#include <vector>
+
+// Problems shared by the solver tests
+
+// five-point stencil on a side x side grid, plus convection making it unsymmetric
+inline numericals::csr_matrix<double> grid_matrix(const size_t side, const double convection)
+{
+    std::vector<numericals::triplet<double>> entries;
+    for(size_t y = 0; y < side; y++)
+        for(size_t x = 0; x < side; x++)
+        {
+            const size_t i = y * side + x;
+            entries.push_back({i, i, 4.0});
+            if(x > 0) entries.push_back({i - 1, i, -1.0 - convection});
+            if(x + 1 < side) entries.push_back({i + 1, i, -1.0 + convection});
+            if(y > 0) entries.push_back({i - side, i, -1.0});
+            if(y + 1 < side) entries.push_back({i + side, i, -1.0});
+        }
+    return numericals::csr_matrix<double>(side * side, side * side, std::span<const numericals::triplet<double>>(entries));
+}
+
+// Dense rows x cols matrix of deterministic entries spread over [-1, 1), diagonal added to the
+// main diagonal; with diagonal 0.5 the square ones are comfortably nonsingular
+inline matrix<double> dense_test_matrix(const size_t rows, const size_t cols, const double diagonal = 0.0)
+{
+    matrix<double> a{cols, rows};
+    for(size_t y = 0; y < rows; y++)
+        for(size_t x = 0; x < cols; x++)
+            a.GetElement(x, y) = double((x * 37 + y * 91) % 101) / 50.0 - 1.0 + (x == y ? diagonal : 0.0);
+    return a;
+}
+
+// M^T M + size I for the dense test matrix M: symmetric positive definite and well conditioned
+inline matrix<double> spd_test_matrix(const size_t size)
+{
+    const matrix<double> m = dense_test_matrix(size, size);
+    matrix<double> a = transpose(m) * m;
+    for(size_t i = 0; i < size; i++)
+        a.GetElement(i, i) += double(size);
+    return a;
+}
+
+// a known solution to build right-hand sides from, with every residue mod 7 in [-3, 3]
+inline vector<double> expected_solution(const size_t size)
+{
+    vector<double> x(size);
+    for(size_t i = 0; i < size; i++)
+        x[i] = double(i % 7) - 3.0;
+    return x;
+}
@@ -64,3 +64,15 @@ TEST(Utils, FindIndexOfMaxElementInTheValarray)
     EXPECT_EQ(1, find_index_of_valarray_max(A.GetColumn(2), 1, 3));
     EXPECT_EQ(2, find_index_of_valarray_max(A.GetColumn(2), 2, 3));
 }
+
+TEST(Utils, FindIndexOfMaxUsesAbsoluteValuesInTheActiveSubmatrix)
+{
+    matrix<double> A{3, 3, {9.0, 2.0, 3.0,
+                            2.0, 1.0, -4.0,
+                            3.0, -5.0, 1.0}};
+
+    EXPECT_EQ(find_index_of_matrix_max(A, 1, 1), std::make_pair(size_t(1), size_t(2)));
+    EXPECT_EQ(find_index_of_matrix_max(A, 2, 0), std::make_pair(size_t(2), size_t(1)));
+    EXPECT_EQ(find_index_of_valarray_max(A.GetColumn(1), 0, 3), 2);
+    EXPECT_EQ(find_index_of_valarray_max(A.Column(2), 1, 3), 1);
+}
@@ -0,0 +1,63 @@
+#include "matrix.h"
+#include "utils.h"
+#include <gtest/gtest.h>
+
+TEST(Views, RowAndColumnWriteThrough)
+{
+    matrix<double> mat{3, 3, {1.0, 2.0, 3.0,
+                              4.0, 5.0, 6.0,
+                              7.0, 8.0, 9.0}};
+
+    auto row = mat.Row(1, 1);
+    ASSERT_EQ(row.GetSize(), 2);
+    EXPECT_EQ(row[0], 5.0);
+    row /= 5.0;
+    EXPECT_EQ(mat.GetElement(1, 1), 1.0);
+    EXPECT_EQ(mat.GetElement(2, 1), 6.0 / 5.0);
+
+    auto column = mat.Column(2);
+    ASSERT_EQ(column.GetSize(), 3);
+    column.AddScaled(2.0, mat.Column(0));
+    EXPECT_EQ(mat.GetElement(2, 0), 5.0);
+    EXPECT_EQ(mat.GetElement(2, 2), 23.0);
+
+    EXPECT_EQ(dot(mat.Row(0), mat.Column(0)), 1.0 + 2.0 * 4.0 + 5.0 * 7.0);
+}
+
+TEST(Views, AddScaledOverlapping)
+{
+    // each element adds its predecessor after that one was updated, as the loop reads
+    std::valarray<double> storage{1.0, 1.0, 1.0, 1.0, 1.0};
+    const vector_view<double> v(&storage[0], 5);
+    v.Subview(1, 4) += v.Subview(0, 4);
+    for(size_t i = 0; i < 5; i++)
+        EXPECT_EQ(storage[i], double(i + 1));
+
+    std::valarray<double> backwards{1.0, 2.0, 3.0, 4.0, 5.0};
+    const vector_view<double> w(&backwards[0], 5);
+    w.Subview(0, 4).AddScaled(2.0, w.Subview(1, 4));
+    EXPECT_EQ(backwards[0], 5.0);
+    EXPECT_EQ(backwards[3], 14.0);
+    EXPECT_EQ(backwards[4], 5.0);
+}
+
+TEST(Views, BlockAndSwap)
+{
+    matrix<int> mat{3, 3, {1, 2, 3,
+                           4, 5, 6,
+                           7, 8, 9}};
+
+    auto block = mat.Block(1, 1, 2, 2);
+    EXPECT_EQ(block.GetElement(0, 0), 5);
+    EXPECT_EQ(block.GetElement(1, 1), 9);
+    EXPECT_EQ(block.Column(1)[0], 6);
+
+    swap_slices(mat.Row(0), mat.Row(2));
+    EXPECT_EQ(mat.GetElement(0, 0), 7);
+    EXPECT_EQ(mat.GetElement(2, 2), 3);
+
+    const matrix<int>& constMat = mat;
+    std::valarray<int> copy = constMat.Column(1);
+    EXPECT_EQ(copy[0], 8);
+    EXPECT_EQ(copy[2], 2);
+}